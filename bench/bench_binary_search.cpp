@@ -0,0 +1,171 @@
+#include <benchmark/benchmark.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <cz/binary_search.hpp>
+#include <cz/defer.hpp>
+#include <cz/eytzinger_index.hpp>
+#include <cz/heap.hpp>
+#include <random>
+
+using namespace cz;
+
+enum Searcher {
+    BRANCHY,
+    BRANCHLESS,
+    EYTZINGER,
+    STD,
+};
+
+/// The `while (start + 1 < end)` loop `binary_search` used before `lower_bound`.
+static size_t branchy_lower_bound(cz::Slice<uint32_t> slice, uint32_t element) {
+    if (slice.len == 0) {
+        return 0;
+    }
+
+    size_t start = 0;
+    size_t end = slice.len;
+    while (start + 1 < end) {
+        size_t mid = (start + end) / 2;
+        if (element < slice[mid]) {
+            end = mid;
+        } else {
+            start = mid;
+        }
+    }
+
+    if (slice[start] < element) {
+        ++start;
+    }
+    return start;
+}
+
+/// Look up random elements in a sorted array of `state.range(0)` unique elements.
+static void BM_lower_bound(benchmark::State& state, Searcher searcher) {
+    size_t length = state.range(0);
+
+    uint32_t* data = (uint32_t*)malloc(sizeof(uint32_t) * length);
+    CZ_DEFER(free(data));
+    for (size_t i = 0; i < length; ++i) {
+        data[i] = (uint32_t)(i * 2);
+    }
+    cz::Slice<uint32_t> slice = {data, length};
+
+    // Half of the lookups hit and half miss.
+    const size_t num_queries = 1 << 16;
+    uint32_t* queries = (uint32_t*)malloc(sizeof(uint32_t) * num_queries);
+    CZ_DEFER(free(queries));
+    std::mt19937_64 rand(length);
+    for (size_t i = 0; i < num_queries; ++i) {
+        queries[i] = (uint32_t)(rand() % (length * 2));
+    }
+
+    Eytzinger_Index<uint32_t> index = {};
+    if (searcher == EYTZINGER) {
+        index.init(heap_allocator(), slice);
+    }
+    CZ_DEFER(if (searcher == EYTZINGER) index.drop(heap_allocator()));
+
+    size_t query = 0;
+    for (auto _ : state) {
+        uint32_t element = queries[query];
+        query = (query + 1) & (num_queries - 1);
+
+        size_t result = 0;
+        switch (searcher) {
+            case BRANCHY:
+                result = branchy_lower_bound(slice, element);
+                break;
+            case BRANCHLESS:
+                result = lower_bound(slice, element);
+                break;
+            case EYTZINGER:
+                result = index.lower_bound(element);
+                break;
+            case STD:
+                result = std::lower_bound(data, data + length, element) - data;
+                break;
+        }
+        benchmark::DoNotOptimize(result);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_CAPTURE(BM_lower_bound, branchy, BRANCHY)->RangeMultiplier(32)->Range(1 << 10, 1 << 30);
+BENCHMARK_CAPTURE(BM_lower_bound, branchless, BRANCHLESS)
+    ->RangeMultiplier(32)
+    ->Range(1 << 10, 1 << 30);
+BENCHMARK_CAPTURE(BM_lower_bound, eytzinger, EYTZINGER)
+    ->RangeMultiplier(32)
+    ->Range(1 << 10, 1 << 30);
+BENCHMARK_CAPTURE(BM_lower_bound, std, STD)->RangeMultiplier(32)->Range(1 << 10, 1 << 30);
+
+enum Batch_Searcher {
+    LOOP,
+    MANY,
+};
+
+/// Look up 4096 random elements at once in a sorted array of `state.range(0)` unique elements.
+static void BM_lower_bound_batch(benchmark::State& state, Batch_Searcher searcher, bool sorted) {
+    size_t length = state.range(0);
+
+    uint32_t* data = (uint32_t*)malloc(sizeof(uint32_t) * length);
+    CZ_DEFER(free(data));
+    for (size_t i = 0; i < length; ++i) {
+        data[i] = (uint32_t)(i * 2);
+    }
+    cz::Slice<uint32_t> slice = {data, length};
+
+    const size_t num_queries = 4096;
+    uint32_t* queries = (uint32_t*)malloc(sizeof(uint32_t) * num_queries);
+    CZ_DEFER(free(queries));
+    size_t* indices = (size_t*)malloc(sizeof(size_t) * num_queries);
+    CZ_DEFER(free(indices));
+    std::mt19937_64 rand(length);
+    for (size_t i = 0; i < num_queries; ++i) {
+        queries[i] = (uint32_t)(rand() % (length * 2));
+    }
+    if (sorted) {
+        std::sort(queries, queries + num_queries);
+    }
+
+    for (auto _ : state) {
+        switch (searcher) {
+            case LOOP:
+                for (size_t i = 0; i < num_queries; ++i) {
+                    indices[i] = lower_bound(slice, queries[i]);
+                }
+                break;
+            case MANY:
+                lower_bound_many(slice, cz::Slice<uint32_t>{queries, num_queries}, indices);
+                break;
+        }
+        benchmark::DoNotOptimize(indices);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * num_queries);
+}
+
+static void BM_lower_bound_random_queries(benchmark::State& state, Batch_Searcher searcher) {
+    BM_lower_bound_batch(state, searcher, false);
+}
+
+static void BM_lower_bound_sorted_queries(benchmark::State& state, Batch_Searcher searcher) {
+    BM_lower_bound_batch(state, searcher, true);
+}
+
+BENCHMARK_CAPTURE(BM_lower_bound_random_queries, loop, LOOP)
+    ->RangeMultiplier(32)
+    ->Range(1 << 10, 1 << 30);
+BENCHMARK_CAPTURE(BM_lower_bound_random_queries, many, MANY)
+    ->RangeMultiplier(32)
+    ->Range(1 << 10, 1 << 30);
+BENCHMARK_CAPTURE(BM_lower_bound_sorted_queries, loop, LOOP)
+    ->RangeMultiplier(32)
+    ->Range(1 << 10, 1 << 30);
+BENCHMARK_CAPTURE(BM_lower_bound_sorted_queries, many, MANY)
+    ->RangeMultiplier(32)
+    ->Range(1 << 10, 1 << 30);
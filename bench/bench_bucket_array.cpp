@@ -0,0 +1,124 @@
+#include <benchmark/benchmark.h>
+
+#include <stdint.h>
+#include <cz/bucket_array.hpp>
+#include <cz/heap.hpp>
+#include <cz/vector.hpp>
+
+using namespace cz;
+
+enum Container {
+    VECTOR,
+    BUCKET_ARRAY,
+    /// A `Vector` of pointers to elements allocated via `Allocator::create`.
+    BOXED,
+};
+
+/// Push `state.range(0)` elements.
+static void BM_insert(benchmark::State& state, Container container) {
+    size_t length = state.range(0);
+    Allocator allocator = heap_allocator();
+    for (auto _ : state) {
+        switch (container) {
+            case VECTOR: {
+                Vector<uint64_t> vector = {};
+                for (size_t i = 0; i < length; ++i) {
+                    vector.reserve(allocator, 1);
+                    vector.push(i);
+                }
+                benchmark::DoNotOptimize(vector.elems);
+                vector.drop(allocator);
+            } break;
+
+            case BUCKET_ARRAY: {
+                Bucket_Array<uint64_t> array = {};
+                for (size_t i = 0; i < length; ++i) {
+                    array.reserve(allocator, 1);
+                    array.push(i);
+                }
+                benchmark::DoNotOptimize(array.buckets.elems);
+                array.drop(allocator);
+            } break;
+
+            case BOXED: {
+                Vector<uint64_t*> vector = {};
+                for (size_t i = 0; i < length; ++i) {
+                    uint64_t* elem = allocator.alloc<uint64_t>();
+                    *elem = i;
+                    vector.reserve(allocator, 1);
+                    vector.push(elem);
+                }
+                benchmark::DoNotOptimize(vector.elems);
+                for (size_t i = 0; i < vector.len; ++i) {
+                    allocator.dealloc(vector[i]);
+                }
+                vector.drop(allocator);
+            } break;
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * length);
+}
+
+/// Sum `state.range(0)` elements.
+static void BM_iterate(benchmark::State& state, Container container) {
+    size_t length = state.range(0);
+    Allocator allocator = heap_allocator();
+
+    Vector<uint64_t> vector = {};
+    Bucket_Array<uint64_t> array = {};
+    Vector<uint64_t*> boxed = {};
+    vector.reserve(allocator, length);
+    array.reserve(allocator, length);
+    boxed.reserve(allocator, length);
+    for (size_t i = 0; i < length; ++i) {
+        vector.push(i);
+        array.push(i);
+        uint64_t* elem = allocator.alloc<uint64_t>();
+        *elem = i;
+        boxed.push(elem);
+    }
+
+    for (auto _ : state) {
+        uint64_t sum = 0;
+        switch (container) {
+            case VECTOR:
+                for (size_t i = 0; i < vector.len; ++i) {
+                    sum += vector[i];
+                }
+                break;
+
+            case BUCKET_ARRAY:
+                array.for_each([&](uint64_t x) { sum += x; });
+                break;
+
+            case BOXED:
+                for (size_t i = 0; i < boxed.len; ++i) {
+                    sum += *boxed[i];
+                }
+                break;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+
+    for (size_t i = 0; i < boxed.len; ++i) {
+        allocator.dealloc(boxed[i]);
+    }
+    boxed.drop(allocator);
+    array.drop(allocator);
+    vector.drop(allocator);
+
+    state.SetItemsProcessed(state.iterations() * length);
+}
+
+BENCHMARK_CAPTURE(BM_insert, vector, VECTOR)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+BENCHMARK_CAPTURE(BM_insert, bucket_array, BUCKET_ARRAY)
+    ->RangeMultiplier(32)
+    ->Range(1 << 10, 1 << 20);
+BENCHMARK_CAPTURE(BM_insert, boxed, BOXED)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+
+BENCHMARK_CAPTURE(BM_iterate, vector, VECTOR)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+BENCHMARK_CAPTURE(BM_iterate, bucket_array, BUCKET_ARRAY)
+    ->RangeMultiplier(32)
+    ->Range(1 << 10, 1 << 20);
+BENCHMARK_CAPTURE(BM_iterate, boxed, BOXED)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
@@ -0,0 +1,94 @@
+#include <benchmark/benchmark.h>
+
+#include <stdint.h>
+#include <cz/buffer_array.hpp>
+#include <cz/defer.hpp>
+#include <cz/heap.hpp>
+#include <cz/string.hpp>
+#include <cz/vector.hpp>
+#include <random>
+
+using namespace cz;
+
+/// Mimics `cz::files`: allocate many short null terminated
+/// file names in the `Buffer_Array` then throw them all away.
+static void BM_buffer_array_files(benchmark::State& state) {
+    size_t buffer_size = state.range(0);
+    size_t max_buffer_size = state.range(1);
+    const size_t count = 4096;
+
+    std::mt19937 rand(0);
+    std::uniform_int_distribution<size_t> len_dist(4, 64);
+    size_t lens[count];
+    for (size_t i = 0; i < count; ++i) {
+        lens[i] = len_dist(rand);
+    }
+
+    Buffer_Array buffer_array;
+    buffer_array.init(buffer_size, max_buffer_size);
+    CZ_DEFER(buffer_array.drop());
+
+    Vector<Str> files = {};
+    CZ_DEFER(files.drop(heap_allocator()));
+    files.reserve_exact(heap_allocator(), count);
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < count; ++i) {
+            char* file = buffer_array.allocator().alloc<char>(lens[i] + 1);
+            memset(file, 'a', lens[i]);
+            file[lens[i]] = '\0';
+            files.push({file, lens[i]});
+        }
+        benchmark::DoNotOptimize(files.elems);
+
+        files.len = 0;
+        buffer_array.clear();
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK(BM_buffer_array_files)
+    ->Args({0x1000, 0})
+    ->Args({0x10000, 0})
+    ->Args({0x1000, 0x100000});
+
+/// Mimics `dwim::read_file`: grow a `String` in the `Buffer_Array` in
+/// 1 KiB chunks (the size of `Dwim::temp_buffer`) then shrink it to fit.
+static void BM_buffer_array_read_file(benchmark::State& state) {
+    size_t file_size = state.range(0);
+    size_t buffer_size = state.range(1);
+    size_t max_buffer_size = state.range(2);
+
+    char chunk[1024];
+    memset(chunk, 'a', sizeof(chunk));
+
+    Buffer_Array buffer_array;
+    buffer_array.init(buffer_size, max_buffer_size);
+    CZ_DEFER(buffer_array.drop());
+
+    for (auto _ : state) {
+        // Simulate reading a few files per iteration.
+        for (int file = 0; file < 4; ++file) {
+            String output = {};
+            for (size_t read = 0; read < file_size; read += sizeof(chunk)) {
+                output.reserve(buffer_array.allocator(), sizeof(chunk));
+                output.append({chunk, sizeof(chunk)});
+            }
+            output.realloc(buffer_array.allocator());
+            benchmark::DoNotOptimize(output.buffer);
+        }
+
+        buffer_array.clear();
+    }
+
+    state.SetBytesProcessed(state.iterations() * 4 * file_size);
+}
+
+BENCHMARK(BM_buffer_array_read_file)
+    ->Args({3 << 10, 0x1000, 0})
+    ->Args({3 << 10, 0x10000, 0})
+    ->Args({3 << 10, 0x1000, 0x100000})
+    ->Args({256 << 10, 0x1000, 0})
+    ->Args({256 << 10, 0x10000, 0})
+    ->Args({256 << 10, 0x1000, 0x100000});
@@ -0,0 +1,104 @@
+#include <benchmark/benchmark.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <cz/concurrent_str_map.hpp>
+#include <cz/defer.hpp>
+#include <cz/heap.hpp>
+#include <cz/rwlock.hpp>
+#include <cz/str_map.hpp>
+#include <random>
+
+using namespace cz;
+
+static const size_t num_keys = 100000;
+
+static Str* global_keys() {
+    static Str* keys = []() {
+        const size_t max_len = 24;
+        char* buffer = heap_allocator().alloc<char>(num_keys * max_len);
+        Str* keys = heap_allocator().alloc<Str>(num_keys);
+        for (size_t i = 0; i < num_keys; ++i) {
+            int len = snprintf(buffer + i * max_len, max_len, "key_%zu", i);
+            keys[i] = {buffer + i * max_len, (size_t)len};
+        }
+        return keys;
+    }();
+    return keys;
+}
+
+/// The baseline: a single `Str_Map` protected by a `RWLock`.
+struct Locked_Str_Map {
+    RWLock lock;
+    Str_Map<size_t> map;
+
+    bool get_hash(Str key, size_t* out) {
+        lock.lock_reading();
+        CZ_DEFER(lock.unlock_reading());
+        size_t* value = map.get_hash(key);
+        if (value) {
+            *out = *value;
+        }
+        return value;
+    }
+
+    void insert_hash(Allocator allocator, Str key, size_t value) {
+        lock.lock_writing();
+        CZ_DEFER(lock.unlock_writing());
+        size_t* existing = map.get_hash(key);
+        if (existing) {
+            *existing = value;
+        } else {
+            map.reserve(allocator, 1);
+            map.insert_hash(key, value);
+        }
+    }
+};
+
+template <class Map>
+static Map* make_map();
+
+template <>
+Locked_Str_Map* make_map() {
+    Locked_Str_Map* map = heap_allocator().alloc<Locked_Str_Map>();
+    map->lock.init();
+    map->map = {};
+    for (size_t i = 0; i < num_keys; ++i) {
+        map->insert_hash(heap_allocator(), global_keys()[i], i);
+    }
+    return map;
+}
+
+template <>
+Concurrent_Str_Map<size_t>* make_map() {
+    Concurrent_Str_Map<size_t>* map = heap_allocator().alloc<Concurrent_Str_Map<size_t> >();
+    map->init(heap_allocator());
+    for (size_t i = 0; i < num_keys; ++i) {
+        map->insert_hash(heap_allocator(), global_keys()[i], i);
+    }
+    return map;
+}
+
+/// 99% of operations are lookups and 1% overwrite an existing key.
+template <class Map>
+static void BM_read_mostly(benchmark::State& state) {
+    // The maps are deliberately leaked since threads can't easily share teardown.
+    static Map* map = make_map<Map>();
+    Str* keys = global_keys();
+
+    std::mt19937 rand(state.thread_index());
+    for (auto _ : state) {
+        size_t i = rand() % num_keys;
+        if (rand() % 100 == 0) {
+            map->insert_hash(heap_allocator(), keys[i], i);
+        } else {
+            size_t value;
+            benchmark::DoNotOptimize(map->get_hash(keys[i], &value));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_TEMPLATE(BM_read_mostly, Locked_Str_Map)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_read_mostly, Concurrent_Str_Map<size_t>)->ThreadRange(1, 64)->UseRealTime();
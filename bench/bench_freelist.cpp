@@ -0,0 +1,56 @@
+#include <benchmark/benchmark.h>
+
+#include <stdint.h>
+#include <atomic>
+#include <cz/freelist_allocator.hpp>
+#include <cz/heap.hpp>
+
+using namespace cz;
+
+static const size_t message_size = 64;
+
+static Allocator global_concurrent_freelist() {
+    static Concurrent_Freelist freelist;
+    static bool initialized = (freelist.init(heap_allocator(), message_size), true);
+    (void)initialized;
+    return freelist.allocator();
+}
+
+/// Every thread allocates a message, passes it to a shared slot, and
+/// frees whatever message was previously in the slot.  Thus most
+/// messages are freed on a different thread than they were allocated on.
+static void message_passing(benchmark::State& state, Allocator allocator) {
+    static std::atomic<void*> slots[16];
+    std::atomic<void*>* slot = &slots[state.thread_index() % 16];
+
+    for (auto _ : state) {
+        void* message = allocator.alloc({message_size, 1});
+        benchmark::DoNotOptimize(message);
+        void* old = slot->exchange(message);
+        if (old) {
+            allocator.dealloc({old, message_size});
+        }
+    }
+
+    if (state.thread_index() == 0) {
+        for (size_t i = 0; i < 16; ++i) {
+            void* old = slots[i].exchange(nullptr);
+            if (old) {
+                allocator.dealloc({old, message_size});
+            }
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_heap_allocator_messages(benchmark::State& state) {
+    message_passing(state, heap_allocator());
+}
+
+static void BM_concurrent_freelist_messages(benchmark::State& state) {
+    message_passing(state, global_concurrent_freelist());
+}
+
+BENCHMARK(BM_heap_allocator_messages)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(BM_concurrent_freelist_messages)->ThreadRange(1, 64)->UseRealTime();
@@ -0,0 +1,162 @@
+#include <benchmark/benchmark.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <algorithm>
+#include <cz/defer.hpp>
+#include <cz/hash.hpp>
+#include <cz/heap.hpp>
+#include <cz/str_map.hpp>
+#include <cz/vector.hpp>
+#include <random>
+
+using namespace cz;
+
+template <class Hasher>
+static void BM_hash_throughput(benchmark::State& state) {
+    size_t len = state.range(0);
+    char* buffer = (char*)malloc(len);
+    CZ_DEFER(free(buffer));
+    std::mt19937 rand(len);
+    for (size_t i = 0; i < len; ++i) {
+        buffer[i] = (char)rand();
+    }
+
+    Str str = {buffer, len};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(str);
+        benchmark::DoNotOptimize(Hasher()(str));
+    }
+
+    state.SetBytesProcessed(state.iterations() * len);
+}
+
+BENCHMARK_TEMPLATE(BM_hash_throughput, Str_Hasher)->RangeMultiplier(4)->Range(4, 4096);
+BENCHMARK_TEMPLATE(BM_hash_throughput, Str_Hasher_Multiply_31)
+    ->RangeMultiplier(4)
+    ->Range(4, 4096);
+
+///////////////////////////////////////////////////////////////////////////////
+// Key distributions
+///////////////////////////////////////////////////////////////////////////////
+
+enum Distribution {
+    /// Decimal numbers: "0", "1", ...
+    NUMBERS,
+    /// Identifiers sharing a long prefix: "local_variable_0", ...
+    IDENTIFIERS,
+    /// File paths spread over 97 directories: "src/module_0/file_0.cpp", ...
+    PATHS,
+};
+
+struct Key_Set {
+    Vector<char> buffer;
+    Vector<Str> keys;
+
+    void init(Distribution distribution, size_t count) {
+        const size_t max_len = 64;
+        buffer = {};
+        keys = {};
+        buffer.reserve_exact(heap_allocator(), count * max_len);
+        keys.reserve_exact(heap_allocator(), count);
+        for (size_t i = 0; i < count; ++i) {
+            char* start = buffer.elems + buffer.len;
+            int len = 0;
+            switch (distribution) {
+                case NUMBERS:
+                    len = snprintf(start, max_len, "%zu", i);
+                    break;
+                case IDENTIFIERS:
+                    len = snprintf(start, max_len, "local_variable_%zu", i);
+                    break;
+                case PATHS:
+                    len = snprintf(start, max_len, "src/module_%zu/file_%zu.cpp", i % 97, i);
+                    break;
+            }
+            buffer.len += len;
+            keys.push({start, (size_t)len});
+        }
+    }
+
+    void drop() {
+        buffer.drop(heap_allocator());
+        keys.drop(heap_allocator());
+    }
+};
+
+/// Insert the keys into a `Str_Map` and report hash collisions and probe lengths.
+template <class Hasher>
+static void BM_hash_distribution(benchmark::State& state, Distribution distribution) {
+    Key_Set set;
+    set.init(distribution, state.range(0));
+    CZ_DEFER(set.drop());
+
+    Str_Map<size_t, Hasher> map = {};
+    CZ_DEFER(map.drop(heap_allocator()));
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        map.drop(heap_allocator());
+        map = {};
+        map.reserve(heap_allocator(), set.keys.len);
+        state.ResumeTiming();
+
+        for (size_t i = 0; i < set.keys.len; ++i) {
+            map.insert_hash(set.keys[i], i);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * set.keys.len);
+
+    // Probe length is the distance from the slot the hash maps to.
+    size_t total_probe = 0;
+    size_t max_probe = 0;
+    for (size_t i = 0; i < map.cap; ++i) {
+        if (map.is_present(i)) {
+            size_t home = map.hash(map.keys[i]) & (map.cap - 1);
+            size_t probe = (i - home) & (map.cap - 1);
+            total_probe += probe;
+            max_probe = std::max(max_probe, probe);
+        }
+    }
+
+    // Count full 64 bit hash collisions.
+    Vector<Hash> hashes = {};
+    CZ_DEFER(hashes.drop(heap_allocator()));
+    hashes.reserve_exact(heap_allocator(), set.keys.len);
+    for (size_t i = 0; i < set.keys.len; ++i) {
+        hashes.push(Hasher()(set.keys[i]));
+    }
+    std::sort(hashes.elems, hashes.elems + hashes.len);
+    size_t unique = std::unique(hashes.elems, hashes.elems + hashes.len) - hashes.elems;
+
+    state.counters["avg_probe"] = (double)total_probe / set.keys.len;
+    state.counters["max_probe"] = (double)max_probe;
+    state.counters["collisions"] = (double)(set.keys.len - unique);
+}
+
+static void BM_str_hasher_distribution(benchmark::State& state, Distribution distribution) {
+    BM_hash_distribution<Str_Hasher>(state, distribution);
+}
+
+static void BM_multiply_31_distribution(benchmark::State& state, Distribution distribution) {
+    BM_hash_distribution<Str_Hasher_Multiply_31>(state, distribution);
+}
+
+BENCHMARK_CAPTURE(BM_str_hasher_distribution, numbers, NUMBERS)
+    ->RangeMultiplier(10)
+    ->Range(1000, 1000000);
+BENCHMARK_CAPTURE(BM_str_hasher_distribution, identifiers, IDENTIFIERS)
+    ->RangeMultiplier(10)
+    ->Range(1000, 1000000);
+BENCHMARK_CAPTURE(BM_str_hasher_distribution, paths, PATHS)
+    ->RangeMultiplier(10)
+    ->Range(1000, 1000000);
+BENCHMARK_CAPTURE(BM_multiply_31_distribution, numbers, NUMBERS)
+    ->RangeMultiplier(10)
+    ->Range(1000, 1000000);
+BENCHMARK_CAPTURE(BM_multiply_31_distribution, identifiers, IDENTIFIERS)
+    ->RangeMultiplier(10)
+    ->Range(1000, 1000000);
+BENCHMARK_CAPTURE(BM_multiply_31_distribution, paths, PATHS)
+    ->RangeMultiplier(10)
+    ->Range(1000, 1000000);
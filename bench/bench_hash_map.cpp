@@ -0,0 +1,167 @@
+#include <benchmark/benchmark.h>
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <algorithm>
+#include <cz/defer.hpp>
+#include <cz/hash_map.hpp>
+#include <cz/heap.hpp>
+#include <cz/str_map.hpp>
+#include <cz/vector.hpp>
+#include <random>
+#include <unordered_map>
+
+using namespace cz;
+
+/// Generate `count` distinct keys to insert and the same number of keys
+/// that are not inserted.  Present keys are even and missing keys are odd.
+static void make_integer_keys(size_t count, Vector<uint64_t>* present, Vector<uint64_t>* missing) {
+    std::mt19937_64 rand(count);
+    present->reserve_exact(heap_allocator(), count);
+    missing->reserve_exact(heap_allocator(), count);
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t key = rand();
+        present->push(key & ~(uint64_t)1);
+        missing->push(key | 1);
+    }
+    // Random keys are very unlikely to collide but make sure.
+    std::sort(present->elems, present->elems + present->len);
+    present->len = std::unique(present->elems, present->elems + present->len) - present->elems;
+    std::shuffle(present->elems, present->elems + present->len, rand);
+}
+
+/// Format integer keys as strings.  All strings are stored in `buffer`
+/// which must already have space for `integers.len * 21` characters.
+static void make_string_keys(Slice<uint64_t> integers, Vector<char>* buffer, Vector<Str>* keys) {
+    CZ_ASSERT(buffer->cap - buffer->len >= integers.len * 21);
+    keys->reserve_exact(heap_allocator(), integers.len);
+    for (size_t i = 0; i < integers.len; ++i) {
+        char* start = buffer->elems + buffer->len;
+        int len = snprintf(start, 21, "%" PRIu64, integers[i]);
+        buffer->len += len;
+        keys->push({start, (size_t)len});
+    }
+}
+
+template <class Map, class Key>
+static void lookup_loop(benchmark::State& state, Map& map, Slice<Key> keys) {
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(map.get(keys[i]));
+        if (++i == keys.len) {
+            i = 0;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_hash_map_lookup(benchmark::State& state, bool hit) {
+    Vector<uint64_t> present = {}, missing = {};
+    CZ_DEFER(present.drop(heap_allocator()));
+    CZ_DEFER(missing.drop(heap_allocator()));
+    make_integer_keys(state.range(0), &present, &missing);
+
+    Hash_Map<uint64_t, uint64_t> map = {};
+    CZ_DEFER(map.drop(heap_allocator()));
+    map.reserve(heap_allocator(), present.len);
+    for (size_t i = 0; i < present.len; ++i) {
+        map.insert(present[i], i);
+    }
+
+    lookup_loop(state, map, hit ? present.as_slice() : missing.as_slice());
+}
+
+static void BM_unordered_map_lookup(benchmark::State& state, bool hit) {
+    Vector<uint64_t> present = {}, missing = {};
+    CZ_DEFER(present.drop(heap_allocator()));
+    CZ_DEFER(missing.drop(heap_allocator()));
+    make_integer_keys(state.range(0), &present, &missing);
+
+    std::unordered_map<uint64_t, uint64_t> map;
+    map.reserve(present.len);
+    for (size_t i = 0; i < present.len; ++i) {
+        map.emplace(present[i], i);
+    }
+
+    Slice<uint64_t> keys = hit ? present.as_slice() : missing.as_slice();
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(map.find(keys[i]));
+        if (++i == keys.len) {
+            i = 0;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_hash_map_str_lookup(benchmark::State& state, bool hit) {
+    Vector<uint64_t> present = {}, missing = {};
+    CZ_DEFER(present.drop(heap_allocator()));
+    CZ_DEFER(missing.drop(heap_allocator()));
+    make_integer_keys(state.range(0), &present, &missing);
+
+    Vector<char> buffer = {};
+    Vector<Str> present_strs = {}, missing_strs = {};
+    CZ_DEFER(buffer.drop(heap_allocator()));
+    CZ_DEFER(present_strs.drop(heap_allocator()));
+    CZ_DEFER(missing_strs.drop(heap_allocator()));
+    buffer.reserve_exact(heap_allocator(), (present.len + missing.len) * 21);
+    make_string_keys(present.as_slice(), &buffer, &present_strs);
+    make_string_keys(missing.as_slice(), &buffer, &missing_strs);
+
+    Hash_Map<Str, uint64_t> map = {};
+    CZ_DEFER(map.drop(heap_allocator()));
+    map.reserve(heap_allocator(), present_strs.len);
+    for (size_t i = 0; i < present_strs.len; ++i) {
+        map.insert(present_strs[i], i);
+    }
+
+    lookup_loop(state, map, hit ? present_strs.as_slice() : missing_strs.as_slice());
+}
+
+static void BM_str_map_lookup(benchmark::State& state, bool hit) {
+    Vector<uint64_t> present = {}, missing = {};
+    CZ_DEFER(present.drop(heap_allocator()));
+    CZ_DEFER(missing.drop(heap_allocator()));
+    make_integer_keys(state.range(0), &present, &missing);
+
+    Vector<char> buffer = {};
+    Vector<Str> present_strs = {}, missing_strs = {};
+    CZ_DEFER(buffer.drop(heap_allocator()));
+    CZ_DEFER(present_strs.drop(heap_allocator()));
+    CZ_DEFER(missing_strs.drop(heap_allocator()));
+    buffer.reserve_exact(heap_allocator(), (present.len + missing.len) * 21);
+    make_string_keys(present.as_slice(), &buffer, &present_strs);
+    make_string_keys(missing.as_slice(), &buffer, &missing_strs);
+
+    Str_Map<uint64_t> map = {};
+    CZ_DEFER(map.drop(heap_allocator()));
+    map.reserve(heap_allocator(), present_strs.len);
+    for (size_t i = 0; i < present_strs.len; ++i) {
+        map.insert_hash(present_strs[i], i);
+    }
+
+    Slice<Str> keys = hit ? present_strs.as_slice() : missing_strs.as_slice();
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(map.get_hash(keys[i]));
+        if (++i == keys.len) {
+            i = 0;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_CAPTURE(BM_hash_map_lookup, hit, true)->RangeMultiplier(10)->Range(1000, 100000000);
+BENCHMARK_CAPTURE(BM_hash_map_lookup, miss, false)->RangeMultiplier(10)->Range(1000, 100000000);
+BENCHMARK_CAPTURE(BM_unordered_map_lookup, hit, true)->RangeMultiplier(10)->Range(1000, 100000000);
+BENCHMARK_CAPTURE(BM_unordered_map_lookup, miss, false)
+    ->RangeMultiplier(10)
+    ->Range(1000, 100000000);
+
+// String keys take a lot more memory so stop at 10M.
+BENCHMARK_CAPTURE(BM_hash_map_str_lookup, hit, true)->RangeMultiplier(10)->Range(1000, 10000000);
+BENCHMARK_CAPTURE(BM_hash_map_str_lookup, miss, false)->RangeMultiplier(10)->Range(1000, 10000000);
+BENCHMARK_CAPTURE(BM_str_map_lookup, hit, true)->RangeMultiplier(10)->Range(1000, 10000000);
+BENCHMARK_CAPTURE(BM_str_map_lookup, miss, false)->RangeMultiplier(10)->Range(1000, 10000000);
@@ -0,0 +1,134 @@
+#include <benchmark/benchmark.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <cz/defer.hpp>
+#include <cz/heap.hpp>
+#include <cz/intern_table.hpp>
+#include <cz/vector.hpp>
+#include <random>
+
+using namespace cz;
+
+/// A stream of `count` identifiers drawn from `distinct` different strings.
+struct Identifier_Stream {
+    Vector<char> buffer;
+    Vector<Str> distinct;
+    Vector<Str> stream;
+
+    void init(size_t num_distinct, size_t count) {
+        const size_t max_len = 48;
+        buffer = {};
+        distinct = {};
+        stream = {};
+        buffer.reserve_exact(heap_allocator(), num_distinct * max_len);
+        distinct.reserve_exact(heap_allocator(), num_distinct);
+        for (size_t i = 0; i < num_distinct; ++i) {
+            char* start = buffer.elems + buffer.len;
+            int len = snprintf(start, max_len, "some_long_identifier_name_%zu", i);
+            buffer.len += len;
+            distinct.push({start, (size_t)len});
+        }
+
+        std::mt19937 rand(count);
+        stream.reserve_exact(heap_allocator(), count);
+        for (size_t i = 0; i < count; ++i) {
+            stream.push(distinct[rand() % num_distinct]);
+        }
+    }
+
+    void drop() {
+        buffer.drop(heap_allocator());
+        distinct.drop(heap_allocator());
+        stream.drop(heap_allocator());
+    }
+};
+
+static void BM_intern_table_intern(benchmark::State& state) {
+    Identifier_Stream identifiers;
+    identifiers.init(state.range(0), 100000);
+    CZ_DEFER(identifiers.drop());
+
+    for (auto _ : state) {
+        Intern_Table table;
+        table.init();
+        for (size_t i = 0; i < identifiers.stream.len; ++i) {
+            benchmark::DoNotOptimize(table.intern(identifiers.stream[i]));
+        }
+        table.drop();
+    }
+    state.SetItemsProcessed(state.iterations() * identifiers.stream.len);
+}
+
+BENCHMARK(BM_intern_table_intern)->RangeMultiplier(10)->Range(10, 100000);
+
+/// Count how many identifiers equal the first one by comparing strings.
+static void BM_compare_strs(benchmark::State& state) {
+    Identifier_Stream identifiers;
+    identifiers.init(state.range(0), 100000);
+    CZ_DEFER(identifiers.drop());
+
+    for (auto _ : state) {
+        Str target = identifiers.stream[0];
+        size_t matches = 0;
+        for (size_t i = 0; i < identifiers.stream.len; ++i) {
+            matches += identifiers.stream[i] == target;
+        }
+        benchmark::DoNotOptimize(matches);
+    }
+    state.SetItemsProcessed(state.iterations() * identifiers.stream.len);
+}
+
+/// Count how many identifiers equal the first one by comparing interned ids.
+static void BM_compare_ids(benchmark::State& state) {
+    Identifier_Stream identifiers;
+    identifiers.init(state.range(0), 100000);
+    CZ_DEFER(identifiers.drop());
+
+    Intern_Table table;
+    table.init();
+    CZ_DEFER(table.drop());
+    Vector<uint32_t> ids = {};
+    CZ_DEFER(ids.drop(heap_allocator()));
+    ids.reserve_exact(heap_allocator(), identifiers.stream.len);
+    for (size_t i = 0; i < identifiers.stream.len; ++i) {
+        ids.push(table.intern(identifiers.stream[i]));
+    }
+
+    for (auto _ : state) {
+        uint32_t target = ids[0];
+        size_t matches = 0;
+        for (size_t i = 0; i < ids.len; ++i) {
+            matches += ids[i] == target;
+        }
+        benchmark::DoNotOptimize(matches);
+    }
+    state.SetItemsProcessed(state.iterations() * ids.len);
+}
+
+BENCHMARK(BM_compare_strs)->RangeMultiplier(10)->Range(10, 100000);
+BENCHMARK(BM_compare_ids)->RangeMultiplier(10)->Range(10, 100000);
+
+/// Many threads intern a stream of mostly already interned identifiers.
+static void BM_concurrent_intern_table_intern(benchmark::State& state) {
+    static Concurrent_Intern_Table* table = []() {
+        Concurrent_Intern_Table* table = heap_allocator().alloc<Concurrent_Intern_Table>();
+        table->init();
+        return table;
+    }();
+
+    Identifier_Stream identifiers;
+    identifiers.init(10000, 100000);
+    CZ_DEFER(identifiers.drop());
+
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(table->intern(identifiers.stream[i]));
+        if (++i == identifiers.stream.len) {
+            i = 0;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_concurrent_intern_table_intern)->ThreadRange(1, 64)->UseRealTime();
@@ -0,0 +1,117 @@
+#include <benchmark/benchmark.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <cz/defer.hpp>
+#include <cz/heap.hpp>
+#include <cz/radix_sort.hpp>
+#include <cz/sort.hpp>
+#include <cz/vector.hpp>
+#include <random>
+
+using namespace cz;
+
+enum Sorter {
+    RADIX,
+    CZ,
+    STD,
+};
+
+template <class T>
+static void BM_sort_integers(benchmark::State& state, Sorter sorter) {
+    size_t length = state.range(0);
+
+    std::mt19937_64 rand(length);
+
+    T* data = (T*)malloc(sizeof(T) * length);
+    CZ_DEFER(free(data));
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        for (size_t i = 0; i < length; ++i) {
+            data[i] = (T)rand();
+        }
+        state.ResumeTiming();
+
+        switch (sorter) {
+            case RADIX:
+                radix_sort(heap_allocator(), cz::slice(data, length));
+                break;
+            case CZ:
+                cz::sort(cz::slice(data, length));
+                break;
+            case STD:
+                std::sort(data, data + length);
+                break;
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * length);
+}
+
+static void BM_sort_uint32(benchmark::State& state, Sorter sorter) {
+    BM_sort_integers<uint32_t>(state, sorter);
+}
+
+static void BM_sort_uint64(benchmark::State& state, Sorter sorter) {
+    BM_sort_integers<uint64_t>(state, sorter);
+}
+
+BENCHMARK_CAPTURE(BM_sort_uint32, radix, RADIX)->RangeMultiplier(16)->Range(256, 1 << 24);
+BENCHMARK_CAPTURE(BM_sort_uint32, cz, CZ)->RangeMultiplier(16)->Range(256, 1 << 24);
+BENCHMARK_CAPTURE(BM_sort_uint32, std, STD)->RangeMultiplier(16)->Range(256, 1 << 24);
+BENCHMARK_CAPTURE(BM_sort_uint64, radix, RADIX)->RangeMultiplier(16)->Range(256, 1 << 24);
+BENCHMARK_CAPTURE(BM_sort_uint64, cz, CZ)->RangeMultiplier(16)->Range(256, 1 << 24);
+BENCHMARK_CAPTURE(BM_sort_uint64, std, STD)->RangeMultiplier(16)->Range(256, 1 << 24);
+
+/// Sort random identifiers like "item_%zu" where many strings share a prefix.
+static void BM_sort_strings(benchmark::State& state, Sorter sorter) {
+    size_t length = state.range(0);
+
+    std::mt19937_64 rand(length);
+
+    const size_t max_len = 32;
+    Vector<char> buffer = {};
+    CZ_DEFER(buffer.drop(heap_allocator()));
+    buffer.reserve_exact(heap_allocator(), length * max_len);
+    Vector<Str> strings = {};
+    CZ_DEFER(strings.drop(heap_allocator()));
+    strings.reserve_exact(heap_allocator(), length);
+    for (size_t i = 0; i < length; ++i) {
+        char* start = buffer.elems + buffer.len;
+        int len = snprintf(start, max_len, "item_%zu", (size_t)(rand() % (length * 4)));
+        buffer.len += len;
+        strings.push({start, (size_t)len});
+    }
+
+    Vector<Str> data = {};
+    CZ_DEFER(data.drop(heap_allocator()));
+    data.reserve_exact(heap_allocator(), length);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        data.len = 0;
+        data.append(strings);
+        state.ResumeTiming();
+
+        switch (sorter) {
+            case RADIX:
+                radix_sort(heap_allocator(), data.as_slice());
+                break;
+            case CZ:
+                cz::sort(data.as_slice());
+                break;
+            case STD:
+                std::sort(data.elems, data.elems + data.len);
+                break;
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * length);
+}
+
+BENCHMARK_CAPTURE(BM_sort_strings, radix, RADIX)->RangeMultiplier(16)->Range(256, 1 << 20);
+BENCHMARK_CAPTURE(BM_sort_strings, cz, CZ)->RangeMultiplier(16)->Range(256, 1 << 20);
+BENCHMARK_CAPTURE(BM_sort_strings, std, STD)->RangeMultiplier(16)->Range(256, 1 << 20);
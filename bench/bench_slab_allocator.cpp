@@ -0,0 +1,78 @@
+#include <benchmark/benchmark.h>
+
+#include <stdint.h>
+#include <cz/heap.hpp>
+#include <cz/slab_allocator.hpp>
+#include <random>
+
+using namespace cz;
+
+static Allocator global_slab_allocator() {
+    static Slab_Allocator slab;
+    static bool initialized = (slab.init(), true);
+    (void)initialized;
+    return slab.allocator();
+}
+
+/// Allocate and free many small objects of random sizes in a random order.
+static void small_object_churn(benchmark::State& state, Allocator allocator) {
+    const size_t count = 256;
+    void* ptrs[count] = {};
+    size_t sizes[count] = {};
+
+    std::mt19937 rand(state.thread_index());
+    std::uniform_int_distribution<size_t> size_dist(1, 256);
+    std::uniform_int_distribution<size_t> index_dist(0, count - 1);
+
+    for (auto _ : state) {
+        size_t i = index_dist(rand);
+        allocator.dealloc({ptrs[i], sizes[i]});
+
+        sizes[i] = size_dist(rand);
+        ptrs[i] = allocator.alloc({sizes[i], 1});
+        benchmark::DoNotOptimize(ptrs[i]);
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        allocator.dealloc({ptrs[i], sizes[i]});
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_heap_allocator_churn(benchmark::State& state) {
+    small_object_churn(state, heap_allocator());
+}
+
+static void BM_slab_allocator_churn(benchmark::State& state) {
+    small_object_churn(state, global_slab_allocator());
+}
+
+BENCHMARK(BM_heap_allocator_churn)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(BM_slab_allocator_churn)->ThreadRange(1, 64)->UseRealTime();
+
+/// Repeatedly allocate and free a single object of a fixed size.
+template <size_t Size>
+static void fixed_size_churn(benchmark::State& state, Allocator allocator) {
+    for (auto _ : state) {
+        void* ptr = allocator.alloc({Size, 1});
+        benchmark::DoNotOptimize(ptr);
+        allocator.dealloc({ptr, Size});
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template <size_t Size>
+static void BM_heap_allocator_fixed(benchmark::State& state) {
+    fixed_size_churn<Size>(state, heap_allocator());
+}
+
+template <size_t Size>
+static void BM_slab_allocator_fixed(benchmark::State& state) {
+    fixed_size_churn<Size>(state, global_slab_allocator());
+}
+
+BENCHMARK_TEMPLATE(BM_heap_allocator_fixed, 16)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_slab_allocator_fixed, 16)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_heap_allocator_fixed, 256)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_slab_allocator_fixed, 256)->ThreadRange(1, 64)->UseRealTime();
@@ -0,0 +1,93 @@
+#include <benchmark/benchmark.h>
+
+#include <stdint.h>
+#include <cz/heap.hpp>
+#include <cz/small_string.hpp>
+#include <cz/small_vector.hpp>
+#include <cz/string.hpp>
+#include <cz/tracking_allocator.hpp>
+#include <cz/vector.hpp>
+#include <random>
+
+using namespace cz;
+
+/// Build an argument list of between 1 and `max_len` elements like a parser would.
+template <class Vec>
+static int64_t build_arguments(Allocator allocator, size_t len) {
+    Vec vector = {};
+    for (size_t i = 0; i < len; ++i) {
+        vector.reserve(allocator, 1);
+        vector.push((int64_t)i);
+    }
+    int64_t sum = 0;
+    for (int64_t x : vector.as_slice()) {
+        sum += x;
+    }
+    vector.drop(allocator);
+    return sum;
+}
+
+/// Build a short line out of words like a formatter would.
+template <class Str_Type>
+static size_t build_line(Allocator allocator, size_t len) {
+    Str_Type string = {};
+    for (size_t i = 0; i < len; ++i) {
+        string.reserve(allocator, 4);
+        string.append("abc ");
+    }
+    string.reserve(allocator, 1);
+    string.null_terminate();
+    size_t result = string.len;
+    string.drop(allocator);
+    return result;
+}
+
+/// Run `func` on random lengths in `[1, state.range(0)]` and report the number of
+/// allocations per call.  The allocations are counted in a separate pass so
+/// that the timed loop isn't slowed down by the `Tracking_Allocator`'s lock.
+template <class Func>
+static void run(benchmark::State& state, Func func) {
+    const size_t num_lengths = 1024;
+    size_t lengths[num_lengths];
+    std::mt19937 rand(state.range(0));
+    std::uniform_int_distribution<size_t> dist(1, state.range(0));
+    for (size_t i = 0; i < num_lengths; ++i) {
+        lengths[i] = dist(rand);
+    }
+
+    size_t index = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(func(heap_allocator(), lengths[index]));
+        index = (index + 1) & (num_lengths - 1);
+    }
+
+    Tracking_Allocator tracker;
+    tracker.init(heap_allocator());
+    for (size_t i = 0; i < num_lengths; ++i) {
+        func(tracker.allocator(), lengths[i]);
+    }
+    Allocation_Stats stats = tracker.stats();
+    tracker.drop();
+
+    state.counters["allocs_per_call"] =
+        (double)(stats.total_allocations + stats.total_reallocations) / num_lengths;
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_arguments_vector(benchmark::State& state) {
+    run(state, build_arguments<Vector<int64_t> >);
+}
+static void BM_arguments_small_vector(benchmark::State& state) {
+    run(state, build_arguments<Small_Vector<int64_t, 8> >);
+}
+static void BM_line_string(benchmark::State& state) {
+    run(state, build_line<String>);
+}
+static void BM_line_small_string(benchmark::State& state) {
+    run(state, build_line<Small_String<32> >);
+}
+
+BENCHMARK(BM_arguments_vector)->Arg(2)->Arg(8)->Arg(32);
+BENCHMARK(BM_arguments_small_vector)->Arg(2)->Arg(8)->Arg(32);
+BENCHMARK(BM_line_string)->Arg(2)->Arg(8)->Arg(32);
+BENCHMARK(BM_line_small_string)->Arg(2)->Arg(8)->Arg(32);
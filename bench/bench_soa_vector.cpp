@@ -0,0 +1,111 @@
+#include <benchmark/benchmark.h>
+
+#include <stdint.h>
+#include <cz/heap.hpp>
+#include <cz/soa_vector.hpp>
+#include <cz/vector.hpp>
+
+using namespace cz;
+
+namespace {
+struct Particle {
+    float x, y, z;
+    float vx, vy, vz;
+    uint32_t color;
+    uint32_t flags;
+};
+}
+
+enum Layout {
+    /// A `Vector<Particle>`.
+    ARRAY_OF_STRUCTS,
+    /// A `Soa_Vector` with a column for each field of `Particle`.
+    STRUCT_OF_ARRAYS,
+};
+
+typedef Soa_Vector<float, float, float, float, float, float, uint32_t, uint32_t> Particles;
+
+/// Integrate the x position of `state.range(0)` particles, touching only two fields.
+static void BM_update_field(benchmark::State& state, Layout layout) {
+    size_t length = state.range(0);
+    Allocator allocator = heap_allocator();
+
+    Vector<Particle> aos = {};
+    Particles soa = {};
+    aos.reserve(allocator, length);
+    soa.reserve(allocator, length);
+    for (size_t i = 0; i < length; ++i) {
+        float f = (float)i;
+        aos.push({f, f, f, 1, 2, 3, (uint32_t)i, 0});
+        soa.push(f, f, f, 1, 2, 3, (uint32_t)i, 0);
+    }
+
+    for (auto _ : state) {
+        switch (layout) {
+            case ARRAY_OF_STRUCTS:
+                for (size_t i = 0; i < aos.len; ++i) {
+                    aos[i].x += aos[i].vx;
+                }
+                benchmark::DoNotOptimize(aos.elems);
+                break;
+
+            case STRUCT_OF_ARRAYS: {
+                Slice<float> xs = soa.column<0>();
+                Slice<float> vxs = soa.column<3>();
+                for (size_t i = 0; i < xs.len; ++i) {
+                    xs[i] += vxs[i];
+                }
+                benchmark::DoNotOptimize(xs.elems);
+            } break;
+        }
+        benchmark::ClobberMemory();
+    }
+
+    soa.drop(allocator);
+    aos.drop(allocator);
+
+    state.SetItemsProcessed(state.iterations() * length);
+}
+
+/// Push `state.range(0)` particles.
+static void BM_push(benchmark::State& state, Layout layout) {
+    size_t length = state.range(0);
+    Allocator allocator = heap_allocator();
+    for (auto _ : state) {
+        switch (layout) {
+            case ARRAY_OF_STRUCTS: {
+                Vector<Particle> aos = {};
+                for (size_t i = 0; i < length; ++i) {
+                    float f = (float)i;
+                    aos.reserve(allocator, 1);
+                    aos.push({f, f, f, 1, 2, 3, (uint32_t)i, 0});
+                }
+                benchmark::DoNotOptimize(aos.elems);
+                aos.drop(allocator);
+            } break;
+
+            case STRUCT_OF_ARRAYS: {
+                Particles soa = {};
+                for (size_t i = 0; i < length; ++i) {
+                    float f = (float)i;
+                    soa.reserve(allocator, 1);
+                    soa.push(f, f, f, 1, 2, 3, (uint32_t)i, 0);
+                }
+                benchmark::DoNotOptimize(soa.columns[0]);
+                soa.drop(allocator);
+            } break;
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * length);
+}
+
+BENCHMARK_CAPTURE(BM_update_field, aos, ARRAY_OF_STRUCTS)
+    ->RangeMultiplier(32)
+    ->Range(1 << 10, 1 << 20);
+BENCHMARK_CAPTURE(BM_update_field, soa, STRUCT_OF_ARRAYS)
+    ->RangeMultiplier(32)
+    ->Range(1 << 10, 1 << 20);
+
+BENCHMARK_CAPTURE(BM_push, aos, ARRAY_OF_STRUCTS)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
+BENCHMARK_CAPTURE(BM_push, soa, STRUCT_OF_ARRAYS)->RangeMultiplier(32)->Range(1 << 10, 1 << 20);
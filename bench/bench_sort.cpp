@@ -8,8 +8,10 @@
 #include <chrono>
 #include <cz/defer.hpp>
 #include <cz/heap.hpp>
+#include <cz/parallel_sort.hpp>
 #include <cz/sort.hpp>
 #include <random>
+#include <thread>
 
 using namespace cz;
 
@@ -129,3 +131,289 @@ BENCHMARK_TEMPLATE(BM_std_sort, 4)->RangeMultiplier(4)->Range(32, 1 << 16);
 BENCHMARK_TEMPLATE(BM_std_sort, 16)->RangeMultiplier(4)->Range(32, 1 << 16);
 BENCHMARK_TEMPLATE(BM_std_sort, 64)->RangeMultiplier(4)->Range(32, 1 << 16);
 BENCHMARK_TEMPLATE(BM_std_sort, 256)->RangeMultiplier(4)->Range(32, 1 << 16);
+
+/// Input orders for `BM_sort_pattern`.
+enum Pattern {
+    RANDOM,
+    SORTED,
+    REVERSE,
+    ORGAN_PIPE,
+    FEW_UNIQUE,
+};
+
+static void fill_pattern(uint64_t* data, size_t length, Pattern pattern, std::mt19937& rand) {
+    for (size_t i = 0; i < length; ++i) {
+        switch (pattern) {
+            case RANDOM:
+                data[i] = rand();
+                break;
+            case SORTED:
+                data[i] = i;
+                break;
+            case REVERSE:
+                data[i] = length - i;
+                break;
+            case ORGAN_PIPE:
+                data[i] = i < length / 2 ? i : length - i;
+                break;
+            case FEW_UNIQUE:
+                data[i] = rand() % 16;
+                break;
+        }
+    }
+}
+
+template <bool Use_Std>
+static void BM_sort_pattern(benchmark::State& state, Pattern pattern) {
+    size_t length = state.range(0);
+
+    std::mt19937 rand(length);
+
+    uint64_t* data = (uint64_t*)malloc(sizeof(uint64_t) * length);
+    CZ_DEFER(free(data));
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        fill_pattern(data, length, pattern, rand);
+        state.ResumeTiming();
+
+        if (Use_Std) {
+            std::sort(data, data + length);
+        } else {
+            cz::sort(cz::slice(data, length));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * length);
+}
+
+static void BM_cz_sort_pattern(benchmark::State& state, Pattern pattern) {
+    BM_sort_pattern<false>(state, pattern);
+}
+
+static void BM_std_sort_pattern(benchmark::State& state, Pattern pattern) {
+    BM_sort_pattern<true>(state, pattern);
+}
+
+BENCHMARK_CAPTURE(BM_cz_sort_pattern, random, RANDOM)->RangeMultiplier(16)->Range(32, 1 << 20);
+BENCHMARK_CAPTURE(BM_cz_sort_pattern, sorted, SORTED)->RangeMultiplier(16)->Range(32, 1 << 20);
+BENCHMARK_CAPTURE(BM_cz_sort_pattern, reverse, REVERSE)->RangeMultiplier(16)->Range(32, 1 << 20);
+BENCHMARK_CAPTURE(BM_cz_sort_pattern, organ_pipe, ORGAN_PIPE)
+    ->RangeMultiplier(16)
+    ->Range(32, 1 << 20);
+BENCHMARK_CAPTURE(BM_cz_sort_pattern, few_unique, FEW_UNIQUE)
+    ->RangeMultiplier(16)
+    ->Range(32, 1 << 20);
+
+BENCHMARK_CAPTURE(BM_std_sort_pattern, random, RANDOM)->RangeMultiplier(16)->Range(32, 1 << 20);
+BENCHMARK_CAPTURE(BM_std_sort_pattern, sorted, SORTED)->RangeMultiplier(16)->Range(32, 1 << 20);
+BENCHMARK_CAPTURE(BM_std_sort_pattern, reverse, REVERSE)->RangeMultiplier(16)->Range(32, 1 << 20);
+BENCHMARK_CAPTURE(BM_std_sort_pattern, organ_pipe, ORGAN_PIPE)
+    ->RangeMultiplier(16)
+    ->Range(32, 1 << 20);
+BENCHMARK_CAPTURE(BM_std_sort_pattern, few_unique, FEW_UNIQUE)
+    ->RangeMultiplier(16)
+    ->Range(32, 1 << 20);
+
+/// Sort `state.range(0)` random elements using `state.range(1)` threads.
+static void BM_parallel_sort(benchmark::State& state) {
+    size_t length = state.range(0);
+    size_t num_threads = state.range(1);
+
+    std::mt19937 rand(length);
+
+    uint64_t* data = (uint64_t*)malloc(sizeof(uint64_t) * length);
+    CZ_DEFER(free(data));
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        fill_pattern(data, length, RANDOM, rand);
+        state.ResumeTiming();
+
+        generic_parallel_sort(data, data + length, generic_is_less_ptr<uint64_t>,
+                              generic_swap_ptr<uint64_t>, num_threads);
+    }
+
+    state.SetItemsProcessed(state.iterations() * length);
+}
+
+/// Measure the speedup from 1 thread up to one thread per core.
+static void parallel_sort_args(benchmark::internal::Benchmark* benchmark) {
+    size_t max_threads = std::thread::hardware_concurrency();
+    for (int64_t length = 1 << 20; length <= (1 << 26); length <<= 3) {
+        for (size_t num_threads = 1; num_threads < max_threads; num_threads *= 2) {
+            benchmark->Args({length, (int64_t)num_threads});
+        }
+        benchmark->Args({length, (int64_t)max_threads});
+    }
+}
+
+BENCHMARK(BM_parallel_sort)
+    ->Apply(parallel_sort_args)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+/// Sorted data with 1% of the elements swapped with random other elements.
+static void fill_nearly_sorted(uint64_t* data, size_t length, std::mt19937& rand) {
+    for (size_t i = 0; i < length; ++i) {
+        data[i] = i;
+    }
+    for (size_t i = 0; i < length / 100; ++i) {
+        std::swap(data[rand() % length], data[rand() % length]);
+    }
+}
+
+enum Stable_Sorter {
+    STABLE_IN_PLACE,
+    STABLE_BUFFERED,
+    STABLE_STD,
+};
+
+static void BM_stable_sort(benchmark::State& state, Stable_Sorter sorter, bool nearly_sorted) {
+    size_t length = state.range(0);
+
+    std::mt19937 rand(length);
+
+    uint64_t* data = (uint64_t*)malloc(sizeof(uint64_t) * length);
+    CZ_DEFER(free(data));
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        if (nearly_sorted) {
+            fill_nearly_sorted(data, length, rand);
+        } else {
+            fill_pattern(data, length, RANDOM, rand);
+        }
+        state.ResumeTiming();
+
+        switch (sorter) {
+            case STABLE_IN_PLACE:
+                cz::stable_sort(cz::slice(data, length));
+                break;
+            case STABLE_BUFFERED:
+                cz::stable_sort(heap_allocator(), cz::slice(data, length));
+                break;
+            case STABLE_STD:
+                std::stable_sort(data, data + length);
+                break;
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * length);
+}
+
+BENCHMARK_CAPTURE(BM_stable_sort, in_place_nearly_sorted, STABLE_IN_PLACE, true)
+    ->RangeMultiplier(16)
+    ->Range(256, 1 << 20);
+BENCHMARK_CAPTURE(BM_stable_sort, buffered_nearly_sorted, STABLE_BUFFERED, true)
+    ->RangeMultiplier(16)
+    ->Range(256, 1 << 20);
+BENCHMARK_CAPTURE(BM_stable_sort, std_nearly_sorted, STABLE_STD, true)
+    ->RangeMultiplier(16)
+    ->Range(256, 1 << 20);
+BENCHMARK_CAPTURE(BM_stable_sort, in_place_random, STABLE_IN_PLACE, false)
+    ->RangeMultiplier(16)
+    ->Range(256, 1 << 20);
+BENCHMARK_CAPTURE(BM_stable_sort, buffered_random, STABLE_BUFFERED, false)
+    ->RangeMultiplier(16)
+    ->Range(256, 1 << 20);
+BENCHMARK_CAPTURE(BM_stable_sort, std_random, STABLE_STD, false)
+    ->RangeMultiplier(16)
+    ->Range(256, 1 << 20);
+
+/// Find the smallest 100 elements.
+template <bool Use_Std>
+static void BM_partial_sort_top_100(benchmark::State& state, bool nearly_sorted) {
+    size_t length = state.range(0);
+    const size_t count = 100;
+
+    std::mt19937 rand(length);
+
+    uint64_t* data = (uint64_t*)malloc(sizeof(uint64_t) * length);
+    CZ_DEFER(free(data));
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        if (nearly_sorted) {
+            fill_nearly_sorted(data, length, rand);
+        } else {
+            fill_pattern(data, length, RANDOM, rand);
+        }
+        state.ResumeTiming();
+
+        if (Use_Std) {
+            std::partial_sort(data, data + count, data + length);
+        } else {
+            cz::partial_sort(cz::slice(data, length), count);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * length);
+}
+
+static void BM_cz_partial_sort_top_100(benchmark::State& state, bool nearly_sorted) {
+    BM_partial_sort_top_100<false>(state, nearly_sorted);
+}
+
+static void BM_std_partial_sort_top_100(benchmark::State& state, bool nearly_sorted) {
+    BM_partial_sort_top_100<true>(state, nearly_sorted);
+}
+
+BENCHMARK_CAPTURE(BM_cz_partial_sort_top_100, nearly_sorted, true)
+    ->RangeMultiplier(10)
+    ->Range(1000, 10000000);
+BENCHMARK_CAPTURE(BM_std_partial_sort_top_100, nearly_sorted, true)
+    ->RangeMultiplier(10)
+    ->Range(1000, 10000000);
+BENCHMARK_CAPTURE(BM_cz_partial_sort_top_100, random, false)
+    ->RangeMultiplier(10)
+    ->Range(1000, 10000000);
+BENCHMARK_CAPTURE(BM_std_partial_sort_top_100, random, false)
+    ->RangeMultiplier(10)
+    ->Range(1000, 10000000);
+
+/// Find the median.
+template <bool Use_Std>
+static void BM_nth_element(benchmark::State& state, bool nearly_sorted) {
+    size_t length = state.range(0);
+
+    std::mt19937 rand(length);
+
+    uint64_t* data = (uint64_t*)malloc(sizeof(uint64_t) * length);
+    CZ_DEFER(free(data));
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        if (nearly_sorted) {
+            fill_nearly_sorted(data, length, rand);
+        } else {
+            fill_pattern(data, length, RANDOM, rand);
+        }
+        state.ResumeTiming();
+
+        if (Use_Std) {
+            std::nth_element(data, data + length / 2, data + length);
+        } else {
+            cz::nth_element(cz::slice(data, length), length / 2);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * length);
+}
+
+static void BM_cz_nth_element(benchmark::State& state, bool nearly_sorted) {
+    BM_nth_element<false>(state, nearly_sorted);
+}
+
+static void BM_std_nth_element(benchmark::State& state, bool nearly_sorted) {
+    BM_nth_element<true>(state, nearly_sorted);
+}
+
+BENCHMARK_CAPTURE(BM_cz_nth_element, nearly_sorted, true)
+    ->RangeMultiplier(10)
+    ->Range(1000, 10000000);
+BENCHMARK_CAPTURE(BM_std_nth_element, nearly_sorted, true)
+    ->RangeMultiplier(10)
+    ->Range(1000, 10000000);
+BENCHMARK_CAPTURE(BM_cz_nth_element, random, false)->RangeMultiplier(10)->Range(1000, 10000000);
+BENCHMARK_CAPTURE(BM_std_nth_element, random, false)->RangeMultiplier(10)->Range(1000, 10000000);
@@ -0,0 +1,159 @@
+#include <benchmark/benchmark.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <cz/dedup.hpp>
+#include <cz/defer.hpp>
+#include <cz/sorted_set.hpp>
+#include <random>
+
+using namespace cz;
+
+enum Implementation {
+    CZ,
+    STD,
+};
+
+enum Operation {
+    UNION,
+    INTERSECTION,
+    DIFFERENCE,
+};
+
+/// Make a set of about `length` elements out of `[0, range)`.
+static size_t make_set(uint32_t* data, size_t length, uint32_t range, std::mt19937& rand) {
+    for (size_t i = 0; i < length; ++i) {
+        data[i] = rand() % range;
+    }
+    std::sort(data, data + length);
+    return std::unique(data, data + length) - data;
+}
+
+/// Combine a set of `state.range(0)` elements with a set of `state.range(1)` elements.
+/// The elements are drawn from 4 times as many values as the bigger set has elements.
+///
+/// Small sets cycle through different pairs of sets so the
+/// branch predictor can't memorize the order of the elements.
+static void BM_set_operation(benchmark::State& state,
+                             Operation operation,
+                             Implementation implementation) {
+    size_t a_length = state.range(0);
+    size_t b_length = state.range(1);
+    uint32_t range = (uint32_t)(std::max(a_length, b_length) * 4);
+    size_t num_pairs = std::max((size_t)1, (size_t)(1 << 20) / (a_length + b_length));
+
+    std::mt19937 rand(a_length + b_length);
+    uint32_t* a = (uint32_t*)malloc(sizeof(uint32_t) * a_length * num_pairs);
+    CZ_DEFER(free(a));
+    uint32_t* b = (uint32_t*)malloc(sizeof(uint32_t) * b_length * num_pairs);
+    CZ_DEFER(free(b));
+    uint32_t* out = (uint32_t*)malloc(sizeof(uint32_t) * (a_length + b_length));
+    CZ_DEFER(free(out));
+    cz::Slice<uint32_t>* a_slices =
+        (cz::Slice<uint32_t>*)malloc(sizeof(cz::Slice<uint32_t>) * num_pairs);
+    CZ_DEFER(free(a_slices));
+    cz::Slice<uint32_t>* b_slices =
+        (cz::Slice<uint32_t>*)malloc(sizeof(cz::Slice<uint32_t>) * num_pairs);
+    CZ_DEFER(free(b_slices));
+    size_t total_len = 0;
+    for (size_t i = 0; i < num_pairs; ++i) {
+        uint32_t* a_elems = a + a_length * i;
+        uint32_t* b_elems = b + b_length * i;
+        a_slices[i] = {a_elems, make_set(a_elems, a_length, range, rand)};
+        b_slices[i] = {b_elems, make_set(b_elems, b_length, range, rand)};
+        total_len += a_slices[i].len + b_slices[i].len;
+    }
+
+    size_t pair = 0;
+    for (auto _ : state) {
+        cz::Slice<uint32_t> a_slice = a_slices[pair];
+        cz::Slice<uint32_t> b_slice = b_slices[pair];
+        pair = (pair + 1) % num_pairs;
+
+        size_t len = 0;
+        if (implementation == CZ) {
+            switch (operation) {
+                case UNION:
+                    len = set_union(a_slice, b_slice, out).len;
+                    break;
+                case INTERSECTION:
+                    len = set_intersection(a_slice, b_slice, out).len;
+                    break;
+                case DIFFERENCE:
+                    len = set_difference(a_slice, b_slice, out).len;
+                    break;
+            }
+        } else {
+            uint32_t* a_end = a_slice.end();
+            uint32_t* b_end = b_slice.end();
+            switch (operation) {
+                case UNION:
+                    len = std::set_union(a_slice.elems, a_end, b_slice.elems, b_end, out) - out;
+                    break;
+                case INTERSECTION:
+                    len = std::set_intersection(a_slice.elems, a_end, b_slice.elems, b_end, out) -
+                          out;
+                    break;
+                case DIFFERENCE:
+                    len =
+                        std::set_difference(a_slice.elems, a_end, b_slice.elems, b_end, out) - out;
+                    break;
+            }
+        }
+        benchmark::DoNotOptimize(len);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * total_len / num_pairs);
+}
+
+static void set_sizes(benchmark::internal::Benchmark* benchmark) {
+    benchmark->Args({1 << 10, 1 << 10});
+    benchmark->Args({1 << 20, 1 << 20});
+    // Skewed sizes gallop through the bigger set.
+    benchmark->Args({1 << 10, 1 << 20});
+}
+
+BENCHMARK_CAPTURE(BM_set_operation, union_cz, UNION, CZ)->Apply(set_sizes);
+BENCHMARK_CAPTURE(BM_set_operation, union_std, UNION, STD)->Apply(set_sizes);
+BENCHMARK_CAPTURE(BM_set_operation, intersection_cz, INTERSECTION, CZ)->Apply(set_sizes);
+BENCHMARK_CAPTURE(BM_set_operation, intersection_std, INTERSECTION, STD)->Apply(set_sizes);
+BENCHMARK_CAPTURE(BM_set_operation, difference_cz, DIFFERENCE, CZ)->Apply(set_sizes);
+BENCHMARK_CAPTURE(BM_set_operation, difference_std, DIFFERENCE, STD)->Apply(set_sizes);
+
+/// Dedup `state.range(0)` sorted elements where each element is repeated
+/// on average `state.range(1)` times.
+static void BM_dedup(benchmark::State& state, Implementation implementation) {
+    size_t length = state.range(0);
+    size_t repeats = state.range(1);
+
+    std::mt19937 rand(length);
+    uint32_t* original = (uint32_t*)malloc(sizeof(uint32_t) * length);
+    CZ_DEFER(free(original));
+    uint32_t* data = (uint32_t*)malloc(sizeof(uint32_t) * length);
+    CZ_DEFER(free(data));
+    for (size_t i = 0; i < length; ++i) {
+        original[i] = rand() % (length / repeats);
+    }
+    std::sort(original, original + length);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        memcpy(data, original, sizeof(uint32_t) * length);
+        state.ResumeTiming();
+
+        size_t len;
+        if (implementation == CZ) {
+            len = dedup(cz::Slice<uint32_t>{data, length}).len;
+        } else {
+            len = std::unique(data, data + length) - data;
+        }
+        benchmark::DoNotOptimize(len);
+    }
+
+    state.SetItemsProcessed(state.iterations() * length);
+}
+
+BENCHMARK_CAPTURE(BM_dedup, cz, CZ)->Args({1 << 20, 1})->Args({1 << 20, 4})->Args({1 << 20, 64});
+BENCHMARK_CAPTURE(BM_dedup, std, STD)->Args({1 << 20, 1})->Args({1 << 20, 4})->Args({1 << 20, 64});
@@ -0,0 +1,131 @@
+#include <benchmark/benchmark.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <algorithm>
+#include <cz/defer.hpp>
+#include <cz/heap.hpp>
+#include <cz/str_map.hpp>
+#include <cz/vector.hpp>
+#include <random>
+
+using namespace cz;
+
+/// Keys of the form "key_%zu" stored in `buffer`.  The first
+/// `count` keys are inserted and the rest are used for misses.
+struct Str_Map_Keys {
+    Vector<char> buffer;
+    Vector<Str> keys;
+
+    void init(size_t count) {
+        const size_t max_len = 32;
+        buffer = {};
+        keys = {};
+        buffer.reserve_exact(heap_allocator(), 2 * count * max_len);
+        keys.reserve_exact(heap_allocator(), 2 * count);
+        for (size_t i = 0; i < 2 * count; ++i) {
+            char* start = buffer.elems + buffer.len;
+            int len = snprintf(start, max_len, "key_%zu", i);
+            buffer.len += len;
+            keys.push({start, (size_t)len});
+        }
+    }
+
+    void drop() {
+        buffer.drop(heap_allocator());
+        keys.drop(heap_allocator());
+    }
+};
+
+static void BM_str_map_probe(benchmark::State& state, bool hit) {
+    size_t count = state.range(0);
+    Str_Map_Keys keys;
+    keys.init(count);
+    CZ_DEFER(keys.drop());
+
+    Str_Map<size_t> map = {};
+    CZ_DEFER(map.drop(heap_allocator()));
+    map.reserve(heap_allocator(), count);
+    for (size_t i = 0; i < count; ++i) {
+        map.insert_hash(keys.keys[i], i);
+    }
+
+    // Look keys up in a random order so we aren't just measuring the cache.
+    std::mt19937 rand(count);
+    Vector<Str> lookups = {};
+    CZ_DEFER(lookups.drop(heap_allocator()));
+    lookups.reserve_exact(heap_allocator(), count);
+    lookups.append(keys.keys.slice(hit ? 0 : count, hit ? count : 2 * count));
+    std::shuffle(lookups.elems, lookups.elems + lookups.len, rand);
+
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(map.get_hash(lookups[i]));
+        if (++i == lookups.len) {
+            i = 0;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+
+    size_t total_probe = 0;
+    size_t max_probe = 0;
+    for (size_t slot = 0; slot < map.cap; ++slot) {
+        if (map.is_present(slot)) {
+            size_t probe = (slot - map.hashes[slot]) & (map.cap - 1);
+            total_probe += probe;
+            max_probe = std::max(max_probe, probe);
+        }
+    }
+    state.counters["avg_probe"] = (double)total_probe / count;
+    state.counters["max_probe"] = (double)max_probe;
+}
+
+BENCHMARK_CAPTURE(BM_str_map_probe, hit, true)->RangeMultiplier(10)->Range(1000, 1000000);
+BENCHMARK_CAPTURE(BM_str_map_probe, miss, false)->RangeMultiplier(10)->Range(1000, 1000000);
+
+/// Time growing a full map to twice its size.
+static void BM_str_map_grow(benchmark::State& state) {
+    size_t count = state.range(0);
+    Str_Map_Keys keys;
+    keys.init(count);
+    CZ_DEFER(keys.drop());
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        Str_Map<size_t> map = {};
+        map.reserve(heap_allocator(), count);
+        for (size_t i = 0; i < count; ++i) {
+            map.insert_hash(keys.keys[i], i);
+        }
+        state.ResumeTiming();
+
+        map.reserve(heap_allocator(), map.cap);
+
+        state.PauseTiming();
+        map.drop(heap_allocator());
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK(BM_str_map_grow)->RangeMultiplier(10)->Range(1000, 1000000);
+
+/// Time inserting keys one at a time, including every resize along the way.
+static void BM_str_map_insert_incremental(benchmark::State& state) {
+    size_t count = state.range(0);
+    Str_Map_Keys keys;
+    keys.init(count);
+    CZ_DEFER(keys.drop());
+
+    for (auto _ : state) {
+        Str_Map<size_t> map = {};
+        for (size_t i = 0; i < count; ++i) {
+            map.reserve(heap_allocator(), 1);
+            map.insert_hash(keys.keys[i], i);
+        }
+        map.drop(heap_allocator());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK(BM_str_map_insert_incremental)->RangeMultiplier(10)->Range(1000, 1000000);
@@ -0,0 +1,77 @@
+#include <benchmark/benchmark.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <cz/defer.hpp>
+#include <cz/heap.hpp>
+#include <cz/str_map_removable.hpp>
+#include <cz/vector.hpp>
+#include <random>
+
+using namespace cz;
+
+/// Simulate a session cache: keep `live` keys in the map and on every iteration remove
+/// a random key, insert a fresh one, and look up a random live key.  The whole run is
+/// `state.range(1)` iterations so the map sees far more removals than it has slots.
+/// Lookup latency should stay flat as the number of rounds grows.
+static void BM_str_map_removable_churn(benchmark::State& state) {
+    size_t live = state.range(0);
+    size_t rounds = state.range(1);
+
+    // Every iteration uses a new key so allocate space for all of them up front.
+    const size_t max_len = 24;
+    size_t total = live + rounds;
+    Vector<char> buffer = {};
+    Vector<Str> keys = {};
+    CZ_DEFER(buffer.drop(heap_allocator()));
+    CZ_DEFER(keys.drop(heap_allocator()));
+    buffer.reserve_exact(heap_allocator(), total * max_len);
+    keys.reserve_exact(heap_allocator(), total);
+    for (size_t i = 0; i < total; ++i) {
+        char* start = buffer.elems + buffer.len;
+        int len = snprintf(start, max_len, "session_%zu", i);
+        buffer.len += len;
+        keys.push({start, (size_t)len});
+    }
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        Str_Map_Removable<size_t> map = {};
+        map.reserve(heap_allocator(), live);
+        // `slots[i]` is the index of the key currently in live slot `i`.
+        Vector<size_t> slots = {};
+        slots.reserve_exact(heap_allocator(), live);
+        for (size_t i = 0; i < live; ++i) {
+            map.insert_hash(keys[i], i);
+            slots.push(i);
+        }
+        std::mt19937 rand(live);
+        state.ResumeTiming();
+
+        for (size_t round = 0; round < rounds; ++round) {
+            size_t victim = rand() % live;
+            map.remove_hash(keys[slots[victim]]);
+            slots[victim] = live + round;
+            map.reserve(heap_allocator(), 1);
+            map.insert_hash(keys[slots[victim]], slots[victim]);
+
+            benchmark::DoNotOptimize(map.get_hash(keys[slots[rand() % live]]));
+        }
+
+        state.PauseTiming();
+        slots.drop(heap_allocator());
+        map.drop(heap_allocator());
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * rounds);
+}
+
+BENCHMARK(BM_str_map_removable_churn)
+    ->Args({1000, 100000})
+    ->Args({1000, 1000000})
+    ->Args({1000, 10000000})
+    ->Args({100000, 100000})
+    ->Args({100000, 1000000})
+    ->Args({100000, 10000000})
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,54 @@
+#include <benchmark/benchmark.h>
+
+#include <stdint.h>
+#include <cz/heap.hpp>
+#include <cz/vector.hpp>
+#include <cz/virtual_arena.hpp>
+
+using namespace cz;
+
+/// Push `state.range(0)` elements one at a time.  Reports the wasted capacity at the end.
+static void push_many(benchmark::State& state, Allocator allocator, Growth_Policy policy) {
+    size_t length = state.range(0);
+    size_t cap = 0;
+    for (auto _ : state) {
+        Vector<uint64_t> vector = {};
+        for (size_t i = 0; i < length; ++i) {
+            vector.reserve(allocator, 1, policy);
+            vector.push(i);
+        }
+        benchmark::DoNotOptimize(vector.elems);
+        cap = vector.cap;
+        vector.drop(allocator);
+    }
+
+    state.counters["wasted"] = (double)(cap - length) / cap;
+    state.SetItemsProcessed(state.iterations() * length);
+}
+
+static void BM_vector_push_heap(benchmark::State& state, Growth_Policy policy) {
+    push_many(state, heap_allocator(), policy);
+}
+
+static void BM_vector_push_virtual_arena(benchmark::State& state, Growth_Policy policy) {
+    Virtual_Arena arena;
+    CZ_ASSERT(arena.init((size_t)16 << 30));
+    push_many(state, arena.allocator(), policy);
+    arena.drop();
+}
+
+/// Lengths that aren't powers of two so the growth policies waste different amounts.
+static void lengths(benchmark::internal::Benchmark* benchmark) {
+    benchmark->Arg(1000)->Arg(300000)->Arg(30000000)->Arg(150000000);
+}
+
+BENCHMARK_CAPTURE(BM_vector_push_heap, power_of_two, grow_power_of_two)
+    ->Apply(lengths);
+BENCHMARK_CAPTURE(BM_vector_push_heap, one_and_a_half, grow_one_and_a_half)
+    ->Apply(lengths);
+BENCHMARK_CAPTURE(BM_vector_push_heap, page_granular, grow_page_granular)
+    ->Apply(lengths);
+BENCHMARK_CAPTURE(BM_vector_push_virtual_arena, power_of_two, grow_power_of_two)
+    ->Apply(lengths);
+BENCHMARK_CAPTURE(BM_vector_push_virtual_arena, page_granular, grow_page_granular)
+    ->Apply(lengths);
@@ -33,6 +33,13 @@ struct Allocator {
 
     void* data;
 
+    /// Optionally grow or shrink `old_mem` to `new_size` bytes without moving it.
+    ///
+    /// Returns `true` and resizes the memory region on success.  Returns `false`
+    /// and leaves `old_mem` untouched if it can't be resized in place.  Allocators
+    /// that can't ever resize in place (ex. `heap_allocator`) leave this as `nullptr`.
+    bool (*expand_in_place)(void* data, MemSlice old_mem, size_t new_size);
+
 #ifndef NDEBUG
     // When compiled in debug mode we have out of line handlers that check preconditions
     // and fill uninitialized memory with random values to try to find bugs.
@@ -44,6 +51,8 @@ struct Allocator {
     void dealloc(MemSlice old_mem) const;
     /// Reallocate memory allocated using this allocator.
     void* realloc(MemSlice old_mem, AllocInfo new_info) const;
+    /// Try to resize memory allocated using this allocator without moving it.
+    bool try_expand_in_place(MemSlice old_mem, size_t new_size) const;
 #else
     // When compiled in release mode call the virtual function without any checks.
 
@@ -60,6 +69,10 @@ struct Allocator {
     void* realloc(MemSlice old_mem, AllocInfo new_info) const {
         return reallocate(data, old_mem, new_info);
     }
+    /// Try to resize memory allocated using this allocator without moving it.
+    bool try_expand_in_place(MemSlice old_mem, size_t new_size) const {
+        return expand_in_place && old_mem.buffer && expand_in_place(data, old_mem, new_size);
+    }
 #endif
 
     /// Allocate memory to store a value of the given type using this allocator.
@@ -119,6 +132,12 @@ struct Allocator {
     T* realloc(T* old_mem, size_t old_len, size_t new_len) const {
         return (T*)realloc({old_mem, old_len * sizeof(T)}, {new_len * sizeof(T), alignof(T)});
     }
+
+    /// Try to resize an array of a given type without moving it.
+    template <class T>
+    bool try_expand_in_place(T* old_mem, size_t old_len, size_t new_len) const {
+        return try_expand_in_place({old_mem, old_len * sizeof(T)}, new_len * sizeof(T));
+    }
 };
 
 /// Change the allocator that the thing is allocated in.
@@ -32,11 +32,15 @@ struct Arena {
 
     void drop(Allocator allocator) { allocator.dealloc(start, end - start); }
 
-    Allocator allocator() { return {Arena::realloc, Arena::dealloc, this}; }
+    Allocator allocator() {
+        return {Arena::realloc, Arena::dealloc, this, Arena::expand_in_place};
+    }
     size_t remaining() const { return end - pointer; }
 
     static void* realloc(void* arena, MemSlice old_mem, AllocInfo new_info);
     static void dealloc(void* arena, MemSlice old_mem);
+    /// Only the most recent allocation can be resized in place.
+    static bool expand_in_place(void* arena, MemSlice old_mem, size_t new_size);
 };
 
 }
@@ -1,67 +1,98 @@
 #pragma once
 
+#include <stdint.h>
 #include <cz/slice.hpp>
 
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
 namespace cz {
 
-/// Search for an element in the slice.  If an equivalent element is found then
-/// stores its index in `*index` and returns `true`.  Otherwise, stores in `*index`
-/// where it would reside if inserted to keep the slice in order and returns `false`.
+namespace binary_search_impl {
+
+/// Hint that `pointer` will be read soon.  Never faults so
+/// it is fine to prefetch addresses past the end of an array.
+inline void prefetch(const void* pointer) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(pointer);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_prefetch((const char*)pointer, _MM_HINT_T0);
+#else
+    (void)pointer;
+#endif
+}
+
+}
+
+/// Find the index of the first element in the sorted slice that is not less than `element`.
+/// Returns `slice.len` if every element is less than `element`.
+///
+/// The loop always runs `ceil(log2(len))` iterations and picks the next half with a
+/// conditional move instead of a branch so it doesn't mispredict.  Both possible
+/// next midpoints are prefetched so large slices wait on memory less.
 template <class T>
-bool binary_search(cz::Slice<T> slice, const T& element, size_t* index) {
+size_t lower_bound(cz::Slice<T> slice, const T& element) {
     if (slice.len == 0) {
-        *index = 0;
-        return false;
+        return 0;
     }
 
-    size_t start = 0;
-    size_t end = slice.len;
-    while (start + 1 < end) {
-        size_t mid = (start + end) / 2;
-        if (element < slice[mid]) {
-            end = mid;
-        } else {
-            start = mid;
-        }
+    const T* base = slice.elems;
+    size_t len = slice.len;
+    while (len > 1) {
+        size_t half = len / 2;
+        len -= half;
+        binary_search_impl::prefetch(&base[len / 2]);
+        binary_search_impl::prefetch(&base[half + len / 2]);
+        base = (base[half] < element) ? base + half : base;
     }
+    return (size_t)(base - slice.elems) + (*base < element);
+}
 
-    if (slice[start] < element) {
-        ++start;
+/// Find the index of the first element in the sorted slice that is not less than `element`.
+/// Returns `slice.len` if every element is less than `element`.
+///
+/// Comparator should be of type `int64_t (*)(const T&, const T&)`.
+template <class T, class Comparator>
+size_t lower_bound(cz::Slice<T> slice, const T& element, Comparator&& comparator) {
+    if (slice.len == 0) {
+        return 0;
     }
 
-    *index = start;
-    return start < end && slice[start] == element;
+    const T* base = slice.elems;
+    size_t len = slice.len;
+    while (len > 1) {
+        size_t half = len / 2;
+        len -= half;
+        binary_search_impl::prefetch(&base[len / 2]);
+        binary_search_impl::prefetch(&base[half + len / 2]);
+        base = (comparator(base[half], element) < 0) ? base + half : base;
+    }
+    return (size_t)(base - slice.elems) + (comparator(*base, element) < 0);
+}
+
+/// Search for an element in the slice.  If an equivalent element is found then
+/// stores its index in `*index` and returns `true`.  Otherwise, stores in `*index`
+/// where it would reside if inserted to keep the slice in order and returns `false`.
+///
+/// If there are multiple equivalent elements then the index of the first one is stored.
+template <class T>
+bool binary_search(cz::Slice<T> slice, const T& element, size_t* index) {
+    *index = lower_bound(slice, element);
+    return *index < slice.len && slice[*index] == element;
 }
 
 /// Search for an element in the slice.  If an equivalent element is found then
 /// stores its index in `*index` and returns `true`.  Otherwise, stores in `*index`
 /// where it would reside if inserted to keep the slice in order and returns `false`.
 ///
+/// If there are multiple equivalent elements then the index of the first one is stored.
+///
 /// Comparator should be of type `int64_t (*)(const T&, const T&)`.
 template <class T, class Comparator>
 bool binary_search(cz::Slice<T> slice, const T& element, size_t* index, Comparator&& comparator) {
-    if (slice.len == 0) {
-        *index = 0;
-        return false;
-    }
-
-    size_t start = 0;
-    size_t end = slice.len;
-    while (start + 1 < end) {
-        size_t mid = (start + end) / 2;
-        if (comparator(element, slice[mid]) < 0) {
-            end = mid;
-        } else {
-            start = mid;
-        }
-    }
-
-    if (comparator(slice[start], element) < 0) {
-        ++start;
-    }
-
-    *index = start;
-    return start < end && comparator(slice[start], element) == 0;
+    *index = lower_bound(slice, element, comparator);
+    return *index < slice.len && comparator(slice[*index], element) == 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -80,6 +111,175 @@ bool binary_search(cz::Slice<T> slice, const T& element, Comparator&& comparator
     return binary_search(slice, element, &index, comparator);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Batched searches
+////////////////////////////////////////////////////////////////////////////////
+
+namespace binary_search_impl {
+
+/// The number of queries searched for at the same time by `lower_bound_interleaved`.
+constexpr const size_t interleave_width = 16;
+
+/// Sorted queries are searched for by galloping if there are fewer than
+/// this many elements in the slice per query on average.
+constexpr const size_t gallop_max_gap = 16;
+
+/// Search for up to `interleave_width` queries at the same time.  Each step moves every query
+/// down one level and prefetches its next midpoint so the cache misses of different queries
+/// overlap instead of each query waiting on memory at every level.
+template <class T, class Is_Less>
+void lower_bound_interleaved(cz::Slice<T> slice,
+                             const T* queries,
+                             size_t count,
+                             size_t* indices,
+                             Is_Less& is_less) {
+    const T* bases[interleave_width];
+    for (size_t i = 0; i < count; ++i) {
+        bases[i] = slice.elems;
+    }
+
+    // Every query takes the same number of steps because `len` doesn't depend on the query.
+    size_t len = slice.len;
+    while (len > 1) {
+        size_t half = len / 2;
+        len -= half;
+        for (size_t i = 0; i < count; ++i) {
+            const T* base = bases[i];
+            base = is_less(base[half], queries[i]) ? base + half : base;
+            prefetch(&base[len / 2]);
+            bases[i] = base;
+        }
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        indices[i] = (size_t)(bases[i] - slice.elems) + is_less(*bases[i], queries[i]);
+    }
+}
+
+/// Search for sorted queries by walking forward from the result of the previous query.
+/// Gallops forward to bound the result and then does a `lower_bound` on that range.
+template <class T, class Is_Less>
+void lower_bound_galloping(cz::Slice<T> slice,
+                           cz::Slice<T> queries,
+                           size_t* indices,
+                           Is_Less& is_less) {
+    size_t start = 0;
+    for (size_t i = 0; i < queries.len; ++i) {
+        const T& query = queries[i];
+
+        // Every element before `start` is less than `query` and
+        // `slice[end]` is not less than `query` (if it exists).
+        size_t end = start;
+        for (size_t step = 1; end < slice.len && is_less(slice[end], query); step *= 2) {
+            start = end + 1;
+            end += step;
+        }
+        if (end > slice.len) {
+            end = slice.len;
+        }
+
+        const T* base = slice.elems + start;
+        size_t len = end - start;
+        if (len > 0) {
+            while (len > 1) {
+                size_t half = len / 2;
+                len -= half;
+                base = is_less(base[half], query) ? base + half : base;
+            }
+            base += is_less(*base, query);
+        }
+
+        start = (size_t)(base - slice.elems);
+        indices[i] = start;
+    }
+}
+
+template <class T, class Is_Less>
+void lower_bound_many(cz::Slice<T> slice,
+                      cz::Slice<T> queries,
+                      size_t* indices,
+                      Is_Less&& is_less) {
+    // Galloping reads every cache line between results so it
+    // only wins when the queries are dense compared to the slice.
+    if (slice.len < gallop_max_gap * queries.len) {
+        bool sorted = true;
+        for (size_t i = 1; i < queries.len; ++i) {
+            if (is_less(queries[i], queries[i - 1])) {
+                sorted = false;
+                break;
+            }
+        }
+
+        if (sorted) {
+            lower_bound_galloping(slice, queries, indices, is_less);
+            return;
+        }
+    }
+
+    for (size_t i = 0; i < queries.len; i += interleave_width) {
+        size_t count = queries.len - i;
+        if (count > interleave_width) {
+            count = interleave_width;
+        }
+        lower_bound_interleaved(slice, queries.elems + i, count, indices + i, is_less);
+    }
+}
+
+}
+
+/// Run `lower_bound` for each element in `queries` and store the results in `indices`.
+/// `indices` must have room for `queries.len` elements.
+///
+/// This is faster than calling `lower_bound` in a loop.  The queries are searched for in
+/// groups so the cache misses of the queries in a group overlap.  If `queries` is sorted
+/// and dense compared to `slice` then each search instead gallops forward from the previous
+/// result so the slice is read front to back like a merge.
+template <class T>
+void lower_bound_many(cz::Slice<T> slice, cz::Slice<T> queries, size_t* indices) {
+    binary_search_impl::lower_bound_many(
+        slice, queries, indices, [](const T& left, const T& right) { return left < right; });
+}
+
+/// Run `lower_bound` for each element in `queries` and store the results in `indices`.
+/// See above.
+///
+/// Comparator should be of type `int64_t (*)(const T&, const T&)`.
+template <class T, class Comparator>
+void lower_bound_many(cz::Slice<T> slice,
+                      cz::Slice<T> queries,
+                      size_t* indices,
+                      Comparator&& comparator) {
+    binary_search_impl::lower_bound_many(
+        slice, queries, indices,
+        [&](const T& left, const T& right) { return comparator(left, right) < 0; });
+}
+
+/// Run `binary_search` for each element in `queries`.  Stores the indices in `indices`
+/// and whether each query was found in `found`.  Both must have room for `queries.len`
+/// elements.  See `lower_bound_many` for how this is faster than calling `binary_search`.
+template <class T>
+void binary_search_many(cz::Slice<T> slice, cz::Slice<T> queries, size_t* indices, bool* found) {
+    lower_bound_many(slice, queries, indices);
+    for (size_t i = 0; i < queries.len; ++i) {
+        found[i] = indices[i] < slice.len && slice[indices[i]] == queries[i];
+    }
+}
+
+/// Run `binary_search` for each element in `queries`.  See above.
+///
+/// Comparator should be of type `int64_t (*)(const T&, const T&)`.
+template <class T, class Comparator>
+void binary_search_many(cz::Slice<T> slice,
+                        cz::Slice<T> queries,
+                        size_t* indices,
+                        bool* found,
+                        Comparator&& comparator) {
+    lower_bound_many(slice, queries, indices, comparator);
+    for (size_t i = 0; i < queries.len; ++i) {
+        found[i] = indices[i] < slice.len && comparator(slice[indices[i]], queries[i]) == 0;
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Overloads for vector
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,279 @@
+#pragma once
+
+#include <stdint.h>
+#include "allocator.hpp"
+#include "assert.hpp"
+#include "slice.hpp"
+#include "util.hpp"
+#include "vector.hpp"
+
+namespace cz {
+
+/// A dynamic array that stores its elements in fixed size buckets (aka a segmented vector).
+///
+/// Unlike a `Vector`, growing never moves the existing elements so pointers to them
+/// stay valid until they are popped or the array is dropped.  Use this instead of
+/// boxing each element via `Allocator::create` to get stable addresses.
+/// Indexing is O(1) since `Bucket_Size` is a power of two.
+///
+/// To iterate quickly, loop over each bucket via `bucket(i)` or use `for_each`.
+///
+/// # Example
+///
+/// ```
+/// cz::Bucket_Array<Node> nodes = {};
+/// CZ_DEFER(nodes.drop(cz::heap_allocator()));
+///
+/// nodes.reserve(cz::heap_allocator(), 1);
+/// Node* root = nodes.push({});
+///
+/// // `root` stays valid even though the array grows.
+/// for (size_t i = 0; i < 1000; ++i) {
+///     nodes.reserve(cz::heap_allocator(), 1);
+///     nodes.push({root});
+/// }
+/// ```
+template <class T, size_t Bucket_Size = 64>
+struct Bucket_Array {
+    static_assert(Bucket_Size > 0 && (Bucket_Size & (Bucket_Size - 1)) == 0,
+                  "Bucket_Size must be a power of two");
+
+    /// Each bucket stores `Bucket_Size` elements.
+    Vector<T*> buckets;
+    size_t len;
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    void drop(Allocator allocator) {
+        for (size_t i = 0; i < buckets.len; ++i) {
+            allocator.dealloc(buckets[i], Bucket_Size);
+        }
+        buckets.drop(allocator);
+    }
+
+    size_t capacity() const { return buckets.len * Bucket_Size; }
+    size_t remaining() const { return capacity() - len; }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    /// Ensure there are `extra` spaces available.  Allocates whole buckets.
+    void reserve(Allocator allocator, size_t extra) { reserve_total(allocator, len + extra); }
+    void reserve_total(Allocator allocator, size_t total) {
+        if (CZ_UNLIKELY(capacity() < total)) {
+            size_t num_buckets = (total + Bucket_Size - 1) / Bucket_Size;
+            buckets.reserve_total(allocator, num_buckets);
+            while (buckets.len < num_buckets) {
+                T* bucket = allocator.alloc<T>(Bucket_Size);
+                CZ_ASSERT(bucket);
+                buckets.push(bucket);
+            }
+        }
+    }
+
+    /// Deallocate the buckets after the one containing the last element.
+    void trim(Allocator allocator) {
+        size_t num_buckets = (len + Bucket_Size - 1) / Bucket_Size;
+        while (buckets.len > num_buckets) {
+            allocator.dealloc(buckets.pop(), Bucket_Size);
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    /// Push an element and return a pointer to it.  The pointer stays valid until
+    /// the element is popped.  Must `reserve` space before pushing.
+    T* push(T t) {
+        CZ_DEBUG_ASSERT(len < capacity());
+        T* elem = &buckets[len / Bucket_Size][len & (Bucket_Size - 1)];
+        *elem = t;
+        ++len;
+        return elem;
+    }
+
+    /// Pop one element.  Note: must have an element to pop!
+    T pop() {
+        CZ_DEBUG_ASSERT(len >= 1);
+        --len;
+        return get_unchecked(len);
+    }
+
+    /// Remove the element at `index` by moving the last element into its place.
+    /// Only the last element is moved so pointers to the other elements stay valid.
+    void swap_remove(size_t index) {
+        CZ_DEBUG_ASSERT(index < len);
+        --len;
+        get_unchecked(index) = get_unchecked(len);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    /// Must manually bounds check!
+    T& operator[](size_t index) { return get(index); }
+    const T& operator[](size_t index) const { return get(index); }
+
+    T& get(size_t index) {
+        CZ_DEBUG_ASSERT(index < len);
+        return get_unchecked(index);
+    }
+    const T& get(size_t index) const {
+        CZ_DEBUG_ASSERT(index < len);
+        return get_unchecked(index);
+    }
+
+    T& last() { return get(len - 1); }
+    const T& last() const { return get(len - 1); }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    /// The number of buckets that contain elements.
+    size_t num_buckets() const { return (len + Bucket_Size - 1) / Bucket_Size; }
+
+    /// Get the elements in the `index`th bucket.  Only the last bucket is partially full.
+    Slice<T> bucket(size_t index) {
+        CZ_DEBUG_ASSERT(index < num_buckets());
+        size_t start = index * Bucket_Size;
+        size_t count = len - start < Bucket_Size ? len - start : Bucket_Size;
+        return {buckets[index], count};
+    }
+    Slice<const T> bucket(size_t index) const {
+        CZ_DEBUG_ASSERT(index < num_buckets());
+        size_t start = index * Bucket_Size;
+        size_t count = len - start < Bucket_Size ? len - start : Bucket_Size;
+        return {buckets[index], count};
+    }
+
+    /// Call `func(T&)` on each element in order.
+    template <class Func>
+    void for_each(Func&& func) {
+        size_t count = num_buckets();
+        for (size_t i = 0; i < count; ++i) {
+            Slice<T> slice = bucket(i);
+            for (size_t j = 0; j < slice.len; ++j) {
+                func(slice[j]);
+            }
+        }
+    }
+
+private:
+    T& get_unchecked(size_t index) {
+        return buckets[index / Bucket_Size][index & (Bucket_Size - 1)];
+    }
+    const T& get_unchecked(size_t index) const {
+        return buckets[index / Bucket_Size][index & (Bucket_Size - 1)];
+    }
+};
+
+/// A reference to an element in a `Bucket_Pool`.
+struct Bucket_Handle {
+    uint32_t index;
+    /// Incremented each time the slot is reused so handles to removed elements are rejected.
+    uint32_t generation;
+
+    bool operator==(Bucket_Handle other) const {
+        return index == other.index && generation == other.generation;
+    }
+    bool operator!=(Bucket_Handle other) const { return !(*this == other); }
+};
+
+/// A `Bucket_Array` where elements can be removed from the middle.  Removed slots are put
+/// on a freelist and reused by later insertions so element addresses stay stable.
+///
+/// Elements are referred to by `Bucket_Handle`s.  Each slot has a generation
+/// counter that is incremented on insertion and removal so a handle to
+/// a removed element is detected instead of aliasing the new element.
+///
+/// # Example
+///
+/// ```
+/// cz::Bucket_Pool<Entity> entities = {};
+/// CZ_DEFER(entities.drop(cz::heap_allocator()));
+///
+/// cz::Bucket_Handle player = entities.insert(cz::heap_allocator(), {});
+/// entities.remove(cz::heap_allocator(), player);
+/// CZ_ASSERT(entities.get(player) == nullptr);
+/// ```
+template <class T, size_t Bucket_Size = 64>
+struct Bucket_Pool {
+    Bucket_Array<T, Bucket_Size> elems;
+    /// Odd generations are live slots and even generations are free slots.
+    Bucket_Array<uint32_t, Bucket_Size> generations;
+    /// Indices of free slots.
+    Vector<uint32_t> free_slots;
+    /// The number of live elements.
+    size_t count;
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    void drop(Allocator allocator) {
+        elems.drop(allocator);
+        generations.drop(allocator);
+        free_slots.drop(allocator);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    /// Insert an element, reusing a removed slot if there is one.
+    Bucket_Handle insert(Allocator allocator, T t) {
+        uint32_t index;
+        if (free_slots.len > 0) {
+            index = free_slots.pop();
+            elems[index] = t;
+        } else {
+            CZ_ASSERT(elems.len < UINT32_MAX);
+            index = (uint32_t)elems.len;
+            elems.reserve(allocator, 1);
+            generations.reserve(allocator, 1);
+            elems.push(t);
+            generations.push(0);
+        }
+
+        uint32_t generation = ++generations[index];
+        ++count;
+        return {index, generation};
+    }
+
+    /// Remove the element referenced by `handle`.  Returns `false` if it was already removed.
+    bool remove(Allocator allocator, Bucket_Handle handle) {
+        if (!is_live(handle)) {
+            return false;
+        }
+
+        ++generations[handle.index];
+        --count;
+        free_slots.reserve(allocator, 1);
+        free_slots.push(handle.index);
+        return true;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    bool is_live(Bucket_Handle handle) const {
+        return handle.index < generations.len && generations[handle.index] == handle.generation &&
+               (handle.generation & 1);
+    }
+
+    /// Get the element referenced by `handle` or `nullptr` if it has been removed.
+    T* get(Bucket_Handle handle) {
+        if (!is_live(handle)) {
+            return nullptr;
+        }
+        return &elems[handle.index];
+    }
+
+    /// Call `func(T&)` on each live element in slot order.
+    template <class Func>
+    void for_each(Func&& func) {
+        size_t num_buckets = elems.num_buckets();
+        for (size_t i = 0; i < num_buckets; ++i) {
+            Slice<T> values = elems.bucket(i);
+            Slice<uint32_t> gens = generations.bucket(i);
+            for (size_t j = 0; j < values.len; ++j) {
+                if (gens[j] & 1) {
+                    func(values[j]);
+                }
+            }
+        }
+    }
+};
+
+}
@@ -6,7 +6,13 @@
 namespace cz {
 
 /// `Buffer_Array`: a fast slab based allocator.  Stores an array
-/// of `4096`-byte buffers that elements can be allocated into.
+/// of buffers (by default `4096` bytes each) that elements can be allocated into.
+///
+/// The size of each new buffer is `buffer_size`.  If `max_buffer_size` is larger than
+/// `buffer_size` then `buffer_size` doubles every time a buffer is added until it reaches
+/// `max_buffer_size`.  Allocations that don't fit in a buffer get their own buffer.
+///
+/// Buffers are not deallocated by `restore` or `clear` and are instead reused.
 ///
 /// Doesn't support deallocating anything except for the most recently allocated
 /// object.  Instead, `save` the state before the allocations and `restore` after.
@@ -25,22 +31,29 @@ namespace cz {
 /// For more complex layouts remember that you can allocate data temporarily on the heap
 /// then transfer it into the `Buffer_Array` via the `clone` method and a deferred drop.
 struct Buffer_Array {
-    static constexpr const size_t buffer_size = 0x1000;
+    static constexpr const size_t default_buffer_size = 0x1000;
+
+    /// The size of the next buffer to be allocated.
+    size_t buffer_size;
+    size_t max_buffer_size;
 
-    char** buffers;
+    MemSlice* buffers;
     size_t num_buffers;
 
     size_t buffer_index;
     char* buffer_pointer;
     char* buffer_end;
 
-    /// Allocate the initial data.
-    void init();
+    /// Allocate the initial data.  If `max_buffer_size <= buffer_size`
+    /// then all buffers will be `buffer_size` bytes.
+    void init(size_t buffer_size = default_buffer_size, size_t max_buffer_size = 0);
     /// Drop all data.
     void drop();
 
     /// Note: you can only reallocate / deallocate the last allocated item!
-    Allocator allocator() { return {Buffer_Array::realloc, Buffer_Array::dealloc, this}; }
+    Allocator allocator() {
+        return {Buffer_Array::realloc, Buffer_Array::dealloc, this, nullptr};
+    }
 
     /// Completely cleares all state.
     void clear() { restore({0, 0}); }
@@ -63,7 +76,7 @@ struct Buffer_Array {
 Buffer_Array::Save_Point Buffer_Array::save() const {
     return {
         buffer_index,
-        (size_t)(buffer_pointer - buffers[buffer_index]),
+        (size_t)(buffer_pointer - (char*)buffers[buffer_index].buffer),
     };
 }
 
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <stddef.h>
+#include "allocator.hpp"
+#include "heap.hpp"
+
+namespace cz {
+
+struct Chained_Arena_Block {
+    Chained_Arena_Block* next;
+    size_t size;
+};
+
+/// A `Chained_Arena` is an `Arena` that grows by allocating new blocks from the `backer`
+/// instead of failing when it runs out of space.  Each new block is at least double the size
+/// of the previous block.  Allocation is the same pointer bump as in `Arena` so long as the
+/// current block has space.  Allocation only fails if the `backer` fails.
+///
+/// Like `Buffer_Array`, only the most recent allocation can be reallocated in place or
+/// deallocated.  Instead, `save` the state before the allocations and `restore` after.
+///
+/// Blocks are kept around after `restore` and `clear` so they can be reused.  Thus in
+/// a loop that calls `clear` at the end of each iteration (ex. per request), the
+/// steady state does no allocations via the `backer`.  Call `trim` to give
+/// the blocks after the current block back to the `backer`.
+///
+/// # Example
+///
+/// ```
+/// cz::Chained_Arena arena;
+/// arena.init();
+/// CZ_DEFER(arena.drop());
+///
+/// while (handle_request(arena.allocator())) {
+///     arena.clear();
+/// }
+/// ```
+struct Chained_Arena {
+    Allocator backer;
+    size_t first_block_size;
+
+    /// The list of blocks.  Blocks after `current` are unused.
+    Chained_Arena_Block* first;
+    Chained_Arena_Block* current;
+
+    char* pointer;
+    char* end;
+
+    /// Initialize the arena.  No memory is allocated until the first allocation.
+    void init(Allocator backer = heap_allocator(), size_t first_block_size = 0x1000);
+    /// Deallocate all blocks.
+    void drop();
+
+    Allocator allocator() {
+        return {Chained_Arena::realloc, Chained_Arena::dealloc, this,
+                Chained_Arena::expand_in_place};
+    }
+
+    /// Deallocate all allocations.  Keeps all blocks for reuse.
+    void clear() { restore({nullptr, nullptr}); }
+
+    /// Give all blocks after the current block back to the `backer`.
+    void trim();
+
+    /// A save point allows you to instantly deallocate all allocations
+    /// made after `save` is called just by calling `restore`.
+    struct Save_Point {
+        Chained_Arena_Block* block;
+        char* pointer;
+    };
+    Save_Point save() const { return {current, pointer}; }
+    void restore(Save_Point sp);
+
+    static void* realloc(void* arena, MemSlice old_mem, AllocInfo new_info);
+    static void dealloc(void* arena, MemSlice old_mem);
+    /// Only the most recent allocation can be resized in place and
+    /// only while it fits in the current block.
+    static bool expand_in_place(void* arena, MemSlice old_mem, size_t new_size);
+};
+
+}
@@ -0,0 +1,208 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <thread>
+#include "allocator.hpp"
+#include "defer.hpp"
+#include "mutex.hpp"
+#include "str_map.hpp"
+#include "vector.hpp"
+
+namespace cz {
+
+/// A thread safe `Str_Map`.
+///
+/// Keys are split between `num_shards` independent shards by their hash.  Writers lock
+/// their shard's mutex.  Readers never lock; instead each shard has a sequence number
+/// that writers make odd while they modify the shard (a seqlock).  A reader records the
+/// sequence number, reads, and then retries if the sequence number changed.
+///
+/// When a shard grows its old table is kept around until `drop` so readers racing with
+/// the resize never read freed memory.  This wastes at most the size of the current table.
+///
+/// Values are copied out of the map so `Value` must be trivially copyable.  Keys are not
+/// copied so their memory must outlive the map.  Keys cannot be removed.
+///
+/// The `Allocator` passed to `insert` must be thread safe.
+///
+/// # Example
+///
+/// ```
+/// cz::Concurrent_Str_Map<int> map;
+/// map.init(cz::heap_allocator());
+/// CZ_DEFER(map.drop(cz::heap_allocator()));
+///
+/// map.insert_hash(cz::heap_allocator(), "abc", 42);
+///
+/// int value;
+/// CZ_ASSERT(map.get_hash("abc", &value));
+/// CZ_ASSERT(value == 42);
+/// ```
+template <class Value, class Hasher = Str_Hasher>
+struct Concurrent_Str_Map {
+    struct alignas(64) Shard {
+        Mutex mutex;
+        /// Odd while a writer is modifying `map`.
+        std::atomic<uint64_t> sequence;
+        Str_Map<Value, Hasher> map;
+        /// Tables replaced by growth.  Freed in `drop`.
+        Vector<Str_Map<Value, Hasher> > retired;
+    };
+
+    Shard* shards;
+    size_t num_shards;
+
+    /// `num_shards` must be a power of two.
+    void init(Allocator allocator, size_t num_shards = 64) {
+        CZ_ASSERT(num_shards > 0 && (num_shards & (num_shards - 1)) == 0);
+        this->num_shards = num_shards;
+        shards = allocator.alloc<Shard>(num_shards);
+        CZ_ASSERT(shards);
+        for (size_t i = 0; i < num_shards; ++i) {
+            new (&shards[i]) Shard;
+            shards[i].mutex.init();
+            shards[i].sequence.store(0);
+            shards[i].map = {};
+            shards[i].retired = {};
+        }
+    }
+
+    /// Deallocate all memory.  This is not thread safe.
+    void drop(Allocator allocator) {
+        for (size_t i = 0; i < num_shards; ++i) {
+            Shard* shard = &shards[i];
+            shard->map.drop(allocator);
+            for (size_t j = 0; j < shard->retired.len; ++j) {
+                shard->retired[j].drop(allocator);
+            }
+            shard->retired.drop(allocator);
+            shard->mutex.drop();
+            shard->~Shard();
+        }
+        allocator.dealloc(shards, num_shards);
+    }
+
+    static Hash hash(cz::Str key) { return Hasher()(key); }
+
+    /// `Str_Map` uses the bottom bits to pick a slot and the top 7 bits as
+    /// metadata so pick the shard using the bits in the middle.
+    Shard* shard_of(Hash hash) const { return &shards[(hash >> 32) & (num_shards - 1)]; }
+
+    bool get_hash(cz::Str key, Value* out) const { return get(key, hash(key), out); }
+
+    /// Look up `key` and copy its value into `out`.  Never blocks.
+    bool get(cz::Str key, Hash hash, Value* out) const {
+        const Shard* shard = shard_of(hash);
+        uint8_t tag = Str_Map<Value, Hasher>::metadata_tag(hash);
+
+    retry:
+        uint64_t sequence = shard->sequence.load(std::memory_order_acquire);
+        if (sequence & 1) {
+            std::this_thread::yield();
+            goto retry;
+        }
+
+        // Snapshot the table.  Validate it before following its pointers.
+        Str_Map<Value, Hasher> map = shard->map;
+        if (!validate(shard, sequence)) {
+            goto retry;
+        }
+
+        if (map.count == 0) {
+            return false;
+        }
+
+        size_t index = hash & (map.cap - 1);
+        for (size_t offset = 0; offset < map.count; ++offset) {
+            uint8_t metadata = map._metadata[index];
+            if (metadata == 0) {
+                break;
+            }
+
+            if (metadata == tag && map.hashes[index] == hash) {
+                // Copy the slot and validate it before comparing
+                // keys because a torn `Str` could point anywhere.
+                cz::Str candidate = map.keys[index];
+                Value value = map.values[index];
+                if (!validate(shard, sequence)) {
+                    goto retry;
+                }
+                if (candidate == key) {
+                    *out = value;
+                    return true;
+                }
+            }
+
+            ++index;
+            index &= map.cap - 1;
+        }
+
+        if (!validate(shard, sequence)) {
+            goto retry;
+        }
+        return false;
+    }
+
+    void insert_hash(Allocator allocator, cz::Str key, const Value& value) {
+        insert(allocator, key, hash(key), value);
+    }
+
+    /// Insert `key` or overwrite its value if it is already present.
+    void insert(Allocator allocator, cz::Str key, Hash hash, const Value& value) {
+        Shard* shard = shard_of(hash);
+        shard->mutex.lock();
+        CZ_DEFER(shard->mutex.unlock());
+
+        Value* existing = shard->map.get(key, hash);
+        if (existing) {
+            begin_write(shard);
+            *existing = value;
+            end_write(shard);
+            return;
+        }
+
+        Str_Map<Value, Hasher>& map = shard->map;
+        if (map.count + 1 + map.cap / 4 >= map.cap) {
+            // Build the new table while readers use the old one.
+            Str_Map<Value, Hasher> new_map = {};
+            new_map.reserve(allocator, 2 * (map.count + 1));
+            for (size_t i = 0; i < map.cap; ++i) {
+                if (map.is_present(i)) {
+                    new_map.insert(map.keys[i], map.hashes[i], map.values[i]);
+                }
+            }
+
+            if (map.cap != 0) {
+                shard->retired.reserve(allocator, 1);
+                shard->retired.push(map);
+            }
+
+            begin_write(shard);
+            map = new_map;
+            end_write(shard);
+        }
+
+        begin_write(shard);
+        map.insert(key, hash, value);
+        end_write(shard);
+    }
+
+    static bool validate(const Shard* shard, uint64_t sequence) {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return shard->sequence.load(std::memory_order_relaxed) == sequence;
+    }
+
+    static void begin_write(Shard* shard) {
+        uint64_t sequence = shard->sequence.load(std::memory_order_relaxed);
+        shard->sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    static void end_write(Shard* shard) {
+        uint64_t sequence = shard->sequence.load(std::memory_order_relaxed);
+        shard->sequence.store(sequence + 1, std::memory_order_release);
+    }
+};
+
+}
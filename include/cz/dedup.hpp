@@ -1,5 +1,6 @@
 #pragma once
 
+#include <stdint.h>
 #include <cz/slice.hpp>
 #include <cz/template_generic.hpp>
 #include <cz/vector.hpp>
@@ -38,13 +39,19 @@ cz::Slice<T> dedup(cz::Slice<T> slice, Is_Equal&& is_equal, Set&& set) {
 }
 template <class T, class Is_Equal>
 cz::Slice<T> dedup(cz::Slice<T> slice, Is_Equal&& is_equal) {
-    return dedup(slice.start(), slice.end(), is_equal, generic_set_ptr<T>);
+    return dedup(slice, is_equal, generic_set_ptr<T>);
 }
 template <class T>
 cz::Slice<T> dedup(cz::Slice<T> slice) {
-    return dedup(slice.start(), slice.end(), generic_is_equal_ptr<T>);
+    return dedup(slice, generic_is_equal_ptr<T>);
 }
 
+/// Faster versions for integers.  When compiled with SSE2 or AVX2 compares a block
+/// of elements against the elements before them at once and moves whole blocks
+/// without duplicates at once.
+cz::Slice<uint32_t> dedup(cz::Slice<uint32_t> slice);
+cz::Slice<uint64_t> dedup(cz::Slice<uint64_t> slice);
+
 template <class T, class Is_Equal, class Set>
 void dedup(cz::Slice<T>* slice, Is_Equal&& is_equal, Set&& set) {
     *slice = dedup(*slice, is_equal, set);
@@ -55,7 +62,7 @@ void dedup(cz::Slice<T>* slice, Is_Equal&& is_equal) {
 }
 template <class T>
 void dedup(cz::Slice<T>* slice) {
-    dedup(slice, generic_is_equal_ptr<T>);
+    *slice = dedup(*slice);
 }
 
 template <class T, class Is_Equal, class Set>
@@ -69,7 +76,7 @@ void dedup(cz::Vector<T>* vector, Is_Equal&& is_equal) {
 }
 template <class T>
 void dedup(cz::Vector<T>* vector) {
-    dedup(vector, generic_is_equal_ptr<T>);
+    vector->len = dedup(vector->as_slice()).len;
 }
 
 }
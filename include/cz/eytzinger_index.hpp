@@ -0,0 +1,136 @@
+#pragma once
+
+#include <stdint.h>
+#include "allocator.hpp"
+#include "assert.hpp"
+#include "binary_search.hpp"
+#include "slice.hpp"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace cz {
+
+namespace eytzinger_impl {
+
+/// Cache lines are assumed to be this big.
+constexpr const size_t cache_line_size = 64;
+
+/// The number of trailing one bits in `value`.  `value` must not be all ones.
+inline uint32_t trailing_ones(uint64_t value) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, ~value);
+    return index;
+#else
+    return __builtin_ctzll(~value);
+#endif
+}
+
+}
+
+/// A read only copy of a sorted slice laid out in breadth first order (the order
+/// used by a binary heap) so that repeated lookups are faster than `binary_search`.
+///
+/// The first few levels of the tree are packed into the same cache lines so they stay in
+/// cache between lookups.  The descendants of a node a few levels down are adjacent in
+/// memory so each step prefetches the cache line holding all of them (four levels down
+/// for 4 byte elements).
+///
+/// Lookups return indices into the original sorted slice so the index can be used
+/// in place of `binary_search`.  Building takes `O(n)` and the index uses
+/// `n * (sizeof(T) + sizeof(size_t))` bytes.
+///
+/// # Example
+///
+/// ```
+/// cz::Eytzinger_Index<int> index;
+/// index.init(cz::heap_allocator(), sorted);
+/// CZ_DEFER(index.drop(cz::heap_allocator()));
+///
+/// size_t i;
+/// if (index.find(3, &i)) {
+///     CZ_ASSERT(sorted[i] == 3);
+/// }
+/// ```
+template <class T>
+struct Eytzinger_Index {
+    /// The elements in breadth first order.  The root is at index `1`
+    /// and the children of `elems[i]` are `elems[2 * i]` and `elems[2 * i + 1]`.
+    T* elems;
+    /// `ranks[i]` is the index of `elems[i]` in the sorted slice.  `ranks[0]` is `len`.
+    size_t* ranks;
+    /// The number of elements.
+    size_t len;
+
+    /// Build the index from a sorted slice.  `sorted` is copied.
+    void init(Allocator allocator, cz::Slice<const T> sorted) {
+        len = sorted.len;
+
+        elems = (T*)allocator.alloc({sizeof(T) * (len + 1), eytzinger_impl::cache_line_size});
+        CZ_ASSERT(elems);
+        ranks = allocator.alloc<size_t>(len + 1);
+        CZ_ASSERT(ranks);
+
+        ranks[0] = len;
+        size_t next = fill(sorted, 0, 1);
+        CZ_DEBUG_ASSERT(next == len);
+        (void)next;
+    }
+
+    void drop(Allocator allocator) {
+        allocator.dealloc({elems, sizeof(T) * (len + 1)});
+        allocator.dealloc(ranks, len + 1);
+    }
+
+    /// Find the index in the sorted slice of the first element that is not
+    /// less than `element`.  Returns `len` if every element is less than `element`.
+    size_t lower_bound(const T& element) const { return ranks[lower_bound_node(element)]; }
+
+    /// Search for an element.  If an equivalent element is found then stores its index in
+    /// the sorted slice in `*index` and returns `true`.  Otherwise, stores in `*index`
+    /// where it would reside if inserted to keep the slice in order and returns `false`.
+    bool find(const T& element, size_t* index) const {
+        size_t node = lower_bound_node(element);
+        *index = ranks[node];
+        return node != 0 && elems[node] == element;
+    }
+
+    bool find(const T& element) const {
+        size_t index;
+        return find(element, &index);
+    }
+
+private:
+    /// The node of the first element not less than `element` or `0` if there isn't one.
+    size_t lower_bound_node(const T& element) const {
+        constexpr const size_t per_line =
+            sizeof(T) >= eytzinger_impl::cache_line_size
+                ? 1
+                : eytzinger_impl::cache_line_size / sizeof(T);
+        size_t node = 1;
+        while (node <= len) {
+            binary_search_impl::prefetch(elems + node * per_line);
+            node = 2 * node + (elems[node] < element);
+        }
+        // Each time we went right we skipped an element that was too small.  Undo the
+        // right turns at the bottom of the path and the last left turn is the answer.
+        return node >> (eytzinger_impl::trailing_ones(node) + 1);
+    }
+
+    /// Fill in the subtree rooted at `node` with the elements starting at `sorted[next]`.
+    /// Returns the index of the first element in `sorted` that wasn't used.
+    size_t fill(cz::Slice<const T> sorted, size_t next, size_t node) {
+        if (node <= len) {
+            next = fill(sorted, next, 2 * node);
+            elems[node] = sorted[next];
+            ranks[node] = next;
+            ++next;
+            next = fill(sorted, next, 2 * node + 1);
+        }
+        return next;
+    }
+};
+
+}
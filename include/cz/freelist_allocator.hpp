@@ -1,5 +1,7 @@
 #pragma once
 
+#include <stdint.h>
+#include <atomic>
 #include <cz/heap.hpp>
 
 namespace cz {
@@ -25,7 +27,7 @@ struct Freelist {
     Allocator backer;
 
     // Methods
-    Allocator allocator() { return {realloc, dealloc, this}; }
+    Allocator allocator() { return {realloc, dealloc, this, nullptr}; }
     void drop() { common.drop(backer); }
 
 private:
@@ -42,11 +44,77 @@ struct Freelist_Heap {
     Freelist_Common common;
 
     // Methods
-    Allocator allocator() { return {realloc, Freelist::dealloc, this}; }
+    Allocator allocator() { return {realloc, Freelist::dealloc, this, nullptr}; }
     void drop() { common.drop(heap_allocator()); }
 
 private:
     static void* realloc(void* freelist, MemSlice old_mem, AllocInfo new_info);
 };
 
+/// An allocator that holds onto freed allocations of any size and reuses them.
+///
+/// Allocations are rounded up to a power of two size class (minimum `min_size`) and
+/// each size class keeps its own list of freed allocations.  Reallocating within a
+/// size class is done in place; otherwise the allocation moves to the new class.
+/// Allocations larger than `max_size` are passed directly to the `backer`.
+///
+/// Each size class caches at most `max_cached_bytes` bytes; further deallocations are
+/// returned to the `backer`.  If the `backer` fails to allocate then all cached memory
+/// is released and the allocation is retried.  Use `trim` to release cached memory manually.
+///
+/// All allocations must have an alignment of at most `alignof(max_align_t)`.
+struct Freelist_Buckets {
+    static constexpr const size_t min_size = 16;
+    static constexpr const size_t max_classes = 32;
+
+    Allocator backer;
+    size_t max_size;
+    size_t max_cached_bytes;
+
+    Freelist_Node* heads[max_classes];
+    size_t cached_bytes[max_classes];
+
+    /// `max_size` must be a power of two.
+    void init(Allocator backer = heap_allocator(),
+              size_t max_size = 0x10000,
+              size_t max_cached_bytes = 0x100000);
+    void drop() { trim(); }
+
+    Allocator allocator() { return {realloc, dealloc, this, nullptr}; }
+
+    /// Give all cached memory back to the `backer`.
+    void trim();
+
+    /// The size class an allocation of `size` bytes belongs to.  `size` must be at most `max_size`.
+    static size_t size_class(size_t size);
+    static size_t class_size(size_t size_class) { return min_size << size_class; }
+
+private:
+    static void* realloc(void* freelist, MemSlice old_mem, AllocInfo new_info);
+    static void dealloc(void* freelist, MemSlice old_mem);
+};
+
+/// A thread safe version of `Freelist`.  Memory can be allocated on one thread and
+/// deallocated on another.  Freed elements are kept in a lock free stack.
+///
+/// Every allocation takes `size` bytes so allocations must be at most `size` bytes.
+/// The `backer` must be thread safe as it is called when the stack is empty.
+struct Concurrent_Freelist {
+    /// The top of the stack and a counter to prevent the ABA problem.  See `pack`.
+    std::atomic<uint64_t> head;
+
+    Allocator backer;
+    size_t size;
+
+    void init(Allocator backer, size_t size);
+    /// Deallocate all cached elements.  This is not thread safe.
+    void drop();
+
+    Allocator allocator() { return {realloc, dealloc, this, nullptr}; }
+
+private:
+    static void* realloc(void* freelist, MemSlice old_mem, AllocInfo new_info);
+    static void dealloc(void* freelist, MemSlice old_mem);
+};
+
 }
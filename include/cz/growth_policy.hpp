@@ -0,0 +1,44 @@
+#pragma once
+
+#include <stddef.h>
+
+namespace cz {
+
+/// Decides the capacity a dynamic array grows to when it runs out of space.  `cap`
+/// is the current capacity, `total` is the minimum capacity needed, and `elem_size`
+/// is the size of each element in bytes.  Must return a value `>= total`.
+///
+/// Pass a policy to `Vector::reserve` to override the default.
+///
+/// # Example
+///
+/// ```
+/// cz::Vector<Point> points = {};
+/// CZ_DEFER(points.drop(cz::heap_allocator()));
+///
+/// // Grow slower to waste less memory.
+/// points.reserve(cz::heap_allocator(), 1, cz::grow_one_and_a_half);
+/// ```
+using Growth_Policy = size_t (*)(size_t cap, size_t total, size_t elem_size);
+
+/// Round up to the next power of two with a minimum of 8 elements.
+/// Wastes up to half of the buffer but grows in the fewest steps.
+size_t grow_power_of_two(size_t cap, size_t total, size_t elem_size);
+
+/// Grow by 1.5x with a minimum of 8 elements.  Wastes up to a third of the buffer.
+size_t grow_one_and_a_half(size_t cap, size_t total, size_t elem_size);
+
+/// Buffers bigger than this many bytes are grown in whole pages by `grow_page_granular`.
+constexpr const size_t growth_page_threshold = (size_t)1 << 20;
+constexpr const size_t growth_page_size = 4096;
+
+/// Use `grow_power_of_two` for small buffers.  Once the buffer is bigger than
+/// `growth_page_threshold` bytes, grow by 1.5x rounded up to a whole number of
+/// pages so huge buffers don't waste up to half their memory and the allocator
+/// can map the new pages instead of finding space for a buffer twice the size.
+size_t grow_page_granular(size_t cap, size_t total, size_t elem_size);
+
+/// The policy used by `Vector::reserve` when one isn't specified.
+constexpr const Growth_Policy default_growth_policy = grow_page_granular;
+
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <stddef.h>
 #include <stdint.h>
 #include <cz/str.hpp>
 
@@ -7,7 +8,11 @@ namespace cz {
 
 using Hash = uint64_t;
 
-inline Hash hash(cz::Str str, Hash base) {
+/// Hash a string.  Processes 8 bytes at a time (this is XXH64).
+Hash hash(cz::Str str, Hash seed);
+
+/// The old hash function that processes one byte at a time.  Kept for comparisons.
+inline Hash hash_multiply_31(cz::Str str, Hash base) {
     for (size_t i = 0; i < str.len; ++i) {
         base *= 31;
         base += str[i];
@@ -15,4 +20,47 @@ inline Hash hash(cz::Str str, Hash base) {
     return base;
 }
 
+/// Incrementally hash a string.  Feeding a string in pieces
+/// gives the same result as calling `hash` on the whole string.
+///
+/// ```
+/// cz::Hash_Stream stream;
+/// stream.init(seed);
+/// stream.update("hello ");
+/// stream.update("world");
+/// CZ_ASSERT(stream.finish() == cz::hash("hello world", seed));
+/// ```
+struct Hash_Stream {
+    uint64_t accumulators[4];
+    uint64_t total_len;
+    unsigned char buffer[32];
+    size_t buffer_len;
+    Hash seed;
+
+    void init(Hash seed);
+    void update(cz::Str str);
+    Hash finish() const;
+};
+
+/// The default hasher for `Str_Map`, `Str_Set`, and `Str_Map_Removable`.
+struct Str_Hasher {
+    Hash operator()(cz::Str str) const { return hash(str, 0x7521AB297521AB29); }
+};
+
+/// A hasher that uses `hash_multiply_31`.  This was the hasher used before `Str_Hasher`.
+struct Str_Hasher_Multiply_31 {
+    Hash operator()(cz::Str str) const { return hash_multiply_31(str, 0x7521AB297521AB29); }
+};
+
+/// Mix the bits of an integer so every bit of the result depends on every bit of `value`.
+inline Hash hash_integer(uint64_t value) {
+    // The finalizer from MurmurHash3.
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdull;
+    value ^= value >> 33;
+    value *= 0xc4ceb9fe1a85ec53ull;
+    value ^= value >> 33;
+    return value;
+}
+
 }
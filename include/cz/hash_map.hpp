@@ -0,0 +1,295 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <cz/allocator.hpp>
+#include <cz/str.hpp>
+#include "assert.hpp"
+#include "hash.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CZ_HASH_MAP_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace cz {
+
+/// The default hasher used by `Hash_Map`.  Works for integers and enums.
+/// Specialize this or pass a different `Hasher` to `Hash_Map` to use other keys.
+template <class T>
+struct Hasher {
+    Hash operator()(const T& key) const { return hash_integer((uint64_t)key); }
+};
+
+template <class T>
+struct Hasher<T*> {
+    Hash operator()(T* key) const { return hash_integer((uint64_t)(uintptr_t)key); }
+};
+
+template <>
+struct Hasher<Str> : Str_Hasher {};
+
+namespace hash_map_impl {
+
+/// The states of a slot.  Present slots store the bottom 7 bits of the hash instead.
+constexpr const uint8_t ctrl_empty = 0x80;
+constexpr const uint8_t ctrl_deleted = 0xFE;
+
+/// The index of the lowest set bit.  `mask` must not be 0.
+inline uint32_t lowest_bit(uint32_t mask) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+/// The index of the highest set bit.  `mask` must not be 0.
+inline uint32_t highest_bit(uint32_t mask) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse(&index, mask);
+    return index;
+#else
+    return 31 - __builtin_clz(mask);
+#endif
+}
+
+/// A group of control bytes that are probed at the same time.
+/// Each method returns a mask with bit `i` set if control byte `i` matches.
+struct Group {
+    static constexpr const size_t width = 16;
+
+#ifdef CZ_HASH_MAP_SSE2
+    __m128i ctrl;
+
+    explicit Group(const uint8_t* pos) : ctrl(_mm_loadu_si128((const __m128i*)pos)) {}
+
+    uint32_t match(uint8_t byte) const {
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8((char)byte), ctrl));
+    }
+
+    /// Empty and deleted are the only states with the top bit set.
+    uint32_t match_empty_or_deleted() const { return _mm_movemask_epi8(ctrl); }
+#else
+    uint8_t ctrl[width];
+
+    explicit Group(const uint8_t* pos) { memcpy(ctrl, pos, width); }
+
+    uint32_t match(uint8_t byte) const {
+        uint32_t mask = 0;
+        for (size_t i = 0; i < width; ++i) {
+            mask |= (uint32_t)(ctrl[i] == byte) << i;
+        }
+        return mask;
+    }
+
+    uint32_t match_empty_or_deleted() const {
+        uint32_t mask = 0;
+        for (size_t i = 0; i < width; ++i) {
+            mask |= (uint32_t)(ctrl[i] >> 7) << i;
+        }
+        return mask;
+    }
+#endif
+
+    uint32_t match_empty() const { return match(ctrl_empty); }
+};
+
+}
+
+/// An open addressing hash table mapping `Key`s to `Value`s.
+///
+/// Each slot has a control byte storing whether it is empty, deleted, or present.
+/// Present slots store 7 bits of the key's hash so most mismatches are rejected
+/// without looking at the key.  Lookups compare 16 control bytes at a time (using
+/// SSE2 when available) and stop at the first group with an empty slot.
+///
+/// Removing a key only leaves a tombstone if the slot is in the middle of a run of 16
+/// or more occupied slots, as otherwise no probe could have passed over it.
+///
+/// Keys and values are copied around as plain data.  `Key` must support `==`.
+///
+/// # Example
+///
+/// ```
+/// cz::Hash_Map<uint64_t, int> map = {};
+/// CZ_DEFER(map.drop(cz::heap_allocator()));
+///
+/// map.reserve(cz::heap_allocator(), 1);
+/// map.insert(7, 42);
+/// CZ_ASSERT(*map.get(7) == 42);
+/// ```
+template <class Key, class Value, class Hasher = cz::Hasher<Key> >
+struct Hash_Map {
+    /// `cap + Group::width` control bytes.  The last `Group::width`
+    /// mirror the first so a group can be loaded starting at any slot.
+    uint8_t* ctrl;
+    Key* keys;
+    Value* values;
+    size_t cap;
+    size_t count;
+    size_t tombstones;
+
+    using Group = hash_map_impl::Group;
+
+    void drop(Allocator allocator) {
+        if (cap == 0) {
+            return;
+        }
+        allocator.dealloc(ctrl, cap + Group::width);
+        allocator.dealloc(keys, cap);
+        allocator.dealloc(values, cap);
+    }
+
+    /// The maximum number of present and deleted slots in a table with `cap` slots.
+    static size_t max_load(size_t cap) { return cap - cap / 8; }
+
+    /// Ensure there are `extra` spaces available.  Amortizing expansion.
+    /// Also purges tombstones if there are too many.
+    void reserve(Allocator allocator, size_t extra) {
+        if (count + tombstones + extra <= max_load(cap)) {
+            return;
+        }
+
+        // Leave a quarter of the load free so tombstones can't
+        // cause us to rehash at the same size on every insertion.
+        size_t new_cap = (cap == 0 ? Group::width : cap);
+        while (max_load(new_cap) / 4 * 3 < count + extra) {
+            new_cap *= 2;
+        }
+
+        Hash_Map new_this;
+        new_this.cap = new_cap;
+        new_this.count = 0;
+        new_this.tombstones = 0;
+        new_this.ctrl = allocator.alloc<uint8_t>(new_cap + Group::width);
+        new_this.keys = allocator.alloc<Key>(new_cap);
+        new_this.values = allocator.alloc<Value>(new_cap);
+        CZ_ASSERT(new_this.ctrl);
+        CZ_ASSERT(new_this.keys);
+        CZ_ASSERT(new_this.values);
+        memset(new_this.ctrl, hash_map_impl::ctrl_empty, new_cap + Group::width);
+
+        for (size_t i = 0; i < cap; ++i) {
+            if (is_present(i)) {
+                new_this.insert(keys[i], hash(keys[i]), values[i]);
+            }
+        }
+
+        drop(allocator);
+        *this = new_this;
+    }
+
+    bool is_present(size_t index) const { return (ctrl[index] & 0x80) == 0; }
+
+    static Hash hash(const Key& key) { return Hasher()(key); }
+
+    /// Find the slot containing `key`.
+    bool index_of(const Key& key, Hash hash, size_t* out) const {
+        if (count == 0) {
+            return false;
+        }
+
+        size_t mask = cap - 1;
+        size_t pos = (hash >> 7) & mask;
+        uint8_t h2 = hash & 0x7F;
+        for (size_t probed = 0; probed < cap; probed += Group::width) {
+            Group group(ctrl + pos);
+            for (uint32_t matches = group.match(h2); matches; matches &= matches - 1) {
+                size_t index = (pos + hash_map_impl::lowest_bit(matches)) & mask;
+                if (keys[index] == key) {
+                    *out = index;
+                    return true;
+                }
+            }
+            if (group.match_empty()) {
+                return false;
+            }
+            pos = (pos + Group::width) & mask;
+        }
+        return false;
+    }
+
+    Value* get(const Key& key) { return get(key, hash(key)); }
+
+    Value* get(const Key& key, Hash hash) {
+        size_t index;
+        if (index_of(key, hash, &index)) {
+            return &values[index];
+        } else {
+            return nullptr;
+        }
+    }
+
+    /// Insert a key that is not in the map.  Must `reserve` space first.
+    void insert(const Key& key, const Value& value) { insert(key, hash(key), value); }
+
+    void insert(const Key& key, Hash hash, const Value& value) {
+        CZ_DEBUG_ASSERT(count + tombstones < max_load(cap));
+
+        size_t mask = cap - 1;
+        size_t pos = (hash >> 7) & mask;
+        while (1) {
+            uint32_t available = Group(ctrl + pos).match_empty_or_deleted();
+            if (available) {
+                size_t index = (pos + hash_map_impl::lowest_bit(available)) & mask;
+                if (ctrl[index] == hash_map_impl::ctrl_deleted) {
+                    --tombstones;
+                }
+                set_ctrl(index, hash & 0x7F);
+                keys[index] = key;
+                values[index] = value;
+                ++count;
+                return;
+            }
+            pos = (pos + Group::width) & mask;
+        }
+    }
+
+    bool remove(const Key& key) { return remove(key, hash(key)); }
+
+    bool remove(const Key& key, Hash hash) {
+        size_t index;
+        if (!index_of(key, hash, &index)) {
+            return false;
+        }
+
+        // Count the occupied slots directly before and after `index`.  If
+        // they make a run shorter than a group then every probe passing
+        // through `index` also saw an empty slot and stopped there.
+        size_t mask = cap - 1;
+        uint32_t empty_before = Group(ctrl + ((index - Group::width) & mask)).match_empty();
+        uint32_t empty_after = Group(ctrl + index).match_empty();
+        bool in_long_run = true;
+        if (empty_before && empty_after) {
+            size_t run_before = Group::width - 1 - hash_map_impl::highest_bit(empty_before);
+            size_t run_after = hash_map_impl::lowest_bit(empty_after);
+            in_long_run = run_before + run_after >= Group::width;
+        }
+
+        if (in_long_run) {
+            set_ctrl(index, hash_map_impl::ctrl_deleted);
+            ++tombstones;
+        } else {
+            set_ctrl(index, hash_map_impl::ctrl_empty);
+        }
+        --count;
+        return true;
+    }
+
+    void set_ctrl(size_t index, uint8_t byte) {
+        ctrl[index] = byte;
+        if (index < Group::width) {
+            ctrl[cap + index] = byte;
+        }
+    }
+};
+
+}
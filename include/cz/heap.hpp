@@ -13,7 +13,22 @@
 
 namespace cz {
 
+/// Allocate or reallocate memory with `new_info.alignment > alignof(max_align_t)`.
+/// Contents are preserved as described by `Allocator::reallocate`.
+void* heap_allocator_realloc_aligned(MemSlice old_mem, AllocInfo new_info);
+
+#ifdef _WIN32
+// Windows requires memory from `_aligned_malloc` to be freed via `_aligned_free`.  Deallocation
+// doesn't know the alignment so all heap allocations go through `_aligned_realloc`.
+void* heap_allocator_realloc(void*, MemSlice old_mem, AllocInfo new_info);
+void heap_allocator_dealloc(void*, MemSlice old_mem);
+#else
 inline void* heap_allocator_realloc(void*, MemSlice old_mem, AllocInfo new_info) {
+    // Over-aligned allocations can't use `std::realloc`.
+    if (new_info.alignment > alignof(max_align_t)) {
+        return heap_allocator_realloc_aligned(old_mem, new_info);
+    }
+
     // Since it is undefined what happens when `std::realloc` is
     // called with `size = 0` we just always allocate 1 byte.
     if (new_info.size == 0) {
@@ -21,7 +36,6 @@ inline void* heap_allocator_realloc(void*, MemSlice old_mem, AllocInfo new_info)
     }
 
     // Allocation or reallocation.
-    CZ_DEBUG_ASSERT(new_info.alignment <= alignof(max_align_t));
     void* ptr = realloc(old_mem.buffer, new_info.size);
     if (ptr) {
         TracyFree(old_mem.buffer);
@@ -31,13 +45,20 @@ inline void* heap_allocator_realloc(void*, MemSlice old_mem, AllocInfo new_info)
 }
 
 inline void heap_allocator_dealloc(void*, MemSlice old_mem) {
+    // Note: `free` also handles memory allocated by `posix_memalign`.
     free(old_mem.buffer);
     TracyFree(old_mem.buffer);
 }
+#endif
 
 /// Make an allocator that allocates memory in the heap.
+///
+/// Any power of two alignment is supported.  Alignments up to `alignof(max_align_t)`
+/// use `std::realloc` and larger alignments (ex. cache lines or pages) use the
+/// platform's aligned allocation functions.  On Windows, reallocating
+/// with a different alignment than the memory was allocated with is not supported.
 inline Allocator heap_allocator() {
-    return {heap_allocator_realloc, heap_allocator_dealloc, nullptr};
+    return {heap_allocator_realloc, heap_allocator_dealloc, nullptr, nullptr};
 }
 
 }
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include "buffer_array.hpp"
+#include "concurrent_str_map.hpp"
+#include "mutex.hpp"
+#include "str.hpp"
+#include "str_map.hpp"
+#include "vector.hpp"
+
+namespace cz {
+
+/// Deduplicates strings and assigns each distinct string a dense 32 bit id.
+///
+/// Interned strings are copied into a `Buffer_Array` so they stay at the same address until
+/// `drop` is called.  Ids start at `0` and count up so they can be used to index arrays.
+/// Two interned strings are equal if and only if their ids are equal.
+///
+/// # Example
+///
+/// ```
+/// cz::Intern_Table table;
+/// table.init();
+/// CZ_DEFER(table.drop());
+///
+/// uint32_t a = table.intern("hello");
+/// uint32_t b = table.intern("hello");
+/// CZ_ASSERT(a == b);
+/// CZ_ASSERT(table.get(a) == "hello");
+/// ```
+struct Intern_Table {
+    /// Storage for the interned strings.
+    Buffer_Array storage;
+    /// Map from an interned string to its id.
+    Str_Map<uint32_t> ids;
+    /// Map from an id to its interned string.
+    Vector<Str> strings;
+
+    void init();
+    void drop();
+
+    /// Get the id of `str`, interning it if it hasn't been seen before.
+    uint32_t intern(Str str);
+
+    /// Get the id of `str` if it has already been interned.
+    bool find(Str str, uint32_t* id);
+
+    /// Get the string with the given id.
+    Str get(uint32_t id) const { return strings[id]; }
+
+    size_t count() const { return strings.len; }
+};
+
+/// A thread safe `Intern_Table`.
+///
+/// Looking up existing strings (`intern` on a string that has already been interned,
+/// `find`, and `get`) never locks.  Interning a new string takes a global lock.
+///
+/// Ids are mapped to strings through chunks that double in size so
+/// growing never moves existing strings and `get` is always lock free.
+struct Concurrent_Intern_Table {
+    static constexpr const size_t first_chunk_size = 1024;
+    static constexpr const size_t max_chunks = 23;
+
+    /// Protects `storage` and `count` and serializes inserting into `ids`.
+    Mutex mutex;
+    Buffer_Array storage;
+    Concurrent_Str_Map<uint32_t> ids;
+    /// Chunk `i` stores the strings with ids starting at `first_chunk_size * (2^i - 1)`.
+    std::atomic<Str*> chunks[max_chunks];
+    std::atomic<uint32_t> _count;
+
+    void init();
+    void drop();
+
+    /// Get the id of `str`, interning it if it hasn't been seen before.
+    uint32_t intern(Str str);
+
+    /// Get the id of `str` if it has already been interned.
+    bool find(Str str, uint32_t* id) const { return ids.get_hash(str, id); }
+
+    /// Get the string with the given id.  `id` must have been returned by `intern` or `find`.
+    Str get(uint32_t id) const;
+
+    size_t count() const { return _count.load(std::memory_order_acquire); }
+
+    /// The chunk containing `id` and the index of `id` in that chunk.
+    static size_t chunk_of(uint32_t id, size_t* offset);
+};
+
+}
@@ -13,7 +13,7 @@ inline void panic_allocator_dealloc(void*, MemSlice old_mem) {
 }
 
 inline Allocator panic_allocator() {
-    return {panic_allocator_realloc, panic_allocator_dealloc, nullptr};
+    return {panic_allocator_realloc, panic_allocator_dealloc, nullptr, nullptr};
 }
 
 }
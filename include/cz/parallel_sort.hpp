@@ -0,0 +1,149 @@
+#pragma once
+
+#include <thread>
+#include "sort.hpp"
+
+namespace cz {
+
+namespace sort_impl {
+
+/// Below this size don't bother starting another thread.
+constexpr const size_t parallel_sort_threshold = 1 << 15;
+
+/// `pdqsort` that hands one side of each partition to a new thread
+/// while it has threads to spare.  `num_threads` includes this thread.
+template <class Iterator, class Is_Less, class Swap>
+void parallel_pdqsort(Iterator start,
+                      Iterator end,
+                      Is_Less& is_less,
+                      Swap& swap,
+                      size_t bad_allowed,
+                      bool leftmost,
+                      size_t num_threads) {
+    while (1) {
+        size_t size = end - start;
+
+        if (num_threads <= 1 || size < parallel_sort_threshold) {
+            pdqsort(start, end, is_less, swap, bad_allowed, leftmost);
+            return;
+        }
+
+        choose_pivot(start, end, is_less, swap);
+
+        if (!leftmost && !is_less(start - 1, start)) {
+            start = partition_left(start, end, is_less, swap) + 1;
+            continue;
+        }
+
+        bool already_partitioned;
+        Iterator pivot = partition_right(start, end, is_less, swap, &already_partitioned);
+
+        size_t left_size = pivot - start;
+        size_t right_size = end - (pivot + 1);
+        bool highly_unbalanced = left_size < size / 8 || right_size < size / 8;
+
+        if (highly_unbalanced) {
+            if (--bad_allowed == 0) {
+                generic_heap_sort(start, end, is_less, swap);
+                return;
+            }
+            break_patterns(start, pivot, end, swap);
+        } else {
+            if (already_partitioned && partial_insertion_sort(start, pivot, is_less, swap) &&
+                partial_insertion_sort(pivot + 1, end, is_less, swap)) {
+                return;
+            }
+        }
+
+        // Split the threads between the sides in proportion to their sizes.
+        size_t left_threads = (size_t)((double)num_threads * left_size / size + 0.5);
+        if (left_threads > num_threads - 1) {
+            left_threads = num_threads - 1;
+        }
+
+        // Only start a thread when both sides are worth sorting in parallel.  Otherwise a
+        // skewed partition would spend a thread on almost no work and take it away from
+        // the larger side.
+        if (left_threads >= 1 && left_size >= parallel_sort_threshold &&
+            right_size >= parallel_sort_threshold) {
+            // Sort the left side on a new thread and keep going on the right side.
+            std::thread thread([&, start, pivot, bad_allowed, leftmost, left_threads]() {
+                parallel_pdqsort(start, pivot, is_less, swap, bad_allowed, leftmost,
+                                 left_threads);
+            });
+            parallel_pdqsort(pivot + 1, end, is_less, swap, bad_allowed, false,
+                             num_threads - left_threads);
+            thread.join();
+            return;
+        }
+
+        // Recurse into the smaller side and loop on the larger side with all the threads.
+        if (left_size < right_size) {
+            parallel_pdqsort(start, pivot, is_less, swap, bad_allowed, leftmost, num_threads);
+            start = pivot + 1;
+            leftmost = false;
+        } else {
+            parallel_pdqsort(pivot + 1, end, is_less, swap, bad_allowed, false, num_threads);
+            end = pivot;
+        }
+    }
+}
+
+}
+
+/// Sort the range using up to `num_threads` threads (including the calling thread).
+/// If `num_threads` is `0` then uses one thread per core.
+///
+/// Each partition step of `generic_sort` hands one side to a new thread until every
+/// thread has a range to sort.  A side is only handed off if both sides have at least
+/// `sort_impl::parallel_sort_threshold` elements so small inputs and skewed partitions
+/// are sorted on the current thread like `generic_sort`.
+/// The first partition is done on a single thread so speedup is sublinear.
+///
+/// `is_less` and `swap` are shared between the threads so they must be thread safe.
+template <class Iterator, class Is_Less, class Swap>
+void generic_parallel_sort(Iterator start,
+                           Iterator end,
+                           Is_Less&& is_less,
+                           Swap&& swap,
+                           size_t num_threads = 0) {
+    size_t size = end - start;
+    if (size < 2) {
+        return;
+    }
+
+    if (num_threads == 0) {
+        num_threads = std::thread::hardware_concurrency();
+    }
+
+    sort_impl::parallel_pdqsort(start, end, is_less, swap, sort_impl::bad_allowed(size), true,
+                                num_threads);
+}
+
+template <class T, class Is_Less, class Swap>
+void parallel_sort(cz::Slice<T> slice, Is_Less&& is_less, Swap&& swap) {
+    generic_parallel_sort(slice.start(), slice.end(), is_less, swap);
+}
+template <class T, class Is_Less>
+void parallel_sort(cz::Slice<T> slice, Is_Less&& is_less) {
+    parallel_sort(slice, is_less, sort_impl::Swap_Ptr<T>());
+}
+template <class T>
+void parallel_sort(cz::Slice<T> slice) {
+    parallel_sort(slice, sort_impl::Is_Less_Ptr<T>());
+}
+
+template <class T, class Is_Less, class Swap>
+void parallel_sort(cz::Vector<T> vector, Is_Less&& is_less, Swap&& swap) {
+    parallel_sort(vector.as_slice(), is_less, swap);
+}
+template <class T, class Is_Less>
+void parallel_sort(cz::Vector<T> vector, Is_Less&& is_less) {
+    parallel_sort(vector.as_slice(), is_less);
+}
+template <class T>
+void parallel_sort(cz::Vector<T> vector) {
+    parallel_sort(vector.as_slice());
+}
+
+}
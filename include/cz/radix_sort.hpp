@@ -0,0 +1,140 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+#include "allocator.hpp"
+#include "defer.hpp"
+#include "slice.hpp"
+#include "sort.hpp"
+#include "str.hpp"
+
+namespace cz {
+
+namespace radix_impl {
+
+/// Below this size use insertion sort.
+constexpr const size_t radix_sort_threshold = 64;
+
+/// Map a key to an unsigned integer with the same ordering.
+template <class T>
+typename std::enable_if<std::is_unsigned<T>::value, T>::type radix_key(T key) {
+    return key;
+}
+
+/// Flip the sign bit so negative numbers come first.
+template <class T>
+typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value,
+                        typename std::make_unsigned<T>::type>::type
+radix_key(T key) {
+    using Unsigned = typename std::make_unsigned<T>::type;
+    return (Unsigned)key ^ ((Unsigned)1 << (sizeof(T) * 8 - 1));
+}
+
+/// Flip every bit of negative numbers so they sort in reverse and flip
+/// the sign bit of positive numbers so they come after negative numbers.
+inline uint32_t radix_key(float key) {
+    uint32_t bits;
+    memcpy(&bits, &key, sizeof(bits));
+    return (bits & 0x80000000) ? ~bits : (bits | 0x80000000);
+}
+inline uint64_t radix_key(double key) {
+    uint64_t bits;
+    memcpy(&bits, &key, sizeof(bits));
+    return (bits & 0x8000000000000000) ? ~bits : (bits | 0x8000000000000000);
+}
+
+/// Sort `elems` by one byte of the key at a time starting at the least significant byte.
+/// Elements are moved back and forth between `elems` and `scratch`.
+template <class T, class Key_Of>
+void lsd_radix_sort(T* elems, T* scratch, size_t len, Key_Of& key_of) {
+    using Key = decltype(radix_key(key_of(*elems)));
+    constexpr const size_t num_digits = sizeof(Key);
+
+    // Count every digit in one pass over the input.
+    size_t counts[num_digits][256] = {};
+    for (size_t i = 0; i < len; ++i) {
+        Key key = radix_key(key_of(elems[i]));
+        for (size_t digit = 0; digit < num_digits; ++digit) {
+            ++counts[digit][(key >> (8 * digit)) & 0xFF];
+        }
+    }
+
+    T* from = elems;
+    T* to = scratch;
+    for (size_t digit = 0; digit < num_digits; ++digit) {
+        size_t* digit_counts = counts[digit];
+
+        // Skip digits that are the same for every element.
+        Key first = radix_key(key_of(from[0]));
+        if (digit_counts[(first >> (8 * digit)) & 0xFF] == len) {
+            continue;
+        }
+
+        size_t offsets[256];
+        size_t offset = 0;
+        for (size_t bucket = 0; bucket < 256; ++bucket) {
+            offsets[bucket] = offset;
+            offset += digit_counts[bucket];
+        }
+
+        for (size_t i = 0; i < len; ++i) {
+            Key key = radix_key(key_of(from[i]));
+            memcpy(&to[offsets[(key >> (8 * digit)) & 0xFF]++], &from[i], sizeof(T));
+        }
+
+        T* temp = from;
+        from = to;
+        to = temp;
+    }
+
+    if (from != elems) {
+        memcpy(elems, from, sizeof(T) * len);
+    }
+}
+
+}
+
+/// Sort `slice` by the key returned by `key_of(const T&)`.  The key can be any integer
+/// or floating point type.  Floating point keys are sorted by their bits so negative
+/// zero comes before zero and NaNs are placed at the ends.
+///
+/// Uses a least significant digit radix sort one byte at a time so it runs in
+/// `O(n * sizeof(key))`.  Bytes that are the same for every key are skipped.
+/// `scratch` is used to allocate a temporary copy of `slice`.  Stable.
+///
+/// `T` is moved by copying its bytes so it must be trivially copyable.
+template <class T, class Key_Of>
+void radix_sort(Allocator scratch, cz::Slice<T> slice, Key_Of&& key_of) {
+    static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+
+    if (slice.len < radix_impl::radix_sort_threshold) {
+        generic_insertion_sort(
+            slice.start(), slice.end(),
+            [&](T* left, T* right) {
+                return radix_impl::radix_key(key_of(*left)) < radix_impl::radix_key(key_of(*right));
+            },
+            generic_swap_ptr<T>);
+        return;
+    }
+
+    T* buffer = scratch.alloc<T>(slice.len);
+    CZ_ASSERT(buffer);
+    CZ_DEFER(scratch.dealloc(buffer, slice.len));
+    radix_impl::lsd_radix_sort(slice.elems, buffer, slice.len, key_of);
+}
+
+/// Sort a slice of integers or floating point numbers.  See above.
+template <class T>
+void radix_sort(Allocator scratch, cz::Slice<T> slice) {
+    radix_sort(scratch, slice, [](const T& elem) { return elem; });
+}
+
+/// Sort strings by their bytes (as `unsigned char`s) in the same order as `Str::operator<`.
+///
+/// Uses a most significant digit radix sort that buckets strings by the byte at the current
+/// depth and then sorts each bucket by the next byte.  `scratch` is used to allocate a
+/// temporary copy of `slice`.  Stable.
+void radix_sort(Allocator scratch, cz::Slice<cz::Str> slice);
+
+}
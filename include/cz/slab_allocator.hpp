@@ -0,0 +1,107 @@
+#pragma once
+
+#include <stddef.h>
+#include <atomic>
+#include "allocator.hpp"
+#include "heap.hpp"
+#include "mutex.hpp"
+
+namespace cz {
+
+struct Slab_Thread_Cache;
+
+struct Slab_Node {
+    /// The next node in this batch.
+    Slab_Node* next;
+    /// The next batch.  Only used for the first node in each batch in the depot.
+    Slab_Node* next_batch;
+};
+
+/// A thread safe allocator optimized for many small allocations.
+///
+/// Allocations are rounded up to one of `num_size_classes` size classes.  Each thread keeps
+/// a cache of free objects per size class so allocating and deallocating doesn't take any
+/// locks in the common case.  When a thread's cache is empty it takes a batch of objects
+/// from the central depot and when the cache overflows it gives a batch back.
+///
+/// Objects are carved out of `chunk_size` byte chunks allocated via the `backer`.  Chunks are
+/// only returned to the `backer` when the `Slab_Allocator` is dropped.  Allocations larger
+/// than `max_size` are passed through to the `backer`.
+///
+/// Objects are aligned to `max_alignment` and to the largest power of two dividing the size
+/// of their size class.  So an allocation with a larger alignment is still served from a slab
+/// when its size class is a multiple of the alignment, which is the case for arrays of over
+/// aligned types.  Other over aligned allocations are passed through to the `backer` aligned
+/// to `chunk_size`.  Chunks are also aligned to `chunk_size` and no object starts at the
+/// beginning of a chunk so `dealloc` can tell which allocations came from the `backer`
+/// by their address alone.
+///
+/// Memory can be deallocated on a different thread than it was allocated on.
+///
+/// # Example
+///
+/// ```
+/// cz::Slab_Allocator slab;
+/// slab.init();
+/// CZ_DEFER(slab.drop());
+///
+/// cz::Vector<int> vector = {};
+/// CZ_DEFER(vector.drop(slab.allocator()));
+/// vector.reserve(slab.allocator(), 4);
+/// ```
+struct Slab_Allocator {
+    static constexpr const size_t num_size_classes = 20;
+    static constexpr const size_t max_size = 1024;
+    static constexpr const size_t max_alignment = 16;
+    static constexpr const size_t batch_size = 32;
+    static constexpr const size_t chunk_size = 0x10000;
+
+    Allocator backer;
+
+    /// Protects all of the following fields.
+    Mutex mutex;
+
+    /// Batches of free objects in each size class.
+    Slab_Node* batches[num_size_classes];
+
+    /// Chunks are chained through their first word.
+    void* chunks;
+    char* chunk_pointer;
+    char* chunk_end;
+
+    /// The caches of all threads that have used this allocator.
+    Slab_Thread_Cache** caches;
+    size_t caches_len;
+    size_t caches_cap;
+
+    void init(Allocator backer = heap_allocator());
+
+    /// Deallocate all memory.  All other threads must stop using the allocator first.
+    void drop();
+
+    Allocator allocator() {
+        return {Slab_Allocator::realloc, Slab_Allocator::dealloc, this, nullptr};
+    }
+
+    /// Return all objects cached by this thread to the depot.  Call
+    /// this before a long lived thread stops using the allocator.
+    void flush_thread_cache();
+
+    /// The size class of an allocation of `size` bytes.  `size` must be at most `max_size`.
+    static size_t size_class(size_t size);
+    static size_t class_size(size_t size_class);
+
+    static void* realloc(void* slab, MemSlice old_mem, AllocInfo new_info);
+    static void dealloc(void* slab, MemSlice old_mem);
+};
+
+/// The per thread state of a `Slab_Allocator`.  Users should not touch this directly.
+struct Slab_Thread_Cache {
+    /// Set to `nullptr` when the `Slab_Allocator` is dropped.
+    std::atomic<Slab_Allocator*> slab;
+
+    Slab_Node* heads[Slab_Allocator::num_size_classes];
+    size_t counts[Slab_Allocator::num_size_classes];
+};
+
+}
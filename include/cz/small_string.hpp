@@ -0,0 +1,259 @@
+#pragma once
+
+#include <string.h>
+#include "allocator.hpp"
+#include "assert.hpp"
+#include "next_power_of_two.hpp"
+#include "str.hpp"
+#include "string.hpp"
+
+namespace cz {
+
+/// A mutable string that stores up to `N` characters inline and only allocates
+/// once it grows past that.  Use this instead of `String` when the string is
+/// almost always short so that most uses never allocate.
+///
+/// It has the same interface as `String` except that the characters are
+/// accessed via `buffer()` since they may be stored inline.  The allocator must
+/// still be passed to `reserve` and `drop` since the string may have spilled to the heap.
+///
+/// Copying a `Small_String` with inline characters copies the characters
+/// so don't use a copy after modifying the original.
+///
+/// # Example
+///
+/// ```
+/// #include <cz/defer.hpp>
+/// #include <cz/heap.hpp>
+/// #include <cz/small_string.hpp>
+///
+/// cz::Small_String<16> string = {};
+/// CZ_DEFER(string.drop(cz::heap_allocator()));
+///
+/// // Doesn't allocate.
+/// string.reserve(cz::heap_allocator(), 4);
+/// string.append("abc");
+/// string.null_terminate();
+/// ```
+template <size_t N>
+struct Small_String {
+    static_assert(N > 0, "Use String instead");
+
+    union {
+        char* heap_buffer;
+        char inline_buffer[N];
+    };
+    size_t len;
+    /// The capacity of `heap_buffer` or `0` if the characters are stored inline.
+    size_t cap;
+
+    /// Dealloc the `Small_String`.
+    void drop(Allocator allocator) {
+        if (!is_inline()) {
+            allocator.dealloc(heap_buffer, cap);
+        }
+    }
+
+    bool is_inline() const { return cap == 0; }
+    size_t capacity() const { return is_inline() ? N : cap; }
+
+    char* buffer() { return is_inline() ? inline_buffer : heap_buffer; }
+    const char* buffer() const { return is_inline() ? inline_buffer : heap_buffer; }
+
+    ///
+    /// Allocation methods.
+    ///
+
+    /// Ensure there are `extra` spaces available.  Amortizing expansion.
+    void reserve(Allocator allocator, size_t extra) { reserve_total(allocator, extra + len); }
+    void reserve_total(Allocator allocator, size_t total) {
+        if (capacity() < total) {
+            size_t new_cap = next_power_of_two(total - 1);
+            if (new_cap < 2 * N) {
+                new_cap = 2 * N;
+            }
+            realloc_new_cap(allocator, new_cap);
+        }
+    }
+
+    /// Ensure there are `extra` spaces available.  Exact expansion.
+    void reserve_exact(Allocator allocator, size_t extra) {
+        reserve_exact_total(allocator, extra + len);
+    }
+    void reserve_exact_total(Allocator allocator, size_t total) {
+        if (capacity() < total) {
+            realloc_new_cap(allocator, total);
+        }
+    }
+
+    /// Reallocate such that the capacity matches the length.
+    /// Moves the characters back inline if they fit.
+    void realloc(Allocator allocator) {
+        if (is_inline()) {
+            return;
+        }
+
+        if (len <= N) {
+            char* old_buffer = heap_buffer;
+            memcpy(inline_buffer, old_buffer, len);
+            allocator.dealloc(old_buffer, cap);
+            cap = 0;
+            return;
+        }
+
+        char* new_buffer = allocator.realloc(heap_buffer, cap, len);
+        if (new_buffer) {
+            heap_buffer = new_buffer;
+            cap = len;
+        }
+    }
+
+    /// Create a new `String` with the same contents in a unique memory buffer.
+    String clone(Allocator allocator) const { return as_str().clone(allocator); }
+    String clone_null_terminate(Allocator allocator) const {
+        return as_str().clone_null_terminate(allocator);
+    }
+
+    ///
+    /// Insertion methods.
+    /// Must `reserve` space before attempting to insert.
+    /// Indices must be manually bounds checked.
+    ///
+
+    /// Push character `ch` onto the end of the string.
+    void push(char ch) {
+        CZ_DEBUG_ASSERT(capacity() - len >= 1);
+        buffer()[len++] = ch;
+    }
+
+    /// Calls `push` `count` times.
+    void push_many(char ch, size_t count) {
+        CZ_DEBUG_ASSERT(capacity() - len >= count);
+        memset(buffer() + len, ch, count);
+        len += count;
+    }
+
+    /// Append the string `str` to the buffer.
+    void append(Str str) {
+        CZ_DEBUG_ASSERT(capacity() - len >= str.len);
+        memcpy(buffer() + len, str.buffer, str.len);
+        len += str.len;
+    }
+
+    /// Push `'\0'` onto the end of the string without changing the length.
+    void null_terminate() {
+        CZ_DEBUG_ASSERT(capacity() - len >= 1);
+        buffer()[len] = '\0';
+    }
+
+    /// Insert the character `ch` into the middle of the buffer.
+    /// Must manually bounds check!
+    void insert(size_t index, char ch) { insert(index, {&ch, 1}); }
+    /// Insert the string `str` into the middle of the buffer.
+    /// Must manually bounds check!
+    void insert(size_t index, Str str) {
+        CZ_DEBUG_ASSERT(index <= len);
+        CZ_DEBUG_ASSERT(capacity() - len >= str.len);
+        char* chars = buffer();
+        memmove(chars + index + str.len, chars + index, len - index);
+        memcpy(chars + index, str.buffer, str.len);
+        len += str.len;
+    }
+
+    ///
+    /// Removal methods.
+    /// Indices must be manually bounds checked.
+    ///
+
+    /// Pop the last character off the string.
+    char pop() {
+        CZ_DEBUG_ASSERT(len >= 1);
+        len--;
+        return buffer()[len];
+    }
+
+    /// Removes the character at `index`.
+    void remove(size_t index) { remove_many(index, 1); }
+
+    /// Removes `count` characters starting at `index`.
+    void remove_many(size_t index, size_t count) {
+        CZ_DEBUG_ASSERT(index + count <= len);
+        char* chars = buffer();
+        memmove(chars + index, chars + index + count, len - index - count);
+        len -= count;
+    }
+
+    /// Removes all characters starting at `start` up to but not including `end`.
+    void remove_range(size_t start, size_t end) {
+        CZ_DEBUG_ASSERT(end >= start);
+        return remove_many(start, end - start);
+    }
+
+    ///
+    /// Miscellaneous commands.
+    ///
+
+    size_t remaining() const { return capacity() - len; }
+
+    /// Pointer iterators.
+    char* start() { return buffer(); }
+    const char* start() const { return buffer(); }
+    char* begin() { return buffer(); }
+    const char* begin() const { return buffer(); }
+    char* end() { return buffer() + len; }
+    const char* end() const { return buffer() + len; }
+
+    /// Logical string comparison.
+    bool operator==(const Str& other) const { return as_str() == other; }
+    bool operator!=(const Str& other) const { return as_str() != other; }
+    bool operator<(const Str& other) const { return as_str() < other; }
+    bool operator>(const Str& other) const { return as_str() > other; }
+    bool operator<=(const Str& other) const { return as_str() <= other; }
+    bool operator>=(const Str& other) const { return as_str() >= other; }
+
+    /// Must manually bounds check!
+    char operator[](size_t i) const { return get(i); }
+    char& operator[](size_t i) { return get(i); }
+
+    char get(size_t i) const {
+        CZ_DEBUG_ASSERT(i < len);
+        return buffer()[i];
+    }
+    char& get(size_t i) {
+        CZ_DEBUG_ASSERT(i < len);
+        return buffer()[i];
+    }
+
+    ///
+    /// Str methods.  Use `as_str()` for the rest.
+    ///
+
+    bool starts_with(Str prefix) const { return as_str().starts_with(prefix); }
+    bool ends_with(Str postfix) const { return as_str().ends_with(postfix); }
+    bool contains(Str infix) const { return as_str().contains(infix); }
+    bool contains(char infix) const { return as_str().contains(infix); }
+    size_t find_index(Str infix) const { return as_str().find_index(infix); }
+    size_t find_index(char pattern) const { return as_str().find_index(pattern); }
+
+    Str as_str() const { return {buffer(), len}; }
+    operator Str() const { return as_str(); }
+
+private:
+    void realloc_new_cap(Allocator allocator, size_t new_cap) {
+        char* new_buffer;
+        if (is_inline()) {
+            // Spill the inline characters to the heap.
+            new_buffer = allocator.alloc<char>(new_cap);
+            CZ_ASSERT(new_buffer != nullptr);
+            memcpy(new_buffer, inline_buffer, len);
+        } else {
+            new_buffer = allocator.realloc(heap_buffer, cap, new_cap);
+            CZ_ASSERT(new_buffer != nullptr);
+        }
+
+        heap_buffer = new_buffer;
+        cap = new_cap;
+    }
+};
+
+}
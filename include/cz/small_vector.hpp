@@ -0,0 +1,262 @@
+#pragma once
+
+#include <string.h>
+#include "allocator.hpp"
+#include "assert.hpp"
+#include "next_power_of_two.hpp"
+#include "slice.hpp"
+#include "util.hpp"
+
+namespace cz {
+
+/// A dynamic array that stores up to `N` elements inline and only allocates
+/// once it grows past that.  Use this instead of `Vector` when the
+/// array is almost always small so that most uses never allocate.
+///
+/// It has the same interface as `Vector` except that the elements are accessed
+/// via `elems()` since they may be stored inline.  Elements are moved via `memcpy`
+/// so `T` must be trivially copyable.  The allocator must still be passed to
+/// `reserve` and `drop` since the elements may have spilled to the heap.
+///
+/// Copying a `Small_Vector` with inline elements copies the elements so don't
+/// use a copy after modifying the original.
+///
+/// # Example
+///
+/// ```
+/// #include <cz/defer.hpp>
+/// #include <cz/heap.hpp>
+/// #include <cz/small_vector.hpp>
+///
+/// cz::Small_Vector<int, 4> vector = {};
+/// CZ_DEFER(vector.drop(cz::heap_allocator()));
+///
+/// // Doesn't allocate.
+/// vector.reserve(cz::heap_allocator(), 2);
+/// vector.push(42);
+/// vector.push(-3);
+/// ```
+template <class T, size_t N>
+struct Small_Vector {
+    static_assert(N > 0, "Use Vector instead");
+
+    union {
+        T* heap_elems;
+        T inline_elems[N];
+    };
+    size_t len;
+    /// The capacity of `heap_elems` or `0` if the elements are stored inline.
+    size_t cap;
+
+    /// Deallocate the vector's memory.
+    void drop(Allocator allocator) {
+        if (!is_inline()) {
+            allocator.dealloc(heap_elems, cap);
+        }
+    }
+
+    bool is_inline() const { return cap == 0; }
+    size_t capacity() const { return is_inline() ? N : cap; }
+
+    T* elems() { return is_inline() ? inline_elems : heap_elems; }
+    const T* elems() const { return is_inline() ? inline_elems : heap_elems; }
+
+    ///
+    /// Allocation methods.
+    ///
+
+    /// Ensure there are `extra` spaces available.  Amortizing expansion.
+    void reserve(Allocator allocator, size_t extra) { reserve_total(allocator, len + extra); }
+    void reserve_total(Allocator allocator, size_t total) {
+        if (capacity() < total) {
+            size_t new_cap = next_power_of_two(total - 1);
+            if (new_cap < 2 * N) {
+                new_cap = 2 * N;
+            }
+            realloc_new_cap(allocator, new_cap);
+        }
+    }
+
+    /// Ensure there are `extra` spaces available.  Exact expansion.
+    void reserve_exact(Allocator allocator, size_t extra) {
+        reserve_exact_total(allocator, len + extra);
+    }
+    void reserve_exact_total(Allocator allocator, size_t total) {
+        if (capacity() < total) {
+            realloc_new_cap(allocator, total);
+        }
+    }
+
+    /// Reallocate such that the capacity matches the length.
+    /// Moves the elements back inline if they fit.
+    void realloc(Allocator allocator) {
+        if (is_inline()) {
+            return;
+        }
+
+        if (len <= N) {
+            T* old_elems = heap_elems;
+            memcpy(inline_elems, old_elems, sizeof(T) * len);
+            allocator.dealloc(old_elems, cap);
+            cap = 0;
+            return;
+        }
+
+        T* new_elems = allocator.realloc(heap_elems, cap, len);
+        if (new_elems) {
+            heap_elems = new_elems;
+            cap = len;
+        }
+    }
+
+    ///
+    /// Insertion methods.
+    /// Must `reserve` space before attempting to insert.
+    /// Indices must be manually bounds checked.
+    ///
+
+    /// Push an element.
+    void push(T t) {
+        CZ_DEBUG_ASSERT(capacity() - len >= 1);
+        elems()[len] = t;
+        ++len;
+    }
+
+    /// Push an element multiple times.
+    void push_many(T t, size_t count) {
+        CZ_DEBUG_ASSERT(capacity() - len >= count);
+        T* buffer = elems();
+        for (size_t i = 0; i < count; ++i)
+            buffer[len + i] = t;
+        len += count;
+    }
+
+    /// Append many elements.
+    void append(Slice<const T> slice) {
+        CZ_DEBUG_ASSERT(capacity() - len >= slice.len);
+        memcpy(elems() + len, slice.elems, slice.len * sizeof(T));
+        len += slice.len;
+    }
+
+    /// Insert an element into the middle of the vector.
+    void insert(size_t index, T t) {
+        CZ_DEBUG_ASSERT(index <= len);
+        CZ_DEBUG_ASSERT(capacity() - len >= 1);
+        T* buffer = elems();
+        memmove(buffer + index + 1, buffer + index, (len - index) * sizeof(T));
+        buffer[index] = t;
+        ++len;
+    }
+
+    /// Insert many elements into the middle of the vector.
+    void insert_slice(size_t index, cz::Slice<const T> slice) {
+        CZ_DEBUG_ASSERT(index <= len);
+        CZ_DEBUG_ASSERT(capacity() - len >= slice.len);
+        T* buffer = elems();
+        memmove(buffer + index + slice.len, buffer + index, (len - index) * sizeof(T));
+        memcpy(buffer + index, slice.elems, slice.len * sizeof(T));
+        len += slice.len;
+    }
+
+    ///
+    /// Removal methods.
+    /// Indices must be manually bounds checked.
+    ///
+
+    /// Pop one element.  Note: must have an element to pop!
+    T pop() {
+        CZ_DEBUG_ASSERT(len >= 1);
+        --len;
+        return elems()[len];
+    }
+
+    /// Remove an element from the middle of the vector.
+    void remove(size_t index) {
+        CZ_DEBUG_ASSERT(index < len);
+        T* buffer = elems();
+        memmove(buffer + index, buffer + index + 1, sizeof(T) * (len - index - 1));
+        --len;
+    }
+
+    /// Remove many elements from the middle of the vector.
+    void remove_many(size_t index, size_t count) {
+        CZ_DEBUG_ASSERT(index + count <= len);
+        T* buffer = elems();
+        memmove(buffer + index, buffer + index + count, sizeof(T) * (len - index - count));
+        len -= count;
+    }
+
+    /// Remove the range of elements from the middle of the vector.
+    void remove_range(size_t start, size_t end) {
+        CZ_DEBUG_ASSERT(end >= start);
+        return remove_many(start, end - start);
+    }
+
+    ///
+    /// Miscellaneous commands.
+    ///
+
+    size_t remaining() const { return capacity() - len; }
+
+    /// Pointer iterators.
+    T* start() { return elems(); }
+    const T* start() const { return elems(); }
+    T* begin() { return elems(); }
+    const T* begin() const { return elems(); }
+    T* end() { return elems() + len; }
+    const T* end() const { return elems() + len; }
+
+    /// Utility.
+    T& first() { return get(0); }
+    const T& first() const { return get(0); }
+    T& last() { return get(len - 1); }
+    const T& last() const { return get(len - 1); }
+
+    /// Must manually bounds check!
+    T& operator[](size_t i) { return get(i); }
+    const T& operator[](size_t i) const { return get(i); }
+
+    T& get(size_t i) {
+        CZ_DEBUG_ASSERT(i < len);
+        return elems()[i];
+    }
+    const T& get(size_t i) const {
+        CZ_DEBUG_ASSERT(i < len);
+        return elems()[i];
+    }
+
+    ///
+    /// Slice methods
+    ///
+
+    operator Slice<T>() { return {elems(), len}; }
+    operator Slice<const T>() const { return {elems(), len}; }
+
+    Slice<T> as_slice() { return *this; }
+    Slice<const T> as_slice() const { return *this; }
+
+    bool contains(const T& element) const { return as_slice().contains(element); }
+    size_t find_index(const T& element) const { return as_slice().find_index(element); }
+
+    bool operator==(Slice<const T> other) const { return as_slice() == other; }
+    bool operator!=(Slice<const T> other) const { return as_slice() != other; }
+
+private:
+    void realloc_new_cap(Allocator allocator, size_t new_cap) {
+        T* new_elems;
+        if (is_inline()) {
+            // Spill the inline elements to the heap.
+            new_elems = allocator.alloc<T>(new_cap);
+            CZ_ASSERT(new_elems != nullptr);
+            memcpy(new_elems, inline_elems, sizeof(T) * len);
+        } else {
+            new_elems = allocator.realloc(heap_elems, cap, new_cap);
+            CZ_ASSERT(new_elems != nullptr);
+        }
+
+        heap_elems = new_elems;
+        cap = new_cap;
+    }
+};
+
+}
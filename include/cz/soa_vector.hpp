@@ -0,0 +1,301 @@
+#pragma once
+
+#include <stddef.h>
+#include <string.h>
+#include "allocator.hpp"
+#include "assert.hpp"
+#include "growth_policy.hpp"
+#include "slice.hpp"
+#include "sort.hpp"
+#include "util.hpp"
+
+namespace cz {
+
+namespace soa_impl {
+
+template <size_t I, class... Ts>
+struct Type_At;
+template <class T, class... Ts>
+struct Type_At<0, T, Ts...> {
+    typedef T type;
+};
+template <size_t I, class T, class... Ts>
+struct Type_At<I, T, Ts...> {
+    typedef typename Type_At<I - 1, Ts...>::type type;
+};
+
+/// Compute where each column starts in a buffer holding `cap` rows.  Columns are
+/// stored in order and each starts at a multiple of its alignment.  Returns the
+/// total size of the buffer.  `offsets` must have room for `count` elements.
+inline size_t layout(const AllocInfo* infos, size_t count, size_t cap, size_t* offsets) {
+    size_t size = 0;
+    for (size_t i = 0; i < count; ++i) {
+        size_t alignment = infos[i].alignment;
+        size = (size + alignment - 1) / alignment * alignment;
+        offsets[i] = size;
+        size += infos[i].size * cap;
+    }
+    return size;
+}
+
+inline size_t max_alignment(const AllocInfo* infos, size_t count) {
+    size_t alignment = 1;
+    for (size_t i = 0; i < count; ++i) {
+        alignment = cz::max(alignment, infos[i].alignment);
+    }
+    return alignment;
+}
+
+// The following recurse through the column types so each column is accessed with its
+// real type instead of calling `memcpy` with a size that is only known at runtime.
+
+template <size_t I>
+void store(void**, size_t) {}
+template <size_t I, class T, class... Rest>
+void store(void** columns, size_t index, const T& value, const Rest&... rest) {
+    ((T*)columns[I])[index] = value;
+    store<I + 1>(columns, index, rest...);
+}
+
+template <size_t I>
+void move_row(void**, size_t, size_t) {}
+template <size_t I, class T, class... Rest>
+void move_row(void** columns, size_t dest, size_t src) {
+    ((T*)columns[I])[dest] = ((T*)columns[I])[src];
+    move_row<I + 1, Rest...>(columns, dest, src);
+}
+
+/// Copy row `entries[i].index` of `src` to row `i` of `dest`.
+template <class Entry, size_t I>
+void gather(void**, void**, const Entry*, size_t) {}
+template <class Entry, size_t I, class T, class... Rest>
+void gather(void** dest, void** src, const Entry* entries, size_t len) {
+    T* dest_column = (T*)dest[I];
+    const T* src_column = (const T*)src[I];
+    for (size_t i = 0; i < len; ++i) {
+        dest_column[i] = src_column[entries[i].index];
+    }
+    gather<Entry, I + 1, Rest...>(dest, src, entries, len);
+}
+
+}
+
+/// A dynamic array of rows of type `(Ts...)` stored as a structure of arrays.
+///
+/// Each field is stored contiguously in its own column so loops over one field
+/// only load that field and can be vectorized.  All the columns share one
+/// allocation that is grown at once.  Like `Vector`, elements are moved via
+/// `memcpy` so each type must be trivially copyable.
+///
+/// # Example
+///
+/// ```
+/// // Instead of `cz::Vector<Particle>`:
+/// cz::Soa_Vector<float, float, uint32_t> particles = {};
+/// CZ_DEFER(particles.drop(cz::heap_allocator()));
+///
+/// particles.reserve(cz::heap_allocator(), 1);
+/// particles.push(1.0f, 2.0f, 0xff0000);
+///
+/// cz::Slice<float> xs = particles.column<0>();
+/// cz::Slice<float> vs = particles.column<1>();
+/// for (size_t i = 0; i < particles.len; ++i) {
+///     xs[i] += vs[i];
+/// }
+///
+/// // Reorder every column by color.
+/// particles.sort_by<2>(cz::heap_allocator());
+/// ```
+template <class... Ts>
+struct Soa_Vector {
+    static_assert(sizeof...(Ts) > 0, "Soa_Vector must have at least one column");
+
+    static constexpr const size_t num_columns = sizeof...(Ts);
+
+    template <size_t I>
+    using Column_Type = typename soa_impl::Type_At<I, Ts...>::type;
+
+    /// The start of each column.  `columns[0]` is the start of the allocation.
+    void* columns[sizeof...(Ts)];
+    size_t len;
+    size_t cap;
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    void drop(Allocator allocator) {
+        AllocInfo infos[] = {alloc_info<Ts>()...};
+        size_t offsets[sizeof...(Ts)];
+        size_t size = soa_impl::layout(infos, num_columns, cap, offsets);
+        allocator.dealloc({columns[0], size});
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    /// Ensure there are `extra` spaces available.  Amortizing expansion.
+    void reserve(Allocator allocator,
+                 size_t extra,
+                 Growth_Policy policy = default_growth_policy) {
+        reserve_total(allocator, len + extra, policy);
+    }
+    void reserve_total(Allocator allocator,
+                       size_t total,
+                       Growth_Policy policy = default_growth_policy) {
+        if (CZ_UNLIKELY(cap < total)) {
+            size_t row_size = 0;
+            size_t sizes[] = {sizeof(Ts)...};
+            for (size_t i = 0; i < num_columns; ++i) {
+                row_size += sizes[i];
+            }
+            realloc_new_cap(allocator, policy(cap, total, row_size));
+        }
+    }
+
+    /// Ensure there are `extra` spaces available.  Exact expansion.
+    void reserve_exact(Allocator allocator, size_t extra) {
+        reserve_exact_total(allocator, len + extra);
+    }
+    void reserve_exact_total(Allocator allocator, size_t total) {
+        if (cap < total) {
+            realloc_new_cap(allocator, total);
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    /// Push a row.  Must `reserve` space first.
+    void push(const Ts&... values) {
+        CZ_DEBUG_ASSERT(len < cap);
+        soa_impl::store<0>(columns, len, values...);
+        ++len;
+    }
+
+    /// Overwrite the row at `index`.
+    void set(size_t index, const Ts&... values) {
+        CZ_DEBUG_ASSERT(index < len);
+        soa_impl::store<0>(columns, index, values...);
+    }
+
+    /// Remove the row at `index` and shift the following rows down.
+    void remove(size_t index) {
+        CZ_DEBUG_ASSERT(index < len);
+        size_t sizes[] = {sizeof(Ts)...};
+        for (size_t i = 0; i < num_columns; ++i) {
+            char* column = (char*)columns[i];
+            memmove(column + index * sizes[i], column + (index + 1) * sizes[i],
+                    (len - index - 1) * sizes[i]);
+        }
+        --len;
+    }
+
+    /// Remove the row at `index` by moving the last row into its place.  O(1).
+    void swap_remove(size_t index) {
+        CZ_DEBUG_ASSERT(index < len);
+        --len;
+        soa_impl::move_row<0, Ts...>(columns, index, len);
+    }
+
+    /// Pop the last row.
+    void pop() {
+        CZ_DEBUG_ASSERT(len >= 1);
+        --len;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    /// Get all the elements of column `I`.
+    template <size_t I>
+    Slice<Column_Type<I> > column() {
+        return {(Column_Type<I>*)columns[I], len};
+    }
+    template <size_t I>
+    Slice<const Column_Type<I> > column() const {
+        return {(const Column_Type<I>*)columns[I], len};
+    }
+
+    /// Get the element of column `I` in row `index`.
+    template <size_t I>
+    Column_Type<I>& get(size_t index) {
+        CZ_DEBUG_ASSERT(index < len);
+        return ((Column_Type<I>*)columns[I])[index];
+    }
+    template <size_t I>
+    const Column_Type<I>& get(size_t index) const {
+        CZ_DEBUG_ASSERT(index < len);
+        return ((const Column_Type<I>*)columns[I])[index];
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+
+    /// Sort the rows by column `I` and apply the same permutation to the other columns.
+    /// `is_less` is given pointers to two elements of column `I`.  Not stable.
+    ///
+    /// The keys are sorted along with their row indices in a temporary buffer and then
+    /// each column is gathered into a new allocation so each element is only moved once.
+    template <size_t I, class Is_Less>
+    void sort_by(Allocator allocator, Is_Less&& is_less) {
+        if (len <= 1) {
+            return;
+        }
+
+        typedef Column_Type<I> Key;
+        struct Entry {
+            Key key;
+            size_t index;
+        };
+
+        Entry* entries = allocator.alloc<Entry>(len);
+        CZ_ASSERT(entries);
+        const Key* keys = (const Key*)columns[I];
+        for (size_t i = 0; i < len; ++i) {
+            entries[i].key = keys[i];
+            entries[i].index = i;
+        }
+
+        sort(Slice<Entry>{entries, len},
+             [&](Entry* left, Entry* right) { return is_less(&left->key, &right->key); });
+
+        Soa_Vector<Ts...> sorted = {};
+        sorted.reserve_exact_total(allocator, cap);
+        soa_impl::gather<Entry, 0, Ts...>(sorted.columns, columns, entries, len);
+        sorted.len = len;
+
+        allocator.dealloc(entries, len);
+        drop(allocator);
+        *this = sorted;
+    }
+    template <size_t I>
+    void sort_by(Allocator allocator) {
+        sort_by<I>(allocator, sort_impl::Is_Less_Ptr<const Column_Type<I> >());
+    }
+
+private:
+    void realloc_new_cap(Allocator allocator, size_t new_cap) {
+        AllocInfo infos[] = {alloc_info<Ts>()...};
+        size_t old_offsets[sizeof...(Ts)];
+        size_t new_offsets[sizeof...(Ts)];
+        size_t old_size = soa_impl::layout(infos, num_columns, cap, old_offsets);
+        size_t new_size = soa_impl::layout(infos, num_columns, new_cap, new_offsets);
+        size_t alignment = soa_impl::max_alignment(infos, num_columns);
+
+        char* buffer = (char*)columns[0];
+        if (!allocator.try_expand_in_place({buffer, old_size}, new_size)) {
+            buffer = (char*)allocator.realloc({buffer, old_size}, {new_size, alignment});
+            CZ_ASSERT(buffer != nullptr);
+        }
+
+        // Each column starts further into the buffer than it used to so move
+        // them starting from the end to avoid overwriting the next column.
+        for (size_t i = num_columns; i-- > 0;) {
+            if (new_offsets[i] != old_offsets[i] && len > 0) {
+                memmove(buffer + new_offsets[i], buffer + old_offsets[i], len * infos[i].size);
+            }
+            columns[i] = buffer + new_offsets[i];
+        }
+        cap = new_cap;
+    }
+};
+
+template <class... Ts>
+constexpr const size_t Soa_Vector<Ts...>::num_columns;
+
+}
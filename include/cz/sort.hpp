@@ -1,5 +1,8 @@
 #pragma once
 
+#include <string.h>
+#include <cz/allocator.hpp>
+#include <cz/defer.hpp>
 #include <cz/slice.hpp>
 #include <cz/template_generic.hpp>
 #include <cz/vector.hpp>
@@ -25,64 +28,797 @@ void generic_insertion_sort(Iterator start, Iterator end, Is_Less&& is_less, Swa
     }
 }
 
+/// Heap sort.  Guaranteed `O(n log n)` but slower than `generic_sort` on average.
 template <class Iterator, class Is_Less, class Swap>
-void generic_sort(Iterator start, Iterator end, Is_Less&& is_less, Swap&& swap) {
-    if (start + 8 >= end) {
-        generic_insertion_sort(start, end, is_less, swap);
-        return;
+void generic_heap_sort(Iterator start, Iterator end, Is_Less&& is_less, Swap&& swap);
+
+namespace sort_impl {
+
+/// Function objects equivalent to `generic_is_less_ptr` and `generic_swap_ptr`.  Used
+/// by the default overloads because calls through a function pointer aren't inlined
+/// into the sorting loops once they are too big to be inlined themselves.
+template <class T>
+struct Is_Less_Ptr {
+    bool operator()(T* left, T* right) const { return *left < *right; }
+};
+template <class T>
+struct Swap_Ptr {
+    void operator()(T* left, T* right) const { generic_swap_ptr(left, right); }
+};
+
+/// Below this size use insertion sort.
+constexpr const size_t insertion_sort_threshold = 24;
+/// Above this size use the median of 3 medians of 3 (the ninther) as the pivot.
+constexpr const size_t ninther_threshold = 128;
+/// `partial_insertion_sort` gives up after moving this many elements.
+constexpr const size_t partial_insertion_sort_limit = 8;
+/// The number of elements classified at once by `partition_right`.
+constexpr const size_t block_size = 64;
+/// `merge_with_buffer` gallops once this many elements in a row come from one side.
+constexpr const size_t gallop_threshold = 7;
+
+/// Insertion sort that assumes there is an element before
+/// `start` that is not greater than any element in the range.
+template <class Iterator, class Is_Less, class Swap>
+void unguarded_insertion_sort(Iterator start, Iterator end, Is_Less& is_less, Swap& swap) {
+    Iterator middle = start;
+    for (++middle; middle < end; ++middle) {
+        Iterator point = middle;
+        Iterator prev = point;
+        for (--prev; is_less(point, prev); --point, --prev) {
+            swap(prev, point);
+        }
     }
+}
 
-    // Find pivot
-    Iterator pivot;
-    {
-        Iterator middle = start + (end - start) / 2;
-        if (is_less(start, middle)) {
-            // S M
-            if (is_less(middle, end - 1)) {
-                // S M E
-                pivot = middle;
-            } else if (is_less(start, end - 1)) {
-                // S E M
-                pivot = end - 1;
+/// Attempt to insertion sort the range.  Stops and returns `false` if more than
+/// `partial_insertion_sort_limit` elements have to be moved.  Used to quickly
+/// finish ranges that are already almost sorted.
+template <class Iterator, class Is_Less, class Swap>
+bool partial_insertion_sort(Iterator start, Iterator end, Is_Less& is_less, Swap& swap) {
+    if (start == end) {
+        return true;
+    }
+
+    size_t moves = 0;
+    Iterator middle = start;
+    for (++middle; middle < end; ++middle) {
+        Iterator point = middle;
+        while (point != start) {
+            Iterator prev = point;
+            --prev;
+            if (!is_less(point, prev)) {
+                break;
+            }
+            swap(prev, point);
+            point = prev;
+            ++moves;
+        }
+
+        if (moves > partial_insertion_sort_limit) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <class Iterator, class Is_Less, class Swap>
+void sort2(Iterator a, Iterator b, Is_Less& is_less, Swap& swap) {
+    if (is_less(b, a)) {
+        swap(a, b);
+    }
+}
+
+/// Sort the 3 elements so the median ends up at `b`.
+template <class Iterator, class Is_Less, class Swap>
+void sort3(Iterator a, Iterator b, Iterator c, Is_Less& is_less, Swap& swap) {
+    sort2(a, b, is_less, swap);
+    sort2(b, c, is_less, swap);
+    sort2(a, b, is_less, swap);
+}
+
+/// Partition around the pivot at `start`.  Elements equal to the pivot go to the right.
+/// Returns the final position of the pivot and sets `already_partitioned` if no
+/// elements had to be moved.  There must be an element not less than the pivot in the
+/// range (after `start`) and, unless `start` is the leftmost element, an element before
+/// `start` that is not greater than the pivot.
+///
+/// Elements are classified in blocks of `block_size` without branching on the result of
+/// the comparison (BlockQuicksort) and then misplaced elements are swapped in bulk.
+template <class Iterator, class Is_Less, class Swap>
+Iterator partition_right(Iterator start,
+                         Iterator end,
+                         Is_Less& is_less,
+                         Swap& swap,
+                         bool* already_partitioned) {
+    Iterator pivot = start;
+    Iterator first = start;
+    Iterator last = end;
+
+    // Find the first element not less than the pivot.  The median
+    // of 3 guarantees there is one so we don't need a bounds check.
+    while (is_less(++first, pivot)) {
+    }
+
+    // Find the last element less than the pivot.  If the first element was
+    // out of place then it guarantees there is such an element.
+    if (first - 1 == start) {
+        while (first < last && !is_less(--last, pivot)) {
+        }
+    } else {
+        while (!is_less(--last, pivot)) {
+        }
+    }
+
+    *already_partitioned = first >= last;
+    if (!*already_partitioned) {
+        swap(first, last);
+        ++first;
+
+        unsigned char offsets_l[block_size];
+        unsigned char offsets_r[block_size];
+        Iterator offsets_l_base = first;
+        Iterator offsets_r_base = last;
+        size_t num_l = 0, num_r = 0, start_l = 0, start_r = 0;
+
+        while (first < last) {
+            // Fill whichever offset buffers are empty.  Once there isn't room
+            // for two full blocks split the remaining elements between them.
+            size_t num_unknown = last - first;
+            size_t left_split = num_l == 0 ? (num_r == 0 ? num_unknown / 2 : num_unknown) : 0;
+            size_t right_split = num_r == 0 ? (num_unknown - left_split) : 0;
+            if (left_split > block_size) {
+                left_split = block_size;
+            }
+            if (right_split > block_size) {
+                right_split = block_size;
+            }
+
+            // Record the elements on the left that belong on the right.
+            for (size_t i = 0; i < left_split; ++i) {
+                offsets_l[num_l] = (unsigned char)i;
+                num_l += !is_less(first, pivot);
+                ++first;
+            }
+
+            // Record the elements on the right that belong on the left.
+            for (size_t i = 0; i < right_split; ++i) {
+                offsets_r[num_r] = (unsigned char)(i + 1);
+                --last;
+                num_r += is_less(last, pivot);
+            }
+
+            // Swap misplaced pairs.
+            size_t num = num_l < num_r ? num_l : num_r;
+            for (size_t i = 0; i < num; ++i) {
+                swap(offsets_l_base + offsets_l[start_l + i],
+                     offsets_r_base - offsets_r[start_r + i]);
+            }
+            num_l -= num;
+            num_r -= num;
+            start_l += num;
+            start_r += num;
+
+            if (num_l == 0) {
+                start_l = 0;
+                offsets_l_base = first;
+            }
+            if (num_r == 0) {
+                start_r = 0;
+                offsets_r_base = last;
+            }
+        }
+
+        // One side has leftover misplaced elements.  Move them to the boundary.
+        if (num_l) {
+            while (num_l--) {
+                swap(offsets_l_base + offsets_l[start_l + num_l], --last);
+            }
+            first = last;
+        }
+        if (num_r) {
+            while (num_r--) {
+                swap(offsets_r_base - offsets_r[start_r + num_r], first);
+                ++first;
+            }
+            last = first;
+        }
+    }
+
+    // Put the pivot in place.
+    Iterator pivot_pos = first - 1;
+    swap(start, pivot_pos);
+    return pivot_pos;
+}
+
+/// Partition around the pivot at `start`.  Elements equal to the pivot go to the left.
+/// Used when the pivot equals an element before the range so that all elements equal
+/// to it can be skipped at once.  Returns the final position of the pivot.
+template <class Iterator, class Is_Less, class Swap>
+Iterator partition_left(Iterator start, Iterator end, Is_Less& is_less, Swap& swap) {
+    Iterator pivot = start;
+    Iterator first = start;
+    Iterator last = end;
+
+    while (is_less(pivot, --last)) {
+    }
+
+    if (last + 1 == end) {
+        while (first < last && !is_less(pivot, ++first)) {
+        }
+    } else {
+        while (!is_less(pivot, ++first)) {
+        }
+    }
+
+    while (first < last) {
+        swap(first, last);
+        while (is_less(pivot, --last)) {
+        }
+        while (!is_less(pivot, ++first)) {
+        }
+    }
+
+    swap(start, last);
+    return last;
+}
+
+/// Move the pivot for the range to `start`.  Uses the median of 3 or, for
+/// large ranges, the median of 3 medians of 3 (the ninther).  The range
+/// must have at least `insertion_sort_threshold` elements.
+template <class Iterator, class Is_Less, class Swap>
+void choose_pivot(Iterator start, Iterator end, Is_Less& is_less, Swap& swap) {
+    size_t size = end - start;
+    size_t half = size / 2;
+    if (size > ninther_threshold) {
+        sort3(start, start + half, end - 1, is_less, swap);
+        sort3(start + 1, start + (half - 1), end - 2, is_less, swap);
+        sort3(start + 2, start + (half + 1), end - 3, is_less, swap);
+        sort3(start + (half - 1), start + half, start + (half + 1), is_less, swap);
+        swap(start, start + half);
+    } else {
+        sort3(start + half, start, end - 1, is_less, swap);
+    }
+}
+
+/// Shuffle some elements on both sides of `pivot` to break
+/// up patterns that caused an unbalanced partition.
+template <class Iterator, class Swap>
+void break_patterns(Iterator start, Iterator pivot, Iterator end, Swap& swap) {
+    size_t left_size = pivot - start;
+    size_t right_size = end - (pivot + 1);
+    if (left_size >= insertion_sort_threshold) {
+        swap(start, start + left_size / 4);
+        swap(pivot - 1, pivot - left_size / 4);
+        if (left_size > ninther_threshold) {
+            swap(start + 1, start + (left_size / 4 + 1));
+            swap(start + 2, start + (left_size / 4 + 2));
+            swap(pivot - 2, pivot - (left_size / 4 + 1));
+            swap(pivot - 3, pivot - (left_size / 4 + 2));
+        }
+    }
+    if (right_size >= insertion_sort_threshold) {
+        swap(pivot + 1, pivot + (1 + right_size / 4));
+        swap(end - 1, end - right_size / 4);
+        if (right_size > ninther_threshold) {
+            swap(pivot + 2, pivot + (2 + right_size / 4));
+            swap(pivot + 3, pivot + (3 + right_size / 4));
+            swap(end - 2, end - (1 + right_size / 4));
+            swap(end - 3, end - (2 + right_size / 4));
+        }
+    }
+}
+
+template <class Iterator, class Is_Less, class Swap>
+void pdqsort(Iterator start,
+             Iterator end,
+             Is_Less& is_less,
+             Swap& swap,
+             size_t bad_allowed,
+             bool leftmost) {
+    while (1) {
+        size_t size = end - start;
+
+        if (size < insertion_sort_threshold) {
+            if (leftmost) {
+                generic_insertion_sort(start, end, is_less, swap);
+            } else {
+                unguarded_insertion_sort(start, end, is_less, swap);
+            }
+            return;
+        }
+
+        choose_pivot(start, end, is_less, swap);
+
+        // If the element before the range equals the pivot then every element equal to
+        // the pivot is already in place.  Put them on the left and only sort the right.
+        // This makes inputs with many duplicates take `O(n * distinct values)`.
+        if (!leftmost && !is_less(start - 1, start)) {
+            start = partition_left(start, end, is_less, swap) + 1;
+            continue;
+        }
+
+        bool already_partitioned;
+        Iterator pivot = partition_right(start, end, is_less, swap, &already_partitioned);
+
+        size_t left_size = pivot - start;
+        size_t right_size = end - (pivot + 1);
+        bool highly_unbalanced = left_size < size / 8 || right_size < size / 8;
+
+        if (highly_unbalanced) {
+            // Too many bad partitions.  Fall back to heap sort to guarantee `O(n log n)`.
+            if (--bad_allowed == 0) {
+                generic_heap_sort(start, end, is_less, swap);
+                return;
+            }
+
+            break_patterns(start, pivot, end, swap);
+        } else {
+            // A well balanced partition that didn't move anything suggests
+            // the input is already sorted.  Try to finish with insertion sort.
+            if (already_partitioned && partial_insertion_sort(start, pivot, is_less, swap) &&
+                partial_insertion_sort(pivot + 1, end, is_less, swap)) {
+                return;
+            }
+        }
+
+        // Recurse into the smaller side and loop on the larger
+        // side so the stack depth is at most `O(log n)`.
+        if (left_size < right_size) {
+            pdqsort(start, pivot, is_less, swap, bad_allowed, leftmost);
+            start = pivot + 1;
+            leftmost = false;
+        } else {
+            pdqsort(pivot + 1, end, is_less, swap, bad_allowed, false);
+            end = pivot;
+        }
+    }
+}
+
+/// Allow `log2(size)` bad partitions before falling back to heap sort.
+inline size_t bad_allowed(size_t size) {
+    size_t bad_allowed = 0;
+    for (; size > 0; size >>= 1) {
+        ++bad_allowed;
+    }
+    return bad_allowed;
+}
+
+template <class Iterator, class Is_Less, class Swap>
+void sift_down(Iterator start, size_t size, size_t root, Is_Less& is_less, Swap& swap) {
+    while (1) {
+        size_t child = 2 * root + 1;
+        if (child >= size) {
+            return;
+        }
+        if (child + 1 < size && is_less(start + child, start + (child + 1))) {
+            ++child;
+        }
+        if (!is_less(start + root, start + child)) {
+            return;
+        }
+        swap(start + root, start + child);
+        root = child;
+    }
+}
+
+/// Find the `nth` smallest element using the same partitioning as `pdqsort` but only
+/// continuing into the side containing `nth` (introselect).  Falls back to heap sort.
+template <class Iterator, class Is_Less, class Swap>
+void select(Iterator start,
+            Iterator nth,
+            Iterator end,
+            Is_Less& is_less,
+            Swap& swap,
+            size_t bad_allowed) {
+    bool leftmost = true;
+    while (1) {
+        size_t size = end - start;
+
+        if (size < insertion_sort_threshold) {
+            if (leftmost) {
+                generic_insertion_sort(start, end, is_less, swap);
             } else {
-                // E S M
-                pivot = start;
+                unguarded_insertion_sort(start, end, is_less, swap);
+            }
+            return;
+        }
+
+        choose_pivot(start, end, is_less, swap);
+
+        // Every element up to and including the pivot equals the element before the range.
+        if (!leftmost && !is_less(start - 1, start)) {
+            Iterator pivot = partition_left(start, end, is_less, swap);
+            if (nth <= pivot) {
+                return;
+            }
+            start = pivot + 1;
+            continue;
+        }
+
+        bool already_partitioned;
+        Iterator pivot = partition_right(start, end, is_less, swap, &already_partitioned);
+
+        size_t left_size = pivot - start;
+        size_t right_size = end - (pivot + 1);
+        if (left_size < size / 8 || right_size < size / 8) {
+            if (--bad_allowed == 0) {
+                generic_heap_sort(start, end, is_less, swap);
+                return;
+            }
+            break_patterns(start, pivot, end, swap);
+        }
+
+        if (nth == pivot) {
+            return;
+        } else if (nth < pivot) {
+            end = pivot;
+        } else {
+            start = pivot + 1;
+            leftmost = false;
+        }
+    }
+}
+
+/// The minimum length of a run in `merge_sort`.  Picked between 8 and 16 so that
+/// `size / min_run` is a power of two or slightly smaller than one.  Runs are
+/// extended with insertion sort through `swap` which is slow for longer runs.
+inline size_t min_run_length(size_t size) {
+    size_t extra = 0;
+    while (size >= 16) {
+        extra |= size & 1;
+        size >>= 1;
+    }
+    return size + extra;
+}
+
+/// Find the run starting at `start`.  Strictly descending runs are reversed.
+template <class Iterator, class Is_Less, class Swap>
+size_t find_run(Iterator start, Iterator end, Is_Less& is_less, Swap& swap) {
+    Iterator next = start;
+    ++next;
+    if (next == end) {
+        return 1;
+    }
+
+    if (is_less(next, start)) {
+        // Descending runs must be strictly descending to keep the sort stable.
+        for (++next; next < end && is_less(next, next - 1); ++next) {
+        }
+        for (Iterator first = start, last = next - 1; first < last; ++first, --last) {
+            swap(first, last);
+        }
+    } else {
+        for (++next; next < end && !is_less(next, next - 1); ++next) {
+        }
+    }
+    return next - start;
+}
+
+/// Sort the range by finding runs that are already sorted, extending them to
+/// `min_run_length` with insertion sort, and then merging them (Timsort).
+/// `merge(start, middle, end)` merges two adjacent sorted ranges.
+template <class Iterator, class Is_Less, class Swap, class Merge>
+void merge_sort(Iterator start, Iterator end, Is_Less& is_less, Swap& swap, Merge& merge) {
+    struct Run {
+        Iterator start;
+        size_t len;
+    };
+
+    // Merging keeps each run longer than the next two combined so
+    // the lengths grow at least as fast as the Fibonacci sequence.
+    Run runs[96];
+    size_t num_runs = 0;
+
+    auto merge_at = [&](size_t i) {
+        merge(runs[i].start, runs[i + 1].start, runs[i + 1].start + runs[i + 1].len);
+        runs[i].len += runs[i + 1].len;
+        if (i + 2 < num_runs) {
+            runs[i + 1] = runs[i + 2];
+        }
+        --num_runs;
+    };
+
+    size_t min_run = min_run_length(end - start);
+    for (Iterator run_start = start; run_start < end;) {
+        size_t len = find_run(run_start, end, is_less, swap);
+        if (len < min_run) {
+            size_t remaining = end - run_start;
+            len = remaining < min_run ? remaining : min_run;
+            generic_insertion_sort(run_start, run_start + len, is_less, swap);
+        }
+
+        CZ_DEBUG_ASSERT(num_runs < sizeof(runs) / sizeof(runs[0]));
+        runs[num_runs++] = {run_start, len};
+        run_start += len;
+
+        // Restore the invariants on the top 4 runs.
+        while (num_runs > 1) {
+            size_t i = num_runs - 2;
+            if ((i > 0 && runs[i - 1].len <= runs[i].len + runs[i + 1].len) ||
+                (i > 1 && runs[i - 2].len <= runs[i - 1].len + runs[i].len)) {
+                if (runs[i - 1].len < runs[i + 1].len) {
+                    --i;
+                }
+            } else if (runs[i].len > runs[i + 1].len) {
+                break;
             }
+            merge_at(i);
+        }
+    }
+
+    while (num_runs > 1) {
+        size_t i = num_runs - 2;
+        if (i > 0 && runs[i - 1].len < runs[i + 1].len) {
+            --i;
+        }
+        merge_at(i);
+    }
+}
+
+template <class Iterator, class Swap>
+void swap_ranges(Iterator left, Iterator right, size_t len, Swap& swap) {
+    for (size_t i = 0; i < len; ++i) {
+        swap(left + i, right + i);
+    }
+}
+
+/// Rotate the range so `middle` becomes the first element.
+template <class Iterator, class Swap>
+void rotate(Iterator start, Iterator middle, Iterator end, Swap& swap) {
+    size_t left = middle - start;
+    size_t right = end - middle;
+    while (left != right) {
+        if (left > right) {
+            swap_ranges(middle - left, middle, right, swap);
+            left -= right;
         } else {
-            // M S
-            if (is_less(start, end - 1)) {
-                // M S E
-                pivot = start;
-            } else if (is_less(middle, end - 1)) {
-                // M E S
-                pivot = end - 1;
+            swap_ranges(middle - left, middle + (right - left), left, swap);
+            right -= left;
+        }
+    }
+    swap_ranges(middle - left, middle, left, swap);
+}
+
+/// Stably merge two adjacent sorted ranges using only swaps (SymMerge).  Takes
+/// `O(n log n)` swaps and `O(log n)` stack space.  Both ranges must be non-empty.
+template <class Iterator, class Is_Less, class Swap>
+void merge_in_place(Iterator start, Iterator middle, Iterator end, Is_Less& is_less, Swap& swap) {
+    // Insert a single element with a binary search.
+    if (middle - start == 1) {
+        Iterator low = middle, high = end;
+        while (low < high) {
+            Iterator half = low + (high - low) / 2;
+            if (is_less(half, start)) {
+                low = half + 1;
             } else {
-                // E M S
-                pivot = middle;
+                high = half;
             }
         }
+        for (Iterator point = start; point < low - 1; ++point) {
+            swap(point, point + 1);
+        }
+        return;
+    }
+    if (end - middle == 1) {
+        Iterator low = start, high = middle;
+        while (low < high) {
+            Iterator half = low + (high - low) / 2;
+            if (!is_less(middle, half)) {
+                low = half + 1;
+            } else {
+                high = half;
+            }
+        }
+        for (Iterator point = middle; point > low; --point) {
+            swap(point, point - 1);
+        }
+        return;
+    }
+
+    // Find the split point so that rotating the elements around `middle`
+    // leaves two independent merges, each of about half the range.
+    size_t size = end - start;
+    size_t half = size / 2;
+    size_t left = middle - start;
+    size_t sum = half + left;
+    size_t low, high;
+    if (left > half) {
+        low = sum - size;
+        high = half;
+    } else {
+        low = 0;
+        high = left;
+    }
+    while (low < high) {
+        size_t split = low + (high - low) / 2;
+        if (!is_less(start + (sum - 1 - split), start + split)) {
+            low = split + 1;
+        } else {
+            high = split;
+        }
+    }
+
+    size_t split_end = sum - low;
+    if (low < left && left < split_end) {
+        rotate(start + low, middle, start + split_end, swap);
+    }
+    if (0 < low && low < half) {
+        merge_in_place(start, start + low, start + half, is_less, swap);
+    }
+    if (half < split_end && split_end < size) {
+        merge_in_place(start + half, start + split_end, end, is_less, swap);
+    }
+}
+
+/// The first element in the range for which `pred` is false.  `pred` must
+/// be true for a prefix of the range and false for the rest.
+template <class T, class Pred>
+T* lower_bound_by(T* start, T* end, Pred&& pred) {
+    while (start < end) {
+        T* half = start + (end - start) / 2;
+        if (pred(half)) {
+            start = half + 1;
+        } else {
+            end = half;
+        }
+    }
+    return start;
+}
+
+/// The first element in the range for which `pred` is false.  `pred` must be true for a
+/// prefix of the range and false for the rest.  Searches exponentially from the start
+/// and then binary searches so it takes `O(log k)` where `k` is the distance to the result.
+template <class T, class Pred>
+T* gallop_forward(T* start, T* end, Pred&& pred) {
+    size_t size = end - start;
+    size_t low = 0;
+    size_t high = 1;
+    while (high <= size && pred(start + (high - 1))) {
+        low = high;
+        high = 2 * high + 1;
+    }
+    if (high > size) {
+        high = size;
+    }
+    return lower_bound_by(start + low, start + high, pred);
+}
+
+/// Same as `gallop_forward` but searches exponentially from the end.
+template <class T, class Pred>
+T* gallop_backward(T* start, T* end, Pred&& pred) {
+    size_t size = end - start;
+    size_t low = 0;
+    size_t high = 1;
+    while (high <= size && !pred(end - high)) {
+        low = high;
+        high = 2 * high + 1;
+    }
+    if (high > size) {
+        high = size;
     }
+    return lower_bound_by(end - high, end - low, pred);
+}
 
-    // Partition using pivot
-    {
-        swap(pivot, end - 1);
-        pivot = end - 1;
+/// Stably merge two adjacent sorted ranges by copying the smaller one into `buffer`.
+///
+/// Elements are merged in groups of `gallop_threshold` without branching on the comparison
+/// because the branch is unpredictable on random data.  Before each group, if the element
+/// `gallop_threshold` ahead on one side still goes before the other side then the rest of
+/// the elements that go next are found with `gallop_forward` or `gallop_backward` and moved
+/// as a block.  This makes merging nearly sorted data fast.
+template <class T, class Is_Less>
+void merge_with_buffer(T* start, T* middle, T* end, T* buffer, Is_Less& is_less) {
+    // Skip elements at the start and end that are already in place.
+    start = lower_bound_by(start, middle, [&](T* elem) { return !is_less(middle, elem); });
+    end = lower_bound_by(middle, end, [&](T* elem) { return is_less(elem, middle - 1); });
+    if (start == middle || middle == end) {
+        return;
+    }
+
+    const size_t gallop = gallop_threshold;
+    size_t left_len = middle - start;
+    size_t right_len = end - middle;
+    if (left_len <= right_len) {
+        // Merge forwards from the left side in the buffer.
+        memcpy(buffer, start, sizeof(T) * left_len);
+        T* left = buffer;
+        T* left_end = buffer + left_len;
+        T* right = middle;
+        T* out = start;
+        while (left < left_end && right < end) {
+            if ((size_t)(end - right) > gallop && is_less(right + gallop, left)) {
+                T* value = left;
+                auto is_before = [&is_less, value](T* elem) { return is_less(elem, value); };
+                T* next = gallop_forward(right + gallop + 1, end, is_before);
+                memmove(out, right, sizeof(T) * (next - right));
+                out += next - right;
+                right = next;
+                continue;
+            }
+            if ((size_t)(left_end - left) > gallop && !is_less(right, left + gallop)) {
+                T* value = right;
+                auto is_before = [&is_less, value](T* elem) { return !is_less(value, elem); };
+                T* next = gallop_forward(left + gallop + 1, left_end, is_before);
+                memcpy(out, left, sizeof(T) * (next - left));
+                out += next - left;
+                left = next;
+                continue;
+            }
 
-        Iterator i = start;
-        for (Iterator j = start; j < end - 1; ++j) {
-            if (is_less(j, pivot)) {
-                swap(i, j);
-                ++i;
+            for (size_t i = 0; i < gallop && left < left_end && right < end; ++i) {
+                bool take_right = is_less(right, left);
+                memcpy(out++, take_right ? right : left, sizeof(T));
+                right += take_right;
+                left += !take_right;
             }
         }
+        memcpy(out, left, sizeof(T) * (left_end - left));
+    } else {
+        // Merge backwards from the right side in the buffer.
+        memcpy(buffer, middle, sizeof(T) * right_len);
+        T* left = middle;
+        T* right = buffer + right_len;
+        T* out = end;
+        while (left > start && right > buffer) {
+            if ((size_t)(left - start) > gallop && is_less(right - 1, left - 1 - gallop)) {
+                T* value = right - 1;
+                auto is_before = [&is_less, value](T* elem) { return !is_less(value, elem); };
+                T* next = gallop_backward(start, left - 1 - gallop, is_before);
+                out -= left - next;
+                memmove(out, next, sizeof(T) * (left - next));
+                left = next;
+                continue;
+            }
+            if ((size_t)(right - buffer) > gallop && !is_less(right - 1 - gallop, left - 1)) {
+                T* value = left - 1;
+                auto is_before = [&is_less, value](T* elem) { return is_less(elem, value); };
+                T* next = gallop_backward(buffer, right - 1 - gallop, is_before);
+                out -= right - next;
+                memcpy(out, next, sizeof(T) * (right - next));
+                right = next;
+                continue;
+            }
+
+            for (size_t i = 0; i < gallop && left > start && right > buffer; ++i) {
+                bool take_left = is_less(right - 1, left - 1);
+                memcpy(--out, take_left ? left - 1 : right - 1, sizeof(T));
+                left -= take_left;
+                right -= !take_left;
+            }
+        }
+        memcpy(out - (right - buffer), buffer, sizeof(T) * (right - buffer));
+    }
+}
+
+}
 
-        pivot = i;
-        swap(pivot, end - 1);
+template <class Iterator, class Is_Less, class Swap>
+void generic_heap_sort(Iterator start, Iterator end, Is_Less&& is_less, Swap&& swap) {
+    size_t size = end - start;
+    for (size_t i = size / 2; i-- > 0;) {
+        sort_impl::sift_down(start, size, i, is_less, swap);
+    }
+    for (size_t i = size; i-- > 1;) {
+        swap(start, start + i);
+        sort_impl::sift_down(start, i, 0, is_less, swap);
     }
+}
 
-    // Recurse left and right
-    generic_sort(start, pivot, is_less, swap);
-    generic_sort(pivot + 1, end, is_less, swap);
+/// Sort the range using pattern defeating quicksort (pdqsort).
+///
+/// Runs in `O(n log n)` in the worst case, `O(n)` on sorted and reverse sorted inputs, and
+/// `O(n k)` on inputs with `k` distinct values.  Uses `O(log n)` stack space.  Not stable.
+///
+/// `is_less(a, b)` and `swap(a, b)` are given iterators to the elements to compare or swap.
+template <class Iterator, class Is_Less, class Swap>
+void generic_sort(Iterator start, Iterator end, Is_Less&& is_less, Swap&& swap) {
+    size_t size = end - start;
+    if (size < 2) {
+        return;
+    }
+
+    sort_impl::pdqsort(start, end, is_less, swap, sort_impl::bad_allowed(size), true);
 }
 
 template <class T, class Is_Less, class Swap>
@@ -91,11 +827,11 @@ void sort(cz::Slice<T> slice, Is_Less&& is_less, Swap&& swap) {
 }
 template <class T, class Is_Less>
 void sort(cz::Slice<T> slice, Is_Less&& is_less) {
-    sort(slice, is_less, generic_swap_ptr<T>);
+    sort(slice, is_less, sort_impl::Swap_Ptr<T>());
 }
 template <class T>
 void sort(cz::Slice<T> slice) {
-    sort(slice, generic_is_less_ptr<T>);
+    sort(slice, sort_impl::Is_Less_Ptr<T>());
 }
 
 template <class T, class Is_Less, class Swap>
@@ -111,6 +847,140 @@ void sort(cz::Vector<T> vector) {
     sort(vector.as_slice());
 }
 
+/// Put the smallest `middle - start` elements of the range in sorted
+/// order at the start.  The order of the rest of the range is unspecified.
+///
+/// Keeps the smallest elements in a heap so it runs in `O(n log k)` where `k = middle - start`.
+template <class Iterator, class Is_Less, class Swap>
+void generic_partial_sort(Iterator start,
+                          Iterator middle,
+                          Iterator end,
+                          Is_Less&& is_less,
+                          Swap&& swap) {
+    size_t size = middle - start;
+    if (size == 0) {
+        return;
+    }
+
+    for (size_t i = size / 2; i-- > 0;) {
+        sort_impl::sift_down(start, size, i, is_less, swap);
+    }
+
+    // Replace the largest of the smallest elements found so far.
+    for (Iterator it = middle; it < end; ++it) {
+        if (is_less(it, start)) {
+            swap(start, it);
+            sort_impl::sift_down(start, size, 0, is_less, swap);
+        }
+    }
+
+    for (size_t i = size; i-- > 1;) {
+        swap(start, start + i);
+        sort_impl::sift_down(start, i, 0, is_less, swap);
+    }
+}
+
+/// Rearrange the range so the element at `nth` is the one that would be there if the range
+/// was sorted, every element before it is not greater than it, and every element after it
+/// is not less than it.  Runs in `O(n)` on average and `O(n log n)` in the worst case.
+template <class Iterator, class Is_Less, class Swap>
+void generic_nth_element(Iterator start,
+                         Iterator nth,
+                         Iterator end,
+                         Is_Less&& is_less,
+                         Swap&& swap) {
+    size_t size = end - start;
+    if (nth >= end || size < 2) {
+        return;
+    }
+
+    sort_impl::select(start, nth, end, is_less, swap, sort_impl::bad_allowed(size));
+}
+
+/// Stable sort.  Equal elements keep their original order.
+///
+/// Finds runs that are already sorted or strictly descending and merges them (Timsort),
+/// so nearly sorted inputs take close to `O(n)`.  This version doesn't allocate and merges
+/// using only `swap` so it takes `O(n log^2 n)` in the worst case.  `stable_sort` with a
+/// scratch `Allocator` is faster when a buffer of `n / 2` elements is affordable.
+template <class Iterator, class Is_Less, class Swap>
+void generic_stable_sort(Iterator start, Iterator end, Is_Less&& is_less, Swap&& swap) {
+    if (end - start < 2) {
+        return;
+    }
+
+    auto merge = [&](Iterator left, Iterator middle, Iterator right) {
+        if (is_less(middle, middle - 1)) {
+            sort_impl::merge_in_place(left, middle, right, is_less, swap);
+        }
+    };
+    sort_impl::merge_sort(start, end, is_less, swap, merge);
+}
+
+template <class T, class Is_Less, class Swap>
+void partial_sort(cz::Slice<T> slice, size_t count, Is_Less&& is_less, Swap&& swap) {
+    CZ_DEBUG_ASSERT(count <= slice.len);
+    generic_partial_sort(slice.start(), slice.start() + count, slice.end(), is_less, swap);
+}
+template <class T, class Is_Less>
+void partial_sort(cz::Slice<T> slice, size_t count, Is_Less&& is_less) {
+    partial_sort(slice, count, is_less, sort_impl::Swap_Ptr<T>());
+}
+template <class T>
+void partial_sort(cz::Slice<T> slice, size_t count) {
+    partial_sort(slice, count, sort_impl::Is_Less_Ptr<T>());
+}
+
+template <class T, class Is_Less, class Swap>
+void nth_element(cz::Slice<T> slice, size_t nth, Is_Less&& is_less, Swap&& swap) {
+    generic_nth_element(slice.start(), slice.start() + nth, slice.end(), is_less, swap);
+}
+template <class T, class Is_Less>
+void nth_element(cz::Slice<T> slice, size_t nth, Is_Less&& is_less) {
+    nth_element(slice, nth, is_less, sort_impl::Swap_Ptr<T>());
+}
+template <class T>
+void nth_element(cz::Slice<T> slice, size_t nth) {
+    nth_element(slice, nth, sort_impl::Is_Less_Ptr<T>());
+}
+
+template <class T, class Is_Less, class Swap>
+void stable_sort(cz::Slice<T> slice, Is_Less&& is_less, Swap&& swap) {
+    generic_stable_sort(slice.start(), slice.end(), is_less, swap);
+}
+template <class T, class Is_Less>
+void stable_sort(cz::Slice<T> slice, Is_Less&& is_less) {
+    stable_sort(slice, is_less, sort_impl::Swap_Ptr<T>());
+}
+template <class T>
+void stable_sort(cz::Slice<T> slice) {
+    stable_sort(slice, sort_impl::Is_Less_Ptr<T>());
+}
+
+/// Stable sort that merges through a buffer of `slice.len / 2` elements allocated
+/// with `scratch`.  Takes `O(n log n)`.  Elements are moved by copying their bytes.
+template <class T, class Is_Less>
+void stable_sort(Allocator scratch, cz::Slice<T> slice, Is_Less&& is_less) {
+    if (slice.len < 2) {
+        return;
+    }
+
+    size_t buffer_len = slice.len / 2;
+    T* buffer = scratch.alloc<T>(buffer_len);
+    CZ_ASSERT(buffer);
+    CZ_DEFER(scratch.dealloc(buffer, buffer_len));
+
+    sort_impl::Swap_Ptr<T> swap;
+    auto merge = [&](T* left, T* middle, T* right) {
+        sort_impl::merge_with_buffer(left, middle, right, buffer, is_less);
+    };
+    sort_impl::merge_sort(slice.start(), slice.end(), is_less, swap, merge);
+}
+template <class T>
+void stable_sort(Allocator scratch, cz::Slice<T> slice) {
+    stable_sort(scratch, slice, sort_impl::Is_Less_Ptr<T>());
+}
+
 template <class Iterator, class Is_Less>
 bool generic_is_sorted(Iterator start, Iterator end, Is_Less&& is_less) {
     Iterator next = start;
@@ -0,0 +1,290 @@
+#pragma once
+
+#include <stdint.h>
+#include <cz/slice.hpp>
+#include <cz/template_generic.hpp>
+
+namespace cz {
+
+// Operations on sorted ranges without duplicates (sets).  Each operation
+// writes the result to `out` in sorted order and returns the new end of `out`.
+// `out` must not overlap either input.
+//
+// Elements are compared with `is_less(Iterator, Iterator)` and
+// copied with `set(Out, Iterator)` like in `dedup`.
+
+namespace sorted_set_impl {
+
+/// Gallop instead of merging if one side has this many times as many elements as the other.
+constexpr const size_t gallop_ratio = 32;
+
+/// Find the first element in `[start, end)` that is not less than `*value`.  Takes steps
+/// that double in size until it passes `value` and then binary searches the last step
+/// so it only takes `O(log(distance))` comparisons.
+template <class Iterator, class Is_Less>
+Iterator gallop(Iterator start, Iterator end, Iterator value, Is_Less& is_less) {
+    size_t len = end - start;
+    size_t bound = 0;
+    size_t step = 1;
+    while (bound < len && is_less(start + bound, value)) {
+        start += bound + 1;
+        len -= bound + 1;
+        bound = step;
+        step *= 2;
+    }
+    if (bound > len) {
+        bound = len;
+    }
+
+    // The answer is in `[start, start + bound]`.
+    while (bound > 0) {
+        size_t half = bound / 2;
+        if (is_less(start + half, value)) {
+            start += half + 1;
+            bound -= half + 1;
+        } else {
+            bound = half;
+        }
+    }
+    return start;
+}
+
+template <class Iterator, class Out, class Set>
+Out copy(Iterator start, Iterator end, Out out, Set& set) {
+    for (; start < end; ++start, ++out) {
+        set(out, start);
+    }
+    return out;
+}
+
+/// Union by galloping through `large` for each element in `small`.
+template <class Iterator, class Out, class Is_Less, class Set>
+Out gallop_union(Iterator small_start,
+                 Iterator small_end,
+                 Iterator large_start,
+                 Iterator large_end,
+                 Out out,
+                 Is_Less& is_less,
+                 Set& set) {
+    for (; small_start < small_end; ++small_start) {
+        Iterator next = gallop(large_start, large_end, small_start, is_less);
+        out = copy(large_start, next, out, set);
+        large_start = next;
+
+        set(out, small_start);
+        ++out;
+        if (large_start < large_end && !is_less(small_start, large_start)) {
+            ++large_start;
+        }
+    }
+    return copy(large_start, large_end, out, set);
+}
+
+/// Intersect by galloping through `large` for each element in `small`.
+template <class Iterator, class Out, class Is_Less, class Set>
+Out gallop_intersection(Iterator small_start,
+                        Iterator small_end,
+                        Iterator large_start,
+                        Iterator large_end,
+                        Out out,
+                        Is_Less& is_less,
+                        Set& set) {
+    for (; small_start < small_end; ++small_start) {
+        large_start = gallop(large_start, large_end, small_start, is_less);
+        if (!(large_start < large_end)) {
+            break;
+        }
+        if (!is_less(small_start, large_start)) {
+            set(out, small_start);
+            ++out;
+            ++large_start;
+        }
+    }
+    return out;
+}
+
+}
+
+/// Store the elements in either range.  If one range is much
+/// smaller than the other then gallops through the larger range.
+template <class Iterator, class Out, class Is_Less, class Set>
+Out generic_set_union(Iterator a_start,
+                      Iterator a_end,
+                      Iterator b_start,
+                      Iterator b_end,
+                      Out out,
+                      Is_Less&& is_less,
+                      Set&& set) {
+    size_t a_len = a_end - a_start;
+    size_t b_len = b_end - b_start;
+    if (a_len * sorted_set_impl::gallop_ratio < b_len) {
+        return sorted_set_impl::gallop_union(a_start, a_end, b_start, b_end, out, is_less, set);
+    }
+    if (b_len * sorted_set_impl::gallop_ratio < a_len) {
+        return sorted_set_impl::gallop_union(b_start, b_end, a_start, a_end, out, is_less, set);
+    }
+
+    while (a_start < a_end && b_start < b_end) {
+        if (is_less(b_start, a_start)) {
+            set(out, b_start);
+            ++b_start;
+        } else {
+            if (!is_less(a_start, b_start)) {
+                ++b_start;
+            }
+            set(out, a_start);
+            ++a_start;
+        }
+        ++out;
+    }
+    out = sorted_set_impl::copy(a_start, a_end, out, set);
+    return sorted_set_impl::copy(b_start, b_end, out, set);
+}
+
+/// Store the elements in both ranges.  If one range is much
+/// smaller than the other then gallops through the larger range.
+template <class Iterator, class Out, class Is_Less, class Set>
+Out generic_set_intersection(Iterator a_start,
+                             Iterator a_end,
+                             Iterator b_start,
+                             Iterator b_end,
+                             Out out,
+                             Is_Less&& is_less,
+                             Set&& set) {
+    size_t a_len = a_end - a_start;
+    size_t b_len = b_end - b_start;
+    if (a_len * sorted_set_impl::gallop_ratio < b_len) {
+        return sorted_set_impl::gallop_intersection(a_start, a_end, b_start, b_end, out, is_less,
+                                                    set);
+    }
+    if (b_len * sorted_set_impl::gallop_ratio < a_len) {
+        return sorted_set_impl::gallop_intersection(b_start, b_end, a_start, a_end, out, is_less,
+                                                    set);
+    }
+
+    while (a_start < a_end && b_start < b_end) {
+        if (is_less(a_start, b_start)) {
+            ++a_start;
+        } else if (is_less(b_start, a_start)) {
+            ++b_start;
+        } else {
+            set(out, a_start);
+            ++out;
+            ++a_start;
+            ++b_start;
+        }
+    }
+    return out;
+}
+
+/// Store the elements in the first range that aren't in the second range.
+/// If the second range is much bigger than the first then gallops through it.
+template <class Iterator, class Out, class Is_Less, class Set>
+Out generic_set_difference(Iterator a_start,
+                           Iterator a_end,
+                           Iterator b_start,
+                           Iterator b_end,
+                           Out out,
+                           Is_Less&& is_less,
+                           Set&& set) {
+    size_t a_len = a_end - a_start;
+    size_t b_len = b_end - b_start;
+    bool gallop = a_len * sorted_set_impl::gallop_ratio < b_len;
+
+    while (a_start < a_end && b_start < b_end) {
+        if (gallop) {
+            b_start = sorted_set_impl::gallop(b_start, b_end, a_start, is_less);
+            if (!(b_start < b_end)) {
+                break;
+            }
+        }
+
+        if (is_less(a_start, b_start)) {
+            set(out, a_start);
+            ++out;
+            ++a_start;
+        } else if (is_less(b_start, a_start)) {
+            ++b_start;
+        } else {
+            ++a_start;
+            ++b_start;
+        }
+    }
+    return sorted_set_impl::copy(a_start, a_end, out, set);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Slice overloads
+////////////////////////////////////////////////////////////////////////////////
+
+/// Store the elements in `a` or `b` in `out`.  `out` must
+/// have room for `a.len + b.len` elements.  Returns the result.
+template <class T, class Is_Less, class Set>
+cz::Slice<T> set_union(cz::Slice<T> a, cz::Slice<T> b, T* out, Is_Less&& is_less, Set&& set) {
+    T* end = generic_set_union(a.start(), a.end(), b.start(), b.end(), out, is_less, set);
+    return {out, (size_t)(end - out)};
+}
+template <class T, class Is_Less>
+cz::Slice<T> set_union(cz::Slice<T> a, cz::Slice<T> b, T* out, Is_Less&& is_less) {
+    return set_union(a, b, out, is_less, generic_set_ptr<T>);
+}
+template <class T>
+cz::Slice<T> set_union(cz::Slice<T> a, cz::Slice<T> b, T* out) {
+    return set_union(a, b, out, generic_is_less_ptr<T>);
+}
+
+/// Store the elements in both `a` and `b` in `out`.  `out` must have room
+/// for the smaller of `a.len` and `b.len` elements.  Returns the result.
+template <class T, class Is_Less, class Set>
+cz::Slice<T> set_intersection(cz::Slice<T> a,
+                              cz::Slice<T> b,
+                              T* out,
+                              Is_Less&& is_less,
+                              Set&& set) {
+    T* end = generic_set_intersection(a.start(), a.end(), b.start(), b.end(), out, is_less, set);
+    return {out, (size_t)(end - out)};
+}
+template <class T, class Is_Less>
+cz::Slice<T> set_intersection(cz::Slice<T> a, cz::Slice<T> b, T* out, Is_Less&& is_less) {
+    return set_intersection(a, b, out, is_less, generic_set_ptr<T>);
+}
+template <class T>
+cz::Slice<T> set_intersection(cz::Slice<T> a, cz::Slice<T> b, T* out) {
+    return set_intersection(a, b, out, generic_is_less_ptr<T>);
+}
+
+/// Store the elements in `a` that aren't in `b` in `out`.  `out`
+/// must have room for `a.len` elements.  Returns the result.
+template <class T, class Is_Less, class Set>
+cz::Slice<T> set_difference(cz::Slice<T> a,
+                            cz::Slice<T> b,
+                            T* out,
+                            Is_Less&& is_less,
+                            Set&& set) {
+    T* end = generic_set_difference(a.start(), a.end(), b.start(), b.end(), out, is_less, set);
+    return {out, (size_t)(end - out)};
+}
+template <class T, class Is_Less>
+cz::Slice<T> set_difference(cz::Slice<T> a, cz::Slice<T> b, T* out, Is_Less&& is_less) {
+    return set_difference(a, b, out, is_less, generic_set_ptr<T>);
+}
+template <class T>
+cz::Slice<T> set_difference(cz::Slice<T> a, cz::Slice<T> b, T* out) {
+    return set_difference(a, b, out, generic_is_less_ptr<T>);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Integer overloads
+////////////////////////////////////////////////////////////////////////////////
+
+/// Faster versions of the above for integers.  When compiled with SSE2 or AVX2, the
+/// intersection and difference compare a block of `a` against a block of `b` at once.
+/// The union is a branchless merge.  Same requirements on `out` as above.
+cz::Slice<uint32_t> set_union(cz::Slice<uint32_t> a, cz::Slice<uint32_t> b, uint32_t* out);
+cz::Slice<uint64_t> set_union(cz::Slice<uint64_t> a, cz::Slice<uint64_t> b, uint64_t* out);
+cz::Slice<uint32_t> set_intersection(cz::Slice<uint32_t> a, cz::Slice<uint32_t> b, uint32_t* out);
+cz::Slice<uint64_t> set_intersection(cz::Slice<uint64_t> a, cz::Slice<uint64_t> b, uint64_t* out);
+cz::Slice<uint32_t> set_difference(cz::Slice<uint32_t> a, cz::Slice<uint32_t> b, uint32_t* out);
+cz::Slice<uint64_t> set_difference(cz::Slice<uint64_t> a, cz::Slice<uint64_t> b, uint64_t* out);
+
+}
@@ -1,30 +1,35 @@
 #pragma once
 
+#include <stdint.h>
 #include <cz/allocator.hpp>
 #include <cz/str.hpp>
-#include "bit_array.hpp"
 #include "hash.hpp"
 #include "next_power_of_two.hpp"
 
 namespace cz {
 
-template <class Value>
+template <class Value, class Hasher = Str_Hasher>
 struct Str_Map {
     cz::Str* keys;
     Value* values;
-    Bit_Array _masks;
+    /// The hash of each present key.  Used to reinsert keys without rehashing them.
+    Hash* hashes;
+    /// One byte per slot.  Zero if the slot is empty.  Otherwise the top 7 bits of the hash with
+    /// the high bit set so probes can skip most mismatches without touching the key's memory.
+    uint8_t* _metadata;
     size_t cap;
     size_t count;
 
     void drop(cz::Allocator allocator) {
         allocator.dealloc({keys, sizeof(cz::Str) * cap});
         allocator.dealloc({values, sizeof(Value) * cap});
-        _masks.drop(allocator, cap);
+        allocator.dealloc({hashes, sizeof(Hash) * cap});
+        allocator.dealloc({_metadata, cap});
     }
 
     void reserve(cz::Allocator allocator, size_t extra) {
         if (count + extra + cap / 4 >= cap) {
-            Str_Map<Value> new_this;
+            Str_Map new_this;
             new_this.cap = next_power_of_two(count + extra);
             new_this.count = 0;
 
@@ -32,33 +37,37 @@ struct Str_Map {
                 allocator.alloc({sizeof(cz::Str) * new_this.cap, alignof(cz::Str)}));
             new_this.values = static_cast<Value*>(
                 allocator.alloc({sizeof(Value) * new_this.cap, alignof(Value)}));
-            new_this._masks.init(allocator, new_this.cap);
+            new_this.hashes = static_cast<Hash*>(
+                allocator.alloc({sizeof(Hash) * new_this.cap, alignof(Hash)}));
+            new_this._metadata = allocator.alloc_zeroed<uint8_t>(new_this.cap);
 
             CZ_ASSERT(new_this.keys);
             CZ_ASSERT(new_this.values);
+            CZ_ASSERT(new_this.hashes);
+            CZ_ASSERT(new_this._metadata);
 
             if (count != 0) {
                 for (size_t i = 0; i < cap; ++i) {
                     if (is_present(i)) {
-                        new_this.insert_hash(keys[i], values[i]);
+                        new_this.insert(keys[i], hashes[i], values[i]);
                     }
                 }
             }
 
             if (cap != 0) {
-                allocator.dealloc({keys, sizeof(cz::Str) * cap});
-                allocator.dealloc({values, sizeof(Value) * cap});
-                _masks.drop(allocator, cap);
+                drop(allocator);
             }
 
             *this = new_this;
         }
     }
 
-    bool is_present(size_t index) const { return _masks.get(index); }
-    void set_present(size_t index) { return _masks.set(index); }
+    bool is_present(size_t index) const { return _metadata[index] != 0; }
 
-    static Hash hash(cz::Str key) { return ::cz::hash(key, 0x7521AB297521AB29); }
+    /// The metadata byte stored for a present key with the given hash.
+    static uint8_t metadata_tag(Hash hash) { return 0x80 | (uint8_t)(hash >> 57); }
+
+    static Hash hash(cz::Str key) { return Hasher()(key); }
 
     Value* get_hash(cz::Str key) { return get(key, hash(key)); }
 
@@ -73,18 +82,20 @@ struct Str_Map {
         size_t index = hash & (cap - 1);
         CZ_DEBUG_ASSERT(index == (hash % cap));
 
+        uint8_t tag = metadata_tag(hash);
         for (size_t offset = 0; offset < count; ++offset) {
-            if (is_present(index)) {
-                if (keys[index] == key) {
-                    return &values[index];
-                } else {
-                    ++index;
-                    index &= cap - 1;
-                    CZ_DEBUG_ASSERT(((hash + offset + 1) % cap) == index);
-                }
-            } else {
+            uint8_t metadata = _metadata[index];
+            if (metadata == 0) {
                 break;
             }
+
+            if (metadata == tag && hashes[index] == hash && keys[index] == key) {
+                return &values[index];
+            }
+
+            ++index;
+            index &= cap - 1;
+            CZ_DEBUG_ASSERT(((hash + offset + 1) % cap) == index);
         }
         return nullptr;
     }
@@ -106,7 +117,8 @@ struct Str_Map {
             } else {
                 keys[index] = key;
                 values[index] = value;
-                set_present(index);
+                hashes[index] = hash;
+                _metadata[index] = metadata_tag(hash);
                 ++count;
                 break;
             }
@@ -8,10 +8,17 @@
 
 namespace cz {
 
-template <class Value>
+/// A `Str_Map` that supports removing keys.
+///
+/// Removal uses backward shift deletion: later entries in the probe chain are moved
+/// back to fill the hole.  Thus there are no tombstones and probe chains don't grow
+/// under repeated insertions and removals.
+template <class Value, class Hasher = Str_Hasher>
 struct Str_Map_Removable {
     cz::Str* keys;
     Value* values;
+    /// The hash of each present key.  Used to move keys without rehashing them.
+    Hash* hashes;
     Bit_Array _masks;
     size_t cap;
     size_t count;
@@ -19,12 +26,13 @@ struct Str_Map_Removable {
     void drop(cz::Allocator allocator) {
         allocator.dealloc({keys, sizeof(cz::Str) * cap});
         allocator.dealloc({values, sizeof(Value) * cap});
-        _masks.drop(allocator, 2 * cap);
+        allocator.dealloc({hashes, sizeof(Hash) * cap});
+        _masks.drop(allocator, cap);
     }
 
     void reserve(cz::Allocator allocator, size_t extra) {
         if (count + extra + cap / 4 >= cap) {
-            Str_Map_Removable<Value> new_this;
+            Str_Map_Removable new_this;
             new_this.cap = next_power_of_two(count + extra);
             new_this.count = 0;
 
@@ -32,60 +40,54 @@ struct Str_Map_Removable {
                 allocator.alloc({sizeof(cz::Str) * new_this.cap, alignof(cz::Str)}));
             new_this.values = static_cast<Value*>(
                 allocator.alloc({sizeof(Value) * new_this.cap, alignof(Value)}));
-            new_this._masks.init(allocator, 2 * new_this.cap);
+            new_this.hashes = static_cast<Hash*>(
+                allocator.alloc({sizeof(Hash) * new_this.cap, alignof(Hash)}));
+            new_this._masks.init(allocator, new_this.cap);
 
             CZ_ASSERT(new_this.keys);
             CZ_ASSERT(new_this.values);
+            CZ_ASSERT(new_this.hashes);
 
             if (count != 0) {
                 for (size_t i = 0; i < cap; ++i) {
                     if (is_present(i)) {
-                        new_this.insert_hash(keys[i], values[i]);
+                        new_this.insert(keys[i], hashes[i], values[i]);
                     }
                 }
             }
 
             if (cap != 0) {
-                allocator.dealloc({keys, sizeof(cz::Str) * cap});
-                allocator.dealloc({values, sizeof(Value) * cap});
-                _masks.drop(allocator, 2 * cap);
+                drop(allocator);
             }
 
             *this = new_this;
         }
     }
 
-    bool is_present(size_t index) const { return _masks.get(2 * index); }
-    bool is_tombstone(size_t index) const { return _masks.get(2 * index + 1); }
+    bool is_present(size_t index) const { return _masks.get(index); }
+    void set_present(size_t index) { _masks.set(index); }
+    void set_removed(size_t index) { _masks.unset(index); }
 
-    void set_present(size_t index) {
-        _masks.set(2 * index);
-        _masks.unset(2 * index + 1);
-    }
-    void set_tombstone(size_t index) {
-        _masks.unset(2 * index);
-        _masks.set(2 * index + 1);
-    }
-
-    static Hash hash(cz::Str key) { return ::cz::hash(key, 0x7521AB297521AB29); }
+    static Hash hash(cz::Str key) { return Hasher()(key); }
 
     bool index_of(cz::Str key, Hash hash, size_t* out) const {
+        if (count == 0) {
+            return false;
+        }
+
         size_t index = hash & (cap - 1);
         CZ_DEBUG_ASSERT(index == (hash % cap));
 
         for (size_t offset = 0; offset < count; ++offset) {
             if (is_present(index)) {
-                if (keys[index] == key) {
+                if (hashes[index] == hash && keys[index] == key) {
                     *out = index;
                     return true;
                 } else {
-                cont:
                     ++index;
                     index &= cap - 1;
                     CZ_DEBUG_ASSERT(((hash + offset + 1) % cap) == index);
                 }
-            } else if (is_tombstone(index)) {
-                goto cont;
             } else {
                 break;
             }
@@ -111,16 +113,37 @@ struct Str_Map_Removable {
         }
     }
 
-    Value* remove_hash(cz::Str key) { return remove(key, hash(key)); }
+    bool remove_hash(cz::Str key) { return remove(key, hash(key)); }
 
     bool remove(cz::Str key, Hash hash) {
-        size_t index;
-        if (index_of(key, hash, &index)) {
-            set_tombstone(index);
-            return true;
-        } else {
+        size_t hole;
+        if (!index_of(key, hash, &hole)) {
             return false;
         }
+
+        // Move later entries in the chain back into the hole.  An entry can only
+        // be moved if its home slot is not in the range (hole, index] as otherwise
+        // it would end up before its home slot and be unreachable.
+        size_t mask = cap - 1;
+        size_t index = hole;
+        while (1) {
+            index = (index + 1) & mask;
+            if (!is_present(index)) {
+                break;
+            }
+
+            size_t home = hashes[index] & mask;
+            if (((index - home) & mask) >= ((index - hole) & mask)) {
+                keys[hole] = keys[index];
+                values[hole] = values[index];
+                hashes[hole] = hashes[index];
+                hole = index;
+            }
+        }
+
+        set_removed(hole);
+        --count;
+        return true;
     }
 
     void insert_hash(cz::Str key, const Value& value) { insert(key, hash(key), value); }
@@ -140,6 +163,7 @@ struct Str_Map_Removable {
             } else {
                 keys[index] = key;
                 values[index] = value;
+                hashes[index] = hash;
                 set_present(index);
                 ++count;
                 break;
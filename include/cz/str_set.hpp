@@ -8,7 +8,9 @@
 
 namespace cz {
 
-struct Str_Set {
+/// A set of strings.  `Hasher` is a function object that hashes a `cz::Str`.
+template <class Hasher>
+struct Basic_Str_Set {
     cz::Str* keys;
     Bit_Array _masks;
     size_t cap;
@@ -21,7 +23,7 @@ struct Str_Set {
 
     void reserve(cz::Allocator allocator, size_t extra) {
         if (count + extra + cap / 4 >= cap) {
-            Str_Set new_this;
+            Basic_Str_Set new_this;
             new_this.cap = next_power_of_two(count + extra);
             new_this.count = 0;
 
@@ -54,7 +56,7 @@ struct Str_Set {
 
     void clear() { _masks.clear(cap); }
 
-    static Hash hash(cz::Str key) { return ::cz::hash(key, 0x7521AB297521AB29); }
+    static Hash hash(cz::Str key) { return Hasher()(key); }
 
     cz::Str* get_hash(cz::Str key) { return get(key, hash(key)); }
 
@@ -136,4 +138,6 @@ struct Str_Set {
     }
 };
 
+using Str_Set = Basic_Str_Set<Str_Hasher>;
+
 }
@@ -7,5 +7,20 @@ namespace sys {
 
 size_t page_size();
 
+/// Reserve `size` bytes of address space without backing it with memory.  The
+/// memory cannot be accessed until it is committed.  Returns `nullptr` on failure.
+void* reserve_memory(size_t size);
+
+/// Back a page aligned range of reserved memory with readable and
+/// writable memory.  Pages are zeroed.  Returns `false` on failure.
+bool commit_memory(void* start, size_t size);
+
+/// Give the pages in a page aligned range of committed memory back
+/// to the operating system.  The range remains reserved.
+void decommit_memory(void* start, size_t size);
+
+/// Release an entire range allocated via `reserve_memory`.
+void release_memory(void* start, size_t size);
+
 }
 }
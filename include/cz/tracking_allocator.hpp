@@ -0,0 +1,113 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "allocator.hpp"
+#include "mutex.hpp"
+#include "source_location.hpp"
+
+namespace cz {
+
+struct String;
+struct Tracking_Allocator;
+
+/// A snapshot of the statistics collected by a `Tracking_Allocator`.
+struct Allocation_Stats {
+    /// `histogram[i]` counts allocations where `2^(i-1) < size <= 2^i`.  The
+    /// last bucket also counts all allocations larger than its range.
+    static constexpr const size_t num_buckets = 32;
+
+    size_t live_bytes;
+    size_t peak_bytes;
+    size_t live_allocations;
+
+    uint64_t total_allocations;
+    uint64_t total_reallocations;
+    uint64_t total_deallocations;
+
+    uint64_t histogram[num_buckets];
+
+    /// The histogram bucket that `size` falls into.
+    static size_t bucket(size_t size);
+};
+
+/// A call site that allocates via a `Tracking_Allocator`.
+struct Tracking_Site {
+    Tracking_Allocator* tracker;
+    SourceLocation location;
+
+    size_t live_bytes;
+    size_t live_allocations;
+
+    Tracking_Site* next;
+};
+
+/// An allocator that wraps the `backer` and records statistics about the allocations
+/// passing through it.  Use this to find out how much memory each subsystem uses and to
+/// size arenas and `Buffer_Array`s based on real data.  It is thread safe if the `backer` is.
+///
+/// If `track_sites` is `true` then the allocator also remembers the call site of each
+/// outstanding allocation.  Call sites are passed via `allocator(CZ_SOURCE_LOCATION)`.
+/// Finding the site is a linear search so cache the `Allocator` in hot code.
+///
+/// The `Tracking_Allocator` must not be moved after `init` is called.
+///
+/// # Example
+///
+/// ```
+/// cz::Tracking_Allocator tracker;
+/// tracker.init(cz::heap_allocator(), /*track_sites=*/true);
+/// CZ_DEFER(tracker.drop());
+///
+/// cz::Vector<int> vector = {};
+/// vector.reserve(tracker.allocator(CZ_SOURCE_LOCATION), 100);
+///
+/// cz::print(tracker.stats());
+/// cz::Heap_String leaks = {};
+/// tracker.append_live_sites(cz::heap_allocator(), &leaks);
+/// ```
+struct Tracking_Allocator {
+    Allocator backer;
+    bool track_sites;
+
+    Mutex mutex;
+    Allocation_Stats _stats;
+
+    /// Allocations made via `allocator()` without a location.
+    Tracking_Site unknown_site;
+
+    /// Outstanding allocations (pointer -> site) in an open addressing table.
+    void** _record_keys;
+    Tracking_Site** _record_sites;
+    size_t _records_cap;
+    size_t _records_count;
+
+    void init(Allocator backer, bool track_sites = false);
+    void drop();
+
+    /// Get an allocator that doesn't record the call site.
+    Allocator allocator() {
+        return {Tracking_Allocator::realloc, Tracking_Allocator::dealloc, &unknown_site,
+                Tracking_Allocator::expand_in_place};
+    }
+    /// Get an allocator that attributes allocations to `location`.
+    Allocator allocator(SourceLocation location);
+
+    /// Take a snapshot of the statistics.
+    Allocation_Stats stats();
+
+    /// Reset the peak to the current number of live bytes.
+    void reset_peak();
+
+    /// Append a line for each call site with outstanding allocations.
+    void append_live_sites(Allocator allocator, String* string);
+
+    static void* realloc(void* site, MemSlice old_mem, AllocInfo new_info);
+    static void dealloc(void* site, MemSlice old_mem);
+    static bool expand_in_place(void* site, MemSlice old_mem, size_t new_size);
+};
+
+/// Format the statistics as a multi line report.
+void append(Allocator allocator, String* string, const Allocation_Stats& stats);
+
+}
@@ -2,6 +2,13 @@
 
 #include <utility>
 
+/// Hint that `cond` is almost always false so the compiler moves the branch out of the hot path.
+#if defined(__GNUC__) || defined(__clang__)
+#define CZ_UNLIKELY(cond) __builtin_expect(!!(cond), 0)
+#else
+#define CZ_UNLIKELY(cond) (cond)
+#endif
+
 namespace cz {
 
 using std::swap;
@@ -2,6 +2,7 @@
 
 #include "allocator.hpp"
 #include "assert.hpp"
+#include "growth_policy.hpp"
 #include "next_power_of_two.hpp"
 #include "slice.hpp"
 #include "util.hpp"
@@ -38,8 +39,30 @@ struct Vector {
     ///
 
     /// Ensure there are `extra` spaces available.  Amortizing expansion.
-    void reserve(Allocator allocator, size_t extra) { reserve_total(allocator, len + extra); }
-    void reserve_total(Allocator allocator, size_t total);
+    ///
+    /// `policy` decides the new capacity (see `growth_policy.hpp`).  If the
+    /// allocator supports it, the buffer is expanded in place instead of copied.
+    void reserve(Allocator allocator,
+                 size_t extra,
+                 Growth_Policy policy = default_growth_policy) {
+        reserve_total(allocator, len + extra, policy);
+    }
+    void reserve_total(Allocator allocator,
+                       size_t total,
+                       Growth_Policy policy = default_growth_policy) {
+        if (CZ_UNLIKELY(cap < total)) {
+            size_t new_cap = policy(cap, total, sizeof(T));
+            CZ_DEBUG_ASSERT(new_cap >= total);
+
+            // Avoid copying if the allocator can expand the buffer in place.
+            if (!allocator.try_expand_in_place(elems, cap, new_cap)) {
+                T* new_elems = allocator.realloc(elems, cap, new_cap);
+                CZ_ASSERT(new_elems != nullptr);
+                elems = new_elems;
+            }
+            cap = new_cap;
+        }
+    }
 
     /// Ensure there are `extra` spaces available.  Exact expansion.
     void reserve_exact(Allocator allocator, size_t extra) {
@@ -266,18 +289,6 @@ static void realloc_new_cap(Vector<T>* vector, Allocator allocator, size_t new_c
     vector->cap = new_cap;
 }
 
-template <class T>
-void Vector<T>::reserve_total(Allocator allocator, size_t total) {
-    if (cap < total) {
-        size_t new_cap = next_power_of_two(total - 1);
-        if (new_cap < 8) {
-            new_cap = 8;
-        }
-
-        realloc_new_cap(this, allocator, new_cap);
-    }
-}
-
 template <class T>
 void Vector<T>::reserve_exact_total(Allocator allocator, size_t total) {
     if (cap < total) {
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <stddef.h>
+#include "allocator.hpp"
+#include "arena.hpp"
+
+namespace cz {
+
+/// A `Virtual_Arena` is an `Arena` backed by a huge range of reserved address space.
+/// Pages are committed lazily as the arena grows so the arena only uses as much memory
+/// as has been allocated.  Because the address range never moves, pointers are stable
+/// and the most recent allocation can always be expanded in place.  For example,
+/// a `Vector` that is the last allocation in the arena never needs to be copied.
+///
+/// `clear` gives the committed pages back to the operating system so
+/// that the process's memory usage goes back down between batches.
+///
+/// # Example
+///
+/// ```
+/// cz::Virtual_Arena arena;
+/// CZ_ASSERT(arena.init((size_t)64 << 30));
+/// CZ_DEFER(arena.drop());
+///
+/// for (size_t i = 0; i < batches.len; ++i) {
+///     process(batches[i], arena.allocator());
+///     arena.clear();
+/// }
+/// ```
+struct Virtual_Arena {
+    /// `arena.end` is the end of the committed memory.
+    Arena arena;
+    char* reserved_end;
+
+    /// Memory is committed in multiples of this size to reduce the number of system calls.
+    static constexpr const size_t commit_granularity = 0x10000;
+
+    /// Reserve `reserve_size` bytes of address space.  No memory is
+    /// committed until it is allocated.  Returns `false` on failure.
+    bool init(size_t reserve_size);
+    /// Release the address space.
+    void drop();
+
+    Allocator allocator() {
+        return {Virtual_Arena::realloc, Virtual_Arena::dealloc, this,
+                Virtual_Arena::expand_in_place};
+    }
+
+    /// The number of bytes that could still be allocated.
+    size_t remaining() const { return reserved_end - arena.pointer; }
+    /// The number of bytes currently backed by memory.
+    size_t committed() const { return arena.end - arena.start; }
+
+    /// Deallocate all allocations and decommit all pages.
+    void clear();
+
+    /// Decommit the pages after the most recent allocation.
+    void decommit_unused();
+
+    /// A save point allows you to instantly deallocate all allocations
+    /// made after `save` is called just by calling `restore`.
+    struct Save_Point {
+        char* pointer;
+    };
+    Save_Point save() const { return {arena.pointer}; }
+    void restore(Save_Point sp) { arena.pointer = sp.pointer; }
+
+    static void* realloc(void* arena, MemSlice old_mem, AllocInfo new_info);
+    static void dealloc(void* arena, MemSlice old_mem);
+    /// Commits more pages as needed so the most recent allocation
+    /// can always be expanded up to the end of the reserved range.
+    static bool expand_in_place(void* arena, MemSlice old_mem, size_t new_size);
+};
+
+}
@@ -40,6 +40,24 @@ void* Allocator::realloc(MemSlice old_mem, AllocInfo new_info) const {
     }
     return ptr;
 }
+
+bool Allocator::try_expand_in_place(MemSlice old_mem, size_t new_size) const {
+    if (!expand_in_place || !old_mem.buffer) {
+        return false;
+    }
+
+    // Unlike `realloc`, only fill the memory once the resize succeeds
+    // since callers keep using `old_mem` if it fails.
+    if (!expand_in_place(data, old_mem, new_size)) {
+        return false;
+    }
+    if (new_size > old_mem.size) {
+        memset((char*)old_mem.buffer + old_mem.size, alloc_fill, new_size - old_mem.size);
+    } else {
+        memset((char*)old_mem.buffer + new_size, dealloc_fill, old_mem.size - new_size);
+    }
+    return true;
+}
 #endif
 
 }
@@ -4,6 +4,7 @@
 #include <cz/alloc_utils.hpp>
 #include <cz/allocator.hpp>
 #include <cz/assert.hpp>
+#include <cz/util.hpp>
 
 namespace cz {
 
@@ -13,7 +14,7 @@ void* Arena::realloc(void* _arena, MemSlice old_mem, AllocInfo new_info) {
     CZ_DEBUG_ASSERT(arena->pointer >= arena->start);
     CZ_DEBUG_ASSERT(arena->pointer <= arena->end);
     CZ_DEBUG_ASSERT(old_mem.buffer == nullptr || old_mem.start() >= arena->start);
-    CZ_DEBUG_ASSERT(old_mem.buffer == nullptr || old_mem.end() >= arena->pointer);
+    CZ_DEBUG_ASSERT(old_mem.buffer == nullptr || old_mem.end() <= arena->pointer);
 
     if (old_mem.end() == arena->pointer) {
         // Realloc in place.
@@ -29,19 +30,37 @@ void* Arena::realloc(void* _arena, MemSlice old_mem, AllocInfo new_info) {
         void* ptr = advance_ptr_to_alignment(current, new_info);
         if (ptr) {
             arena->pointer = (char*)ptr + new_info.size;
-            memcpy(ptr, old_mem.buffer, old_mem.size);
+            if (old_mem.buffer) {
+                memcpy(ptr, old_mem.buffer, cz::min(old_mem.size, new_info.size));
+            }
         }
         return ptr;
     }
 }
 
+bool Arena::expand_in_place(void* _arena, MemSlice old_mem, size_t new_size) {
+    Arena* arena = (Arena*)_arena;
+    CZ_DEBUG_ASSERT(old_mem.start() >= arena->start);
+    CZ_DEBUG_ASSERT(old_mem.end() <= arena->pointer);
+
+    if (old_mem.end() != arena->pointer) {
+        return new_size <= old_mem.size;
+    }
+
+    if (new_size > (size_t)(arena->end - (char*)old_mem.buffer)) {
+        return false;
+    }
+    arena->pointer = (char*)old_mem.buffer + new_size;
+    return true;
+}
+
 void Arena::dealloc(void* _arena, MemSlice old_mem) {
     Arena* arena = (Arena*)_arena;
     CZ_DEBUG_ASSERT(arena->start != nullptr);
     CZ_DEBUG_ASSERT(arena->pointer >= arena->start);
     CZ_DEBUG_ASSERT(arena->pointer <= arena->end);
     CZ_DEBUG_ASSERT(old_mem.buffer == nullptr || old_mem.start() >= arena->start);
-    CZ_DEBUG_ASSERT(old_mem.buffer == nullptr || old_mem.end() >= arena->pointer);
+    CZ_DEBUG_ASSERT(old_mem.buffer == nullptr || old_mem.end() <= arena->pointer);
 
     // Only deallocate the last allocation.
     if (old_mem.end() == arena->pointer) {
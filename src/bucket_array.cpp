@@ -0,0 +1 @@
+#include <cz/bucket_array.hpp>
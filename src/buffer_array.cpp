@@ -10,26 +10,32 @@
 
 namespace cz {
 
-constexpr const size_t Buffer_Array::buffer_size;
+constexpr const size_t Buffer_Array::default_buffer_size;
+
+void Buffer_Array::init(size_t buffer_size, size_t max_buffer_size) {
+    this->buffer_size = buffer_size;
+    this->max_buffer_size = std::max(buffer_size, max_buffer_size);
 
-void Buffer_Array::init() {
     num_buffers = 4;
 
-    buffers = cz::heap_allocator().alloc_zeroed<char*>(num_buffers);
+    buffers = cz::heap_allocator().alloc<MemSlice>(num_buffers);
     CZ_ASSERT(buffers);
+    for (size_t i = 1; i < num_buffers; ++i) {
+        buffers[i] = {};
+    }
 
-    char* buffer = cz::heap_allocator().alloc<char>(Buffer_Array::buffer_size);
+    char* buffer = cz::heap_allocator().alloc<char>(buffer_size);
     CZ_ASSERT(buffer);
-    buffers[0] = buffer;
+    buffers[0] = {buffer, buffer_size};
 
     buffer_index = 0;
     buffer_pointer = buffer;
-    buffer_end = buffer + Buffer_Array::buffer_size;
+    buffer_end = buffer + buffer_size;
 }
 
 void Buffer_Array::drop() {
     for (size_t i = 0; i < num_buffers; ++i) {
-        cz::heap_allocator().dealloc({buffers[i], Buffer_Array::buffer_size});
+        cz::heap_allocator().dealloc(buffers[i]);
     }
     cz::heap_allocator().dealloc(buffers, num_buffers);
 }
@@ -48,7 +54,8 @@ static char* get_starting_point(Buffer_Array* buffer_array, MemSlice old_mem) {
             // (scoped allocation/deallocation) will typically do the trick.
 
             // Assert we're not skipping any allocations in this buffer.
-            if (buffer_array->buffer_pointer != buffer_array->buffers[buffer_array->buffer_index]) {
+            if (buffer_array->buffer_pointer !=
+                buffer_array->buffers[buffer_array->buffer_index].buffer) {
                 CZ_PANIC("Deallocation would skip allocated items");
             }
 
@@ -58,28 +65,19 @@ static char* get_starting_point(Buffer_Array* buffer_array, MemSlice old_mem) {
             }
 
             // Assert we are in bounds of the previous buffer.
-            char* buffer_start = buffer_array->buffers[buffer_array->buffer_index - 1];
-            if (old_mem.buffer < buffer_start ||
-                old_mem.buffer >= buffer_start + Buffer_Array::buffer_size) {
+            MemSlice previous = buffer_array->buffers[buffer_array->buffer_index - 1];
+            if (old_mem.buffer < previous.start() || old_mem.buffer >= previous.end()) {
                 CZ_PANIC("Dealloc called with invalid pointer");
             }
         }
 #endif
 
-        char* buffer_start = buffer_array->buffers[buffer_array->buffer_index - 1];
+        MemSlice previous = buffer_array->buffers[buffer_array->buffer_index - 1];
 
         // Retreat to the previous buffer.
         --buffer_array->buffer_index;
         buffer_array->buffer_pointer = (char*)old_mem.end();
-
-        // Calculate the buffer end.
-        if (old_mem.size > Buffer_Array::buffer_size) {
-            // We have a massive allocation that has its own buffer.
-            CZ_DEBUG_ASSERT(old_mem.buffer == buffer_start);
-            buffer_array->buffer_end = buffer_start + old_mem.size;
-        } else {
-            buffer_array->buffer_end = buffer_start + Buffer_Array::buffer_size;
-        }
+        buffer_array->buffer_end = (char*)previous.end();
     }
 
     return starting_point;
@@ -124,34 +122,50 @@ void* Buffer_Array::realloc(void* _buffer_array, MemSlice old_mem, AllocInfo new
 
     // Expand the outer array in preparation for adding the new buffer.
     if (buffer_array->buffer_index + 1 == buffer_array->num_buffers) {
-        char** new_buffers = cz::heap_allocator().realloc(
+        MemSlice* new_buffers = cz::heap_allocator().realloc(
             buffer_array->buffers, buffer_array->num_buffers, buffer_array->num_buffers * 2);
         CZ_ASSERT(new_buffers);
-        memset(new_buffers + buffer_array->num_buffers, 0,
-               buffer_array->num_buffers * sizeof(*buffer_array->buffers));
+        for (size_t i = buffer_array->num_buffers; i < buffer_array->num_buffers * 2; ++i) {
+            new_buffers[i] = {};
+        }
         buffer_array->buffers = new_buffers;
         buffer_array->num_buffers *= 2;
     }
 
-    // Allocate the new buffer.
-    size_t this_buffer_size = std::max(Buffer_Array::buffer_size, new_info.size);
-    char* buffer = (char*)cz::heap_allocator().alloc({this_buffer_size, new_info.alignment});
-    CZ_ASSERT(buffer);
+    MemSlice* slot = &buffer_array->buffers[buffer_array->buffer_index + 1];
+
+    // Reuse the next buffer if it was kept by `restore` and is big enough.
+    ptr = advance_ptr_to_alignment(*slot, new_info);
+    if (!ptr) {
+        cz::heap_allocator().dealloc(*slot);
+
+        // Allocate the new buffer.
+        size_t this_buffer_size = std::max(buffer_array->buffer_size, new_info.size);
+        char* buffer = (char*)cz::heap_allocator().alloc({this_buffer_size, new_info.alignment});
+        CZ_ASSERT(buffer);
+        *slot = {buffer, this_buffer_size};
+        ptr = buffer;
+
+        // Grow the size of future buffers.
+        if (buffer_array->buffer_size < buffer_array->max_buffer_size) {
+            buffer_array->buffer_size =
+                std::min(buffer_array->buffer_size * 2, buffer_array->max_buffer_size);
+        }
+    }
 
     // Add it to the array.
     ++buffer_array->buffer_index;
-    buffer_array->buffers[buffer_array->buffer_index] = buffer;
-    buffer_array->buffer_pointer = buffer + new_info.size;
-    buffer_array->buffer_end = buffer + this_buffer_size;
+    buffer_array->buffer_pointer = (char*)ptr + new_info.size;
+    buffer_array->buffer_end = (char*)slot->end();
 
     // Copy over the old contents if applicable.
     if (old_mem.buffer) {
         // We have to be expanding because otherwise we would've shrunk in place.
         CZ_DEBUG_ASSERT(old_mem.size < new_info.size);
-        memcpy(buffer, old_mem.buffer, old_mem.size);
+        memcpy(ptr, old_mem.buffer, old_mem.size);
     }
 
-    return buffer;
+    return ptr;
 }
 
 void Buffer_Array::restore(Save_Point sp) {
@@ -160,24 +174,19 @@ void Buffer_Array::restore(Save_Point sp) {
 
     // Fill each buffer that is completely deallocated.
     for (size_t i = sp.outer + 1; i <= buffer_index; ++i) {
-        memset(buffers[i], dealloc_fill, Buffer_Array::buffer_size);
+        memset(buffers[i].buffer, dealloc_fill, buffers[i].size);
     }
 
     // Fill the rest of this buffer.
-    if (sp.inner < Buffer_Array::buffer_size) {
-        memset(buffers[sp.outer] + sp.inner, dealloc_fill, Buffer_Array::buffer_size - sp.inner);
+    if (sp.inner < buffers[sp.outer].size) {
+        memset((char*)buffers[sp.outer].buffer + sp.inner, dealloc_fill,
+               buffers[sp.outer].size - sp.inner);
     }
 #endif
 
     buffer_index = sp.outer;
-    buffer_pointer = buffers[sp.outer] + sp.inner;
-    buffer_end = buffers[sp.outer] + Buffer_Array::buffer_size;
-
-    // If we are restoring to the point after a large
-    // allocation then the size is larger than buffer_size.
-    if (buffer_pointer > buffer_end) {
-        buffer_end = buffer_pointer;
-    }
+    buffer_pointer = (char*)buffers[sp.outer].buffer + sp.inner;
+    buffer_end = (char*)buffers[sp.outer].end();
 }
 
 }
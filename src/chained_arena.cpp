@@ -0,0 +1,183 @@
+#include <cz/chained_arena.hpp>
+
+#include <string.h>
+#include <cz/alloc_utils.hpp>
+#include <cz/assert.hpp>
+#include <cz/util.hpp>
+
+namespace cz {
+
+static char* block_start(Chained_Arena_Block* block) {
+    return (char*)(block + 1);
+}
+static char* block_end(Chained_Arena_Block* block) {
+    return (char*)block + block->size;
+}
+
+void Chained_Arena::init(Allocator backer, size_t first_block_size) {
+    this->backer = backer;
+    this->first_block_size = first_block_size;
+    first = nullptr;
+    current = nullptr;
+    pointer = nullptr;
+    end = nullptr;
+}
+
+static void dealloc_blocks(Allocator backer, Chained_Arena_Block* block) {
+    while (block) {
+        Chained_Arena_Block* next = block->next;
+        backer.dealloc({block, block->size});
+        block = next;
+    }
+}
+
+void Chained_Arena::drop() {
+    dealloc_blocks(backer, first);
+}
+
+void Chained_Arena::trim() {
+    if (current) {
+        dealloc_blocks(backer, current->next);
+        current->next = nullptr;
+    } else {
+        dealloc_blocks(backer, first);
+        first = nullptr;
+    }
+}
+
+void Chained_Arena::restore(Save_Point sp) {
+    Chained_Arena_Block* block = sp.block;
+    char* new_pointer = sp.pointer;
+    if (!block) {
+        block = first;
+        new_pointer = block ? block_start(block) : nullptr;
+    }
+
+#ifndef NDEBUG
+    const unsigned char dealloc_fill = 0xDD;
+
+    if (block) {
+        CZ_DEBUG_ASSERT(new_pointer >= block_start(block));
+        CZ_DEBUG_ASSERT(new_pointer <= block_end(block));
+
+        // Fill the rest of this block and each block that is completely deallocated.
+        memset(new_pointer, dealloc_fill, block_end(block) - new_pointer);
+        if (block != current) {
+            for (Chained_Arena_Block* b = block->next;; b = b->next) {
+                CZ_DEBUG_ASSERT(b);
+                memset(block_start(b), dealloc_fill, block_end(b) - block_start(b));
+                if (b == current) {
+                    break;
+                }
+            }
+        }
+    }
+#endif
+
+    current = block;
+    pointer = new_pointer;
+    end = block ? block_end(block) : nullptr;
+}
+
+/// Move to the next block, allocating it if necessary, such that `info` can be allocated.
+static bool next_block(Chained_Arena* arena, AllocInfo info) {
+    // Reserve enough space that the allocation will fit regardless of padding.
+    size_t needed = sizeof(Chained_Arena_Block) + info.size + info.alignment;
+
+    Chained_Arena_Block* next = arena->current ? arena->current->next : arena->first;
+    Chained_Arena_Block* block;
+    if (next && next->size >= needed) {
+        // Reuse a block kept by `restore`.
+        block = next;
+    } else {
+        size_t size = arena->current ? arena->current->size * 2 : arena->first_block_size;
+        size = cz::max(size, needed);
+
+        block = (Chained_Arena_Block*)arena->backer.alloc({size, alignof(max_align_t)});
+        if (!block) {
+            return false;
+        }
+
+        // Insert the block before any unused blocks.
+        block->size = size;
+        block->next = next;
+        if (arena->current) {
+            arena->current->next = block;
+        } else {
+            arena->first = block;
+        }
+    }
+
+    arena->current = block;
+    arena->pointer = block_start(block);
+    arena->end = block_end(block);
+    return true;
+}
+
+void* Chained_Arena::realloc(void* _arena, MemSlice old_mem, AllocInfo new_info) {
+    Chained_Arena* arena = (Chained_Arena*)_arena;
+    CZ_DEBUG_ASSERT(arena->pointer <= arena->end);
+
+    if (old_mem.buffer && old_mem.end() == arena->pointer) {
+        // Realloc in place.
+        MemSlice current = {old_mem.buffer, (size_t)(arena->end - (char*)old_mem.buffer)};
+        void* ptr = advance_ptr_to_alignment(current, new_info);
+        if (ptr) {
+            arena->pointer = (char*)ptr + new_info.size;
+            if (ptr != old_mem.buffer) {
+                memmove(ptr, old_mem.buffer, cz::min(old_mem.size, new_info.size));
+            }
+            return ptr;
+        }
+    } else {
+        // Allocate at the end of the current block.
+        MemSlice current = {arena->pointer, (size_t)(arena->end - arena->pointer)};
+        void* ptr = advance_ptr_to_alignment(current, new_info);
+        if (ptr) {
+            arena->pointer = (char*)ptr + new_info.size;
+            if (old_mem.buffer) {
+                memcpy(ptr, old_mem.buffer, cz::min(old_mem.size, new_info.size));
+            }
+            return ptr;
+        }
+    }
+
+    // Slow path: move to the next block.
+    if (!next_block(arena, new_info)) {
+        return nullptr;
+    }
+
+    MemSlice current = {arena->pointer, (size_t)(arena->end - arena->pointer)};
+    void* ptr = advance_ptr_to_alignment(current, new_info);
+    CZ_DEBUG_ASSERT(ptr);
+    arena->pointer = (char*)ptr + new_info.size;
+    if (old_mem.buffer) {
+        memcpy(ptr, old_mem.buffer, cz::min(old_mem.size, new_info.size));
+    }
+    return ptr;
+}
+
+bool Chained_Arena::expand_in_place(void* _arena, MemSlice old_mem, size_t new_size) {
+    Chained_Arena* arena = (Chained_Arena*)_arena;
+
+    if (old_mem.end() != arena->pointer) {
+        return new_size <= old_mem.size;
+    }
+
+    if (new_size > (size_t)(arena->end - (char*)old_mem.buffer)) {
+        return false;
+    }
+    arena->pointer = (char*)old_mem.buffer + new_size;
+    return true;
+}
+
+void Chained_Arena::dealloc(void* _arena, MemSlice old_mem) {
+    Chained_Arena* arena = (Chained_Arena*)_arena;
+
+    // Only deallocate the last allocation.
+    if (old_mem.buffer && old_mem.end() == arena->pointer) {
+        arena->pointer = (char*)old_mem.buffer;
+    }
+}
+
+}
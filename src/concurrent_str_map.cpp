@@ -0,0 +1 @@
+#include <cz/concurrent_str_map.hpp>
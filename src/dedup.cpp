@@ -1 +1,111 @@
 #include <cz/dedup.hpp>
+
+#include <string.h>
+
+#if defined(__AVX2__)
+#define CZ_DEDUP_AVX2 1
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CZ_DEDUP_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace cz {
+
+#if defined(CZ_DEDUP_AVX2) || defined(CZ_DEDUP_SSE2)
+#define CZ_DEDUP_SIMD 1
+
+/// The index of the lowest set bit.  `mask` must not be 0.
+static uint32_t lowest_bit(uint32_t mask) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+#ifdef CZ_DEDUP_AVX2
+static constexpr const size_t vector_size = 32;
+
+/// Bit `i` is set if `a[i] == b[i]`.
+static uint32_t equal_mask(const uint32_t* a, const uint32_t* b) {
+    __m256i equal = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)a),
+                                       _mm256_loadu_si256((const __m256i*)b));
+    return _mm256_movemask_ps(_mm256_castsi256_ps(equal));
+}
+static uint32_t equal_mask(const uint64_t* a, const uint64_t* b) {
+    __m256i equal = _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i*)a),
+                                       _mm256_loadu_si256((const __m256i*)b));
+    return _mm256_movemask_pd(_mm256_castsi256_pd(equal));
+}
+#else
+static constexpr const size_t vector_size = 16;
+
+static uint32_t equal_mask(const uint32_t* a, const uint32_t* b) {
+    __m128i equal = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)a),
+                                    _mm_loadu_si128((const __m128i*)b));
+    return _mm_movemask_ps(_mm_castsi128_ps(equal));
+}
+static uint32_t equal_mask(const uint64_t* a, const uint64_t* b) {
+    // SSE2 doesn't have `_mm_cmpeq_epi64` so require both halves to be equal.
+    __m128i halves = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)a),
+                                     _mm_loadu_si128((const __m128i*)b));
+    __m128i equal = _mm_and_si128(halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_movemask_pd(_mm_castsi128_pd(equal));
+}
+#endif
+#endif
+
+template <class T>
+static cz::Slice<T> dedup_integers(cz::Slice<T> slice) {
+    if (slice.len < 2) {
+        return slice;
+    }
+
+    T* elems = slice.elems;
+    size_t count = 1;
+    size_t i = 1;
+
+#ifdef CZ_DEDUP_SIMD
+    // Compare a block of elements against the elements before them at once.  Elements are
+    // only written before where they are read from so the next block is never clobbered.
+    constexpr const size_t width = vector_size / sizeof(T);
+    constexpr const uint32_t all = (1 << width) - 1;
+    for (; i + width <= slice.len; i += width) {
+        uint32_t duplicates = equal_mask(elems + i, elems + i - 1);
+        if (duplicates == 0) {
+            memmove(elems + count, elems + i, sizeof(T) * width);
+            count += width;
+        } else {
+            for (uint32_t unique = ~duplicates & all; unique; unique &= unique - 1) {
+                elems[count++] = elems[i + lowest_bit(unique)];
+            }
+        }
+    }
+#endif
+
+    T previous = elems[i - 1];
+    for (; i < slice.len; ++i) {
+        T elem = elems[i];
+        elems[count] = elem;
+        count += elem != previous;
+        previous = elem;
+    }
+
+    return slice.slice_end(count);
+}
+
+cz::Slice<uint32_t> dedup(cz::Slice<uint32_t> slice) {
+    return dedup_integers(slice);
+}
+cz::Slice<uint64_t> dedup(cz::Slice<uint64_t> slice) {
+    return dedup_integers(slice);
+}
+
+}
@@ -0,0 +1 @@
+#include <cz/eytzinger_index.hpp>
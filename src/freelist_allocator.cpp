@@ -1,5 +1,7 @@
 #include <cz/freelist_allocator.hpp>
 
+#include <string.h>
+#include <new>
 #include <cz/util.hpp>
 
 namespace cz {
@@ -79,4 +81,243 @@ void Freelist::dealloc(void* freelist_, MemSlice old_mem) {
     freelist_common->head = node;
 }
 
+constexpr const size_t Freelist_Buckets::min_size;
+constexpr const size_t Freelist_Buckets::max_classes;
+
+void Freelist_Buckets::init(Allocator backer, size_t max_size, size_t max_cached_bytes) {
+    CZ_DEBUG_ASSERT((max_size & (max_size - 1)) == 0);
+    CZ_DEBUG_ASSERT(max_size >= min_size);
+    CZ_DEBUG_ASSERT(size_class(max_size) < max_classes);
+
+    this->backer = backer;
+    this->max_size = max_size;
+    this->max_cached_bytes = max_cached_bytes;
+    memset(heads, 0, sizeof(heads));
+    memset(cached_bytes, 0, sizeof(cached_bytes));
+}
+
+void Freelist_Buckets::trim() {
+    for (size_t i = 0; i < max_classes; ++i) {
+        Freelist_Common common = {heads[i], class_size(i)};
+        common.drop(backer);
+        heads[i] = nullptr;
+        cached_bytes[i] = 0;
+    }
+}
+
+size_t Freelist_Buckets::size_class(size_t size) {
+    size_t size_class = 0;
+    while (class_size(size_class) < size) {
+        ++size_class;
+    }
+    return size_class;
+}
+
+static void* buckets_pop(Freelist_Buckets* freelist, size_t size_class) {
+    Freelist_Node* node = freelist->heads[size_class];
+    if (node) {
+        freelist->heads[size_class] = node->next;
+        freelist->cached_bytes[size_class] -= Freelist_Buckets::class_size(size_class);
+        return node;
+    }
+
+    AllocInfo info = {Freelist_Buckets::class_size(size_class), alignof(max_align_t)};
+    void* ptr = freelist->backer.alloc(info);
+    if (!ptr) {
+        // Release our cache and try again.
+        freelist->trim();
+        ptr = freelist->backer.alloc(info);
+    }
+    return ptr;
+}
+
+static void buckets_push(Freelist_Buckets* freelist, void* buffer, size_t size_class) {
+    size_t size = Freelist_Buckets::class_size(size_class);
+    if (freelist->cached_bytes[size_class] + size > freelist->max_cached_bytes) {
+        freelist->backer.dealloc({buffer, size});
+        return;
+    }
+
+    Freelist_Node* node = (Freelist_Node*)buffer;
+    node->next = freelist->heads[size_class];
+    freelist->heads[size_class] = node;
+    freelist->cached_bytes[size_class] += size;
+}
+
+void* Freelist_Buckets::realloc(void* _freelist, MemSlice old_mem, AllocInfo new_info) {
+    Freelist_Buckets* freelist = (Freelist_Buckets*)_freelist;
+    CZ_DEBUG_ASSERT(new_info.alignment <= alignof(max_align_t));
+
+    bool old_small = old_mem.buffer && old_mem.size <= freelist->max_size;
+    bool new_small = new_info.size <= freelist->max_size;
+
+    // Large allocations are handled entirely by the backer.
+    if (!old_small && !new_small) {
+        return freelist->backer.realloc(old_mem, new_info);
+    }
+
+    if (old_small && new_small) {
+        if (size_class(old_mem.size) == size_class(new_info.size)) {
+            return old_mem.buffer;
+        }
+    }
+
+    void* ptr;
+    if (new_small) {
+        ptr = buckets_pop(freelist, size_class(new_info.size));
+    } else {
+        ptr = freelist->backer.alloc(new_info);
+    }
+    if (!ptr) {
+        return nullptr;
+    }
+
+    if (old_mem.buffer) {
+        memcpy(ptr, old_mem.buffer, cz::min(old_mem.size, new_info.size));
+        if (old_small) {
+            buckets_push(freelist, old_mem.buffer, size_class(old_mem.size));
+        } else {
+            freelist->backer.dealloc(old_mem);
+        }
+    }
+
+    return ptr;
+}
+
+void Freelist_Buckets::dealloc(void* _freelist, MemSlice old_mem) {
+    if (!old_mem.buffer) {
+        return;
+    }
+
+    Freelist_Buckets* freelist = (Freelist_Buckets*)_freelist;
+    if (old_mem.size <= freelist->max_size) {
+        buckets_push(freelist, old_mem.buffer, size_class(old_mem.size));
+    } else {
+        freelist->backer.dealloc(old_mem);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Concurrent_Freelist
+///////////////////////////////////////////////////////////////////////////////
+
+namespace {
+/// Like `Freelist_Node` except `next` is atomic since a thread
+/// popping a node may read it while another thread pushes it.
+struct Concurrent_Freelist_Node {
+    std::atomic<Concurrent_Freelist_Node*> next;
+};
+}
+
+// The head is a pointer packed with a counter that is incremented on every
+// push.  Thus a pop that races with a pop and push of the same node will fail
+// its compare exchange.  User space pointers use at most 48 bits on most 64 bit
+// platforms so the counter is stored in the upper 16 bits.  `dealloc` checks
+// this holds for every pushed node since otherwise the head would be corrupted.
+static bool fits_in_pack(Concurrent_Freelist_Node* node) {
+    return sizeof(void*) == 4 || ((uint64_t)(uintptr_t)node >> 48) == 0;
+}
+static uint64_t pack(Concurrent_Freelist_Node* node, uint64_t tag) {
+    if (sizeof(void*) == 4) {
+        return (uint64_t)(uintptr_t)node | (tag << 32);
+    } else {
+        return (uint64_t)(uintptr_t)node | (tag << 48);
+    }
+}
+static Concurrent_Freelist_Node* unpack_node(uint64_t head) {
+    if (sizeof(void*) == 4) {
+        return (Concurrent_Freelist_Node*)(uintptr_t)(head & 0xFFFFFFFFull);
+    } else {
+        return (Concurrent_Freelist_Node*)(uintptr_t)(head & 0xFFFFFFFFFFFFull);
+    }
+}
+static uint64_t unpack_tag(uint64_t head) {
+    return head >> (sizeof(void*) == 4 ? 32 : 48);
+}
+
+/// Read `node->next` while popping `node`.  If another thread pops `node` first then
+/// its new owner may be writing to it so we read garbage.  This race is benign: the
+/// tag in the head has changed so the compare exchange fails and the value is discarded.
+///
+/// The owner's writes aren't atomic so ThreadSanitizer reports the race anyway.  Thus on
+/// GCC and Clang the load is done via a builtin in a function it doesn't instrument.
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((no_sanitize("thread")))
+static Concurrent_Freelist_Node* load_next(Concurrent_Freelist_Node* node) {
+    static_assert(sizeof(node->next) == sizeof(Concurrent_Freelist_Node*), "");
+    return __atomic_load_n((Concurrent_Freelist_Node**)&node->next, __ATOMIC_RELAXED);
+}
+#else
+static Concurrent_Freelist_Node* load_next(Concurrent_Freelist_Node* node) {
+    return node->next.load(std::memory_order_relaxed);
+}
+#endif
+
+void Concurrent_Freelist::init(Allocator backer, size_t size) {
+    static_assert(sizeof(Concurrent_Freelist_Node) <= sizeof(Freelist_Node),
+                  "Nodes must fit in the minimum size");
+    head.store(0);
+    this->backer = backer;
+    this->size = cz::max(size, sizeof(Freelist_Node));
+}
+
+void Concurrent_Freelist::drop() {
+    Concurrent_Freelist_Node* node = unpack_node(head.load());
+    while (node) {
+        Concurrent_Freelist_Node* next = node->next.load(std::memory_order_relaxed);
+        backer.dealloc({node, size});
+        node = next;
+    }
+}
+
+void* Concurrent_Freelist::realloc(void* freelist_, MemSlice old_mem, AllocInfo new_info) {
+    Concurrent_Freelist* freelist = (Concurrent_Freelist*)freelist_;
+
+    if (new_info.size > freelist->size) {
+        CZ_PANIC("Concurrent_Freelist allocation is too big");
+    }
+
+    // All allocations are the same size so reallocation is a no-op.
+    if (old_mem.buffer) {
+        return old_mem.buffer;
+    }
+
+    uint64_t old_head = freelist->head.load(std::memory_order_acquire);
+    while (1) {
+        Concurrent_Freelist_Node* node = unpack_node(old_head);
+        if (!node) {
+            return freelist->backer.alloc({freelist->size, new_info.alignment});
+        }
+
+        // Note that `node` may have already been popped by another thread in which
+        // case `next` is garbage.  But then the tag has changed so the swap will fail.
+        // The memory is still readable because nodes are only freed in `drop`.
+        uint64_t new_head = pack(load_next(node), unpack_tag(old_head));
+        if (freelist->head.compare_exchange_weak(old_head, new_head, std::memory_order_acquire,
+                                                 std::memory_order_acquire)) {
+            return node;
+        }
+    }
+}
+
+void Concurrent_Freelist::dealloc(void* freelist_, MemSlice old_mem) {
+    if (!old_mem.buffer) {
+        return;
+    }
+
+    Concurrent_Freelist* freelist = (Concurrent_Freelist*)freelist_;
+    Concurrent_Freelist_Node* node = new (old_mem.buffer) Concurrent_Freelist_Node;
+    CZ_ASSERT(fits_in_pack(node));
+
+    uint64_t old_head = freelist->head.load(std::memory_order_relaxed);
+    while (1) {
+        node->next.store(unpack_node(old_head), std::memory_order_relaxed);
+        uint64_t new_head = pack(node, unpack_tag(old_head) + 1);
+        if (freelist->head.compare_exchange_weak(old_head, new_head, std::memory_order_release,
+                                                 std::memory_order_relaxed)) {
+            return;
+        }
+    }
+}
+
 }
@@ -0,0 +1,37 @@
+#include <cz/growth_policy.hpp>
+
+#include <cz/next_power_of_two.hpp>
+
+namespace cz {
+
+size_t grow_power_of_two(size_t cap, size_t total, size_t elem_size) {
+    size_t new_cap = next_power_of_two(total - 1);
+    if (new_cap < 8) {
+        new_cap = 8;
+    }
+    return new_cap;
+}
+
+size_t grow_one_and_a_half(size_t cap, size_t total, size_t elem_size) {
+    size_t new_cap = cap + cap / 2;
+    if (new_cap < total) {
+        new_cap = total;
+    }
+    if (new_cap < 8) {
+        new_cap = 8;
+    }
+    return new_cap;
+}
+
+size_t grow_page_granular(size_t cap, size_t total, size_t elem_size) {
+    size_t new_cap = grow_power_of_two(cap, total, elem_size);
+    if (new_cap * elem_size <= growth_page_threshold) {
+        return new_cap;
+    }
+
+    size_t bytes = grow_one_and_a_half(cap, total, elem_size) * elem_size;
+    bytes = (bytes + growth_page_size - 1) / growth_page_size * growth_page_size;
+    return bytes / elem_size;
+}
+
+}
@@ -1 +1,154 @@
 #include <cz/hash.hpp>
+
+#include <string.h>
+
+namespace cz {
+
+static const uint64_t prime1 = 0x9E3779B185EBCA87ull;
+static const uint64_t prime2 = 0xC2B2AE3D27D4EB4Full;
+static const uint64_t prime3 = 0x165667B19E3779F9ull;
+static const uint64_t prime4 = 0x85EBCA77C2B2AE63ull;
+static const uint64_t prime5 = 0x27D4EB2F165667C5ull;
+
+static uint64_t rotate_left(uint64_t x, int bits) {
+    return (x << bits) | (x >> (64 - bits));
+}
+
+static uint64_t read64(const char* pointer) {
+    uint64_t x;
+    memcpy(&x, pointer, sizeof(x));
+    return x;
+}
+
+static uint32_t read32(const char* pointer) {
+    uint32_t x;
+    memcpy(&x, pointer, sizeof(x));
+    return x;
+}
+
+static uint64_t xxh_round(uint64_t accumulator, uint64_t input) {
+    accumulator += input * prime2;
+    accumulator = rotate_left(accumulator, 31);
+    return accumulator * prime1;
+}
+
+static uint64_t merge_round(uint64_t hash, uint64_t accumulator) {
+    hash ^= xxh_round(0, accumulator);
+    return hash * prime1 + prime4;
+}
+
+static void init_accumulators(uint64_t accumulators[4], Hash seed) {
+    accumulators[0] = seed + prime1 + prime2;
+    accumulators[1] = seed + prime2;
+    accumulators[2] = seed;
+    accumulators[3] = seed - prime1;
+}
+
+/// Consume 32 byte stripes.  Returns the number of bytes consumed.
+static size_t consume_stripes(uint64_t accumulators[4], const char* data, size_t len) {
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        accumulators[0] = xxh_round(accumulators[0], read64(data + i));
+        accumulators[1] = xxh_round(accumulators[1], read64(data + i + 8));
+        accumulators[2] = xxh_round(accumulators[2], read64(data + i + 16));
+        accumulators[3] = xxh_round(accumulators[3], read64(data + i + 24));
+    }
+    return i;
+}
+
+static uint64_t merge_accumulators(const uint64_t accumulators[4]) {
+    uint64_t hash = rotate_left(accumulators[0], 1) + rotate_left(accumulators[1], 7) +
+                    rotate_left(accumulators[2], 12) + rotate_left(accumulators[3], 18);
+    hash = merge_round(hash, accumulators[0]);
+    hash = merge_round(hash, accumulators[1]);
+    hash = merge_round(hash, accumulators[2]);
+    hash = merge_round(hash, accumulators[3]);
+    return hash;
+}
+
+/// Mix in the last `len` (less than 32) bytes and avalanche.
+static uint64_t finalize(uint64_t hash, const char* data, size_t len) {
+    for (; len >= 8; data += 8, len -= 8) {
+        hash ^= xxh_round(0, read64(data));
+        hash = rotate_left(hash, 27) * prime1 + prime4;
+    }
+    if (len >= 4) {
+        hash ^= read32(data) * prime1;
+        hash = rotate_left(hash, 23) * prime2 + prime3;
+        data += 4;
+        len -= 4;
+    }
+    for (; len > 0; ++data, --len) {
+        hash ^= (unsigned char)*data * prime5;
+        hash = rotate_left(hash, 11) * prime1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= prime2;
+    hash ^= hash >> 29;
+    hash *= prime3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+Hash hash(cz::Str str, Hash seed) {
+    uint64_t hash;
+    size_t consumed = 0;
+    if (str.len >= 32) {
+        uint64_t accumulators[4];
+        init_accumulators(accumulators, seed);
+        consumed = consume_stripes(accumulators, str.buffer, str.len);
+        hash = merge_accumulators(accumulators);
+    } else {
+        hash = seed + prime5;
+    }
+    hash += str.len;
+    return finalize(hash, str.buffer + consumed, str.len - consumed);
+}
+
+void Hash_Stream::init(Hash seed) {
+    init_accumulators(accumulators, seed);
+    total_len = 0;
+    buffer_len = 0;
+    this->seed = seed;
+}
+
+void Hash_Stream::update(cz::Str str) {
+    if (str.len == 0) {
+        return;
+    }
+
+    total_len += str.len;
+
+    // Fill up the buffer first.
+    if (buffer_len > 0) {
+        size_t fill = 32 - buffer_len;
+        if (str.len < fill) {
+            memcpy(buffer + buffer_len, str.buffer, str.len);
+            buffer_len += str.len;
+            return;
+        }
+
+        memcpy(buffer + buffer_len, str.buffer, fill);
+        consume_stripes(accumulators, (const char*)buffer, 32);
+        buffer_len = 0;
+        str = str.slice_start(fill);
+    }
+
+    size_t consumed = consume_stripes(accumulators, str.buffer, str.len);
+    memcpy(buffer, str.buffer + consumed, str.len - consumed);
+    buffer_len = str.len - consumed;
+}
+
+Hash Hash_Stream::finish() const {
+    uint64_t hash;
+    if (total_len >= 32) {
+        hash = merge_accumulators(accumulators);
+    } else {
+        hash = seed + prime5;
+    }
+    hash += total_len;
+    return finalize(hash, (const char*)buffer, buffer_len);
+}
+
+}
@@ -0,0 +1 @@
+#include <cz/hash_map.hpp>
@@ -1 +1,68 @@
 #include <cz/heap.hpp>
+
+#include <string.h>
+#include <cz/util.hpp>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace cz {
+
+#ifdef _WIN32
+void* heap_allocator_realloc_aligned(MemSlice old_mem, AllocInfo new_info) {
+    return heap_allocator_realloc(nullptr, old_mem, new_info);
+}
+
+void* heap_allocator_realloc(void*, MemSlice old_mem, AllocInfo new_info) {
+    CZ_DEBUG_ASSERT((new_info.alignment & (new_info.alignment - 1)) == 0);
+
+    if (new_info.size == 0) {
+        new_info.size = 1;
+    }
+
+    size_t alignment = cz::max(new_info.alignment, alignof(max_align_t));
+    void* ptr = _aligned_realloc(old_mem.buffer, new_info.size, alignment);
+    if (ptr) {
+        TracyFree(old_mem.buffer);
+        TracyAlloc(ptr, new_info.size);
+    }
+    return ptr;
+}
+
+void heap_allocator_dealloc(void*, MemSlice old_mem) {
+    _aligned_free(old_mem.buffer);
+    TracyFree(old_mem.buffer);
+}
+#else
+void* heap_allocator_realloc_aligned(MemSlice old_mem, AllocInfo new_info) {
+    CZ_DEBUG_ASSERT((new_info.alignment & (new_info.alignment - 1)) == 0);
+
+    if (new_info.size == 0) {
+        new_info.size = 1;
+    }
+
+    // Shrinking memory that is already aligned can be done in place.  Note that we
+    // don't try growing via `std::realloc` because it will probably lose alignment.
+    if (old_mem.buffer && new_info.size <= old_mem.size &&
+        (size_t)old_mem.buffer % new_info.alignment == 0) {
+        return old_mem.buffer;
+    }
+
+    void* ptr;
+    if (posix_memalign(&ptr, new_info.alignment, new_info.size) != 0) {
+        return nullptr;
+    }
+    TracyAlloc(ptr, new_info.size);
+
+    if (old_mem.buffer) {
+        memcpy(ptr, old_mem.buffer, cz::min(old_mem.size, new_info.size));
+        free(old_mem.buffer);
+        TracyFree(old_mem.buffer);
+    }
+
+    return ptr;
+}
+#endif
+
+}
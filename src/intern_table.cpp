@@ -0,0 +1,144 @@
+#include <cz/intern_table.hpp>
+
+#include <string.h>
+#include <cz/defer.hpp>
+#include <cz/heap.hpp>
+
+namespace cz {
+
+///////////////////////////////////////////////////////////////////////////////
+// Intern_Table
+///////////////////////////////////////////////////////////////////////////////
+
+static Str copy_into(Buffer_Array* storage, Str str) {
+    char* buffer = storage->allocator().alloc<char>(str.len);
+    CZ_ASSERT(buffer);
+    memcpy(buffer, str.buffer, str.len);
+    return {buffer, str.len};
+}
+
+void Intern_Table::init() {
+    storage.init();
+    ids = {};
+    strings = {};
+}
+
+void Intern_Table::drop() {
+    storage.drop();
+    ids.drop(heap_allocator());
+    strings.drop(heap_allocator());
+}
+
+uint32_t Intern_Table::intern(Str str) {
+    Hash hash = ids.hash(str);
+    uint32_t* existing = ids.get(str, hash);
+    if (existing) {
+        return *existing;
+    }
+
+    CZ_ASSERT(strings.len < UINT32_MAX);
+    uint32_t id = (uint32_t)strings.len;
+    Str copy = copy_into(&storage, str);
+
+    strings.reserve(heap_allocator(), 1);
+    strings.push(copy);
+    ids.reserve(heap_allocator(), 1);
+    ids.insert(copy, hash, id);
+    return id;
+}
+
+bool Intern_Table::find(Str str, uint32_t* id) {
+    uint32_t* existing = ids.get_hash(str);
+    if (existing) {
+        *id = *existing;
+        return true;
+    }
+    return false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Concurrent_Intern_Table
+///////////////////////////////////////////////////////////////////////////////
+
+constexpr const size_t Concurrent_Intern_Table::first_chunk_size;
+constexpr const size_t Concurrent_Intern_Table::max_chunks;
+
+static size_t chunk_size(size_t chunk) {
+    return Concurrent_Intern_Table::first_chunk_size << chunk;
+}
+
+size_t Concurrent_Intern_Table::chunk_of(uint32_t id, size_t* offset) {
+    // Chunk `i` starts at `first_chunk_size * (2^i - 1)` so find the
+    // highest bit of `id / first_chunk_size + 1` to get the chunk.
+    uint64_t scaled = (uint64_t)id / first_chunk_size + 1;
+    size_t chunk = 0;
+    while (scaled >>= 1) {
+        ++chunk;
+    }
+    *offset = id - first_chunk_size * ((1ull << chunk) - 1);
+    return chunk;
+}
+
+void Concurrent_Intern_Table::init() {
+    mutex.init();
+    storage.init();
+    ids.init(heap_allocator());
+    for (size_t i = 0; i < max_chunks; ++i) {
+        chunks[i].store(nullptr);
+    }
+    _count.store(0);
+}
+
+void Concurrent_Intern_Table::drop() {
+    for (size_t i = 0; i < max_chunks; ++i) {
+        heap_allocator().dealloc(chunks[i].load(), chunk_size(i));
+    }
+    ids.drop(heap_allocator());
+    storage.drop();
+    mutex.drop();
+}
+
+uint32_t Concurrent_Intern_Table::intern(Str str) {
+    Hash hash = ids.hash(str);
+    uint32_t id;
+    if (ids.get(str, hash, &id)) {
+        return id;
+    }
+
+    mutex.lock();
+    CZ_DEFER(mutex.unlock());
+
+    // Another thread may have interned it while we were waiting.
+    if (ids.get(str, hash, &id)) {
+        return id;
+    }
+
+    id = _count.load(std::memory_order_relaxed);
+    CZ_ASSERT(id < UINT32_MAX);
+
+    size_t offset;
+    size_t chunk = chunk_of(id, &offset);
+    CZ_ASSERT(chunk < max_chunks);
+    Str* strings = chunks[chunk].load(std::memory_order_relaxed);
+    if (!strings) {
+        strings = heap_allocator().alloc<Str>(chunk_size(chunk));
+        CZ_ASSERT(strings);
+        chunks[chunk].store(strings, std::memory_order_release);
+    }
+
+    Str copy = copy_into(&storage, str);
+    strings[offset] = copy;
+    _count.store(id + 1, std::memory_order_release);
+
+    // Publish the id last so anyone who finds it can `get` it.
+    ids.insert(heap_allocator(), copy, hash, id);
+    return id;
+}
+
+Str Concurrent_Intern_Table::get(uint32_t id) const {
+    size_t offset;
+    size_t chunk = chunk_of(id, &offset);
+    return chunks[chunk].load(std::memory_order_acquire)[offset];
+}
+
+}
@@ -0,0 +1 @@
+#include <cz/parallel_sort.hpp>
@@ -0,0 +1,112 @@
+#include <cz/radix_sort.hpp>
+
+namespace cz {
+
+/// Below this size use insertion sort.  Smaller than `radix_impl::radix_sort_threshold`
+/// because comparing strings is more expensive than comparing integers.
+static constexpr const size_t str_radix_sort_threshold = 32;
+
+/// The bucket of `str` at `depth`.  Strings that have ended go in bucket `0`.
+static size_t bucket_of(Str str, size_t depth) {
+    return depth < str.len ? (unsigned char)str.buffer[depth] + 1 : 0;
+}
+
+/// The number of bytes after `depth` shared by every string.
+static size_t common_prefix(const Str* elems, size_t len, size_t depth) {
+    Str first = elems[0];
+    size_t prefix = first.len - depth;
+    for (size_t i = 1; i < len && prefix > 0; ++i) {
+        Str str = elems[i];
+        size_t max = str.len - depth < prefix ? str.len - depth : prefix;
+        size_t matched = 0;
+        while (matched < max && str.buffer[depth + matched] == first.buffer[depth + matched]) {
+            ++matched;
+        }
+        prefix = matched;
+    }
+    return prefix;
+}
+
+/// Sort strings that all share the first `depth` bytes.  `buckets`
+/// caches the bucket of each string so each string is only read once.
+static void msd_radix_sort(Str* elems,
+                           Str* scratch,
+                           uint16_t* buckets,
+                           size_t len,
+                           size_t depth) {
+    while (len >= str_radix_sort_threshold) {
+        size_t counts[257] = {};
+        for (size_t i = 0; i < len; ++i) {
+            size_t bucket = bucket_of(elems[i], depth);
+            buckets[i] = (uint16_t)bucket;
+            ++counts[bucket];
+        }
+
+        // Skip bytes shared by every string.
+        if (counts[buckets[0]] == len) {
+            if (buckets[0] == 0) {
+                // Every string is the same.
+                return;
+            }
+            depth += 1 + common_prefix(elems, len, depth + 1);
+            continue;
+        }
+
+        size_t offsets[257];
+        size_t offset = 0;
+        for (size_t bucket = 0; bucket < 257; ++bucket) {
+            offsets[bucket] = offset;
+            offset += counts[bucket];
+        }
+
+        for (size_t i = 0; i < len; ++i) {
+            scratch[offsets[buckets[i]]++] = elems[i];
+        }
+        memcpy(elems, scratch, sizeof(Str) * len);
+
+        // Strings in bucket `0` ended so they are equal and already in place.  Recurse
+        // into every other bucket except the largest and then loop on the largest
+        // bucket.  Every recursive call has at most half the strings so the stack
+        // depth is `O(log n)` regardless of how long the strings are.
+        size_t largest = 1;
+        for (size_t bucket = 2; bucket < 257; ++bucket) {
+            if (counts[bucket] > counts[largest]) {
+                largest = bucket;
+            }
+        }
+
+        for (size_t bucket = 1; bucket < 257; ++bucket) {
+            if (bucket != largest && counts[bucket] > 1) {
+                size_t start = offsets[bucket] - counts[bucket];
+                msd_radix_sort(elems + start, scratch, buckets, counts[bucket], depth + 1);
+            }
+        }
+
+        elems += offsets[largest] - counts[largest];
+        len = counts[largest];
+        ++depth;
+    }
+
+    generic_insertion_sort(
+        elems, elems + len,
+        [&](Str* left, Str* right) {
+            return left->slice_start(depth) < right->slice_start(depth);
+        },
+        generic_swap_ptr<Str>);
+}
+
+void radix_sort(Allocator scratch, cz::Slice<cz::Str> slice) {
+    if (slice.len < 2) {
+        return;
+    }
+
+    Str* buffer = scratch.alloc<Str>(slice.len);
+    CZ_ASSERT(buffer);
+    CZ_DEFER(scratch.dealloc(buffer, slice.len));
+    uint16_t* buckets = scratch.alloc<uint16_t>(slice.len);
+    CZ_ASSERT(buckets);
+    CZ_DEFER(scratch.dealloc(buckets, slice.len));
+    msd_radix_sort(slice.elems, buffer, buckets, slice.len, 0);
+}
+
+}
@@ -0,0 +1,411 @@
+#include <cz/slab_allocator.hpp>
+
+#include <stdint.h>
+#include <string.h>
+#include <cz/assert.hpp>
+#include <cz/defer.hpp>
+#include <cz/heap.hpp>
+#include <cz/util.hpp>
+
+namespace cz {
+
+constexpr const size_t Slab_Allocator::num_size_classes;
+constexpr const size_t Slab_Allocator::max_size;
+constexpr const size_t Slab_Allocator::max_alignment;
+constexpr const size_t Slab_Allocator::batch_size;
+constexpr const size_t Slab_Allocator::chunk_size;
+
+static const uint16_t class_sizes[Slab_Allocator::num_size_classes] = {
+    16,  32,  48,  64,  80,  96,  112, 128,  //
+    160, 192, 224, 256,                      //
+    320, 384, 448, 512,                      //
+    640, 768, 896, 1024,                     //
+};
+
+size_t Slab_Allocator::size_class(size_t size) {
+    CZ_DEBUG_ASSERT(size <= max_size);
+    if (size <= 128) {
+        // Treat 0 byte allocations as 1 byte allocations.
+        return (cz::max(size, (size_t)1) + 15) / 16 - 1;
+    } else if (size <= 256) {
+        return 8 + (size - 129) / 32;
+    } else if (size <= 512) {
+        return 12 + (size - 257) / 64;
+    } else {
+        return 16 + (size - 513) / 128;
+    }
+}
+
+size_t Slab_Allocator::class_size(size_t size_class) {
+    CZ_DEBUG_ASSERT(size_class < num_size_classes);
+    return class_sizes[size_class];
+}
+
+void Slab_Allocator::init(Allocator backer) {
+    this->backer = backer;
+    mutex.init();
+    memset(batches, 0, sizeof(batches));
+    chunks = nullptr;
+    chunk_pointer = nullptr;
+    chunk_end = nullptr;
+    caches = nullptr;
+    caches_len = 0;
+    caches_cap = 0;
+}
+
+void Slab_Allocator::drop() {
+    // Orphan the caches.  Each thread will free its cache the next time it looks it up.
+    for (size_t i = 0; i < caches_len; ++i) {
+        caches[i]->slab.store(nullptr);
+    }
+    cz::heap_allocator().dealloc(caches, caches_cap);
+
+    void* chunk = chunks;
+    while (chunk) {
+        void* next = *(void**)chunk;
+        backer.dealloc({chunk, chunk_size});
+        chunk = next;
+    }
+
+    mutex.drop();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Thread caches
+///////////////////////////////////////////////////////////////////////////////
+
+static void unregister_cache(Slab_Allocator* slab, Slab_Thread_Cache* cache);
+static void flush_cache(Slab_Allocator* slab, Slab_Thread_Cache* cache);
+
+namespace {
+/// All caches owned by this thread.  Caches are flushed back to
+/// their `Slab_Allocator` when the thread exits.
+struct Thread_Caches {
+    Slab_Thread_Cache* last;
+    Slab_Thread_Cache** caches;
+    size_t len;
+    size_t cap;
+
+    ~Thread_Caches() {
+        for (size_t i = 0; i < len; ++i) {
+            Slab_Allocator* slab = caches[i]->slab.load();
+            if (slab) {
+                flush_cache(slab, caches[i]);
+                unregister_cache(slab, caches[i]);
+            }
+            cz::heap_allocator().dealloc(caches[i]);
+        }
+        cz::heap_allocator().dealloc(caches, cap);
+    }
+};
+}
+
+static thread_local Thread_Caches thread_caches;
+
+static void unregister_cache(Slab_Allocator* slab, Slab_Thread_Cache* cache) {
+    slab->mutex.lock();
+    CZ_DEFER(slab->mutex.unlock());
+
+    for (size_t i = 0; i < slab->caches_len; ++i) {
+        if (slab->caches[i] == cache) {
+            slab->caches[i] = slab->caches[--slab->caches_len];
+            break;
+        }
+    }
+}
+
+static Slab_Thread_Cache* create_cache(Slab_Allocator* slab) {
+    // Free caches belonging to dropped `Slab_Allocator`s.
+    for (size_t i = 0; i < thread_caches.len;) {
+        if (thread_caches.caches[i]->slab.load() == nullptr) {
+            cz::heap_allocator().dealloc(thread_caches.caches[i]);
+            thread_caches.caches[i] = thread_caches.caches[--thread_caches.len];
+        } else {
+            ++i;
+        }
+    }
+
+    Slab_Thread_Cache* cache = cz::heap_allocator().alloc<Slab_Thread_Cache>();
+    CZ_ASSERT(cache);
+    memset(cache->heads, 0, sizeof(cache->heads));
+    memset(cache->counts, 0, sizeof(cache->counts));
+    new (&cache->slab) std::atomic<Slab_Allocator*>(slab);
+
+    if (thread_caches.len == thread_caches.cap) {
+        size_t new_cap = cz::max(thread_caches.cap * 2, (size_t)4);
+        Slab_Thread_Cache** new_caches =
+            cz::heap_allocator().realloc(thread_caches.caches, thread_caches.cap, new_cap);
+        CZ_ASSERT(new_caches);
+        thread_caches.caches = new_caches;
+        thread_caches.cap = new_cap;
+    }
+    thread_caches.caches[thread_caches.len++] = cache;
+
+    {
+        slab->mutex.lock();
+        CZ_DEFER(slab->mutex.unlock());
+
+        if (slab->caches_len == slab->caches_cap) {
+            size_t new_cap = cz::max(slab->caches_cap * 2, (size_t)4);
+            Slab_Thread_Cache** new_caches =
+                cz::heap_allocator().realloc(slab->caches, slab->caches_cap, new_cap);
+            CZ_ASSERT(new_caches);
+            slab->caches = new_caches;
+            slab->caches_cap = new_cap;
+        }
+        slab->caches[slab->caches_len++] = cache;
+    }
+
+    return cache;
+}
+
+static Slab_Thread_Cache* get_cache(Slab_Allocator* slab) {
+    Slab_Thread_Cache* cache = thread_caches.last;
+    if (cache && cache->slab.load(std::memory_order_relaxed) == slab) {
+        return cache;
+    }
+
+    for (size_t i = 0; i < thread_caches.len; ++i) {
+        if (thread_caches.caches[i]->slab.load(std::memory_order_relaxed) == slab) {
+            thread_caches.last = thread_caches.caches[i];
+            return thread_caches.last;
+        }
+    }
+
+    thread_caches.last = create_cache(slab);
+    return thread_caches.last;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Depot
+///////////////////////////////////////////////////////////////////////////////
+
+/// Give one batch from the cache back to the depot.
+static void give_batch(Slab_Allocator* slab, Slab_Thread_Cache* cache, size_t size_class) {
+    Slab_Node* first = cache->heads[size_class];
+    Slab_Node* last = first;
+    for (size_t i = 1; i < Slab_Allocator::batch_size; ++i) {
+        last = last->next;
+    }
+    cache->heads[size_class] = last->next;
+    cache->counts[size_class] -= Slab_Allocator::batch_size;
+    last->next = nullptr;
+
+    slab->mutex.lock();
+    CZ_DEFER(slab->mutex.unlock());
+    first->next_batch = slab->batches[size_class];
+    slab->batches[size_class] = first;
+}
+
+/// Objects are aligned to the largest power of two dividing their class size.
+static size_t class_alignment(size_t class_size) {
+    return class_size & (~class_size + 1);
+}
+
+static char* align_up(char* pointer, size_t alignment) {
+    return (char*)(((uintptr_t)pointer + alignment - 1) & ~(uintptr_t)(alignment - 1));
+}
+
+/// Carve up to one batch of new objects out of the current chunk.  Must hold the lock.
+static Slab_Node* carve_batch(Slab_Allocator* slab, size_t size_class, size_t* count) {
+    size_t size = Slab_Allocator::class_size(size_class);
+    size_t alignment = class_alignment(size);
+    char* start = align_up(slab->chunk_pointer, alignment);
+    if (slab->chunk_end - start < (ptrdiff_t)size) {
+        // Chunks are aligned to `chunk_size` so `in_slab` can recognize small
+        // allocations that were passed through to the `backer`.
+        char* chunk = (char*)slab->backer.alloc(
+            {Slab_Allocator::chunk_size, Slab_Allocator::chunk_size});
+        if (!chunk) {
+            return nullptr;
+        }
+
+        *(void**)chunk = slab->chunks;
+        slab->chunks = chunk;
+        slab->chunk_pointer = chunk + Slab_Allocator::max_alignment;
+        slab->chunk_end = chunk + Slab_Allocator::chunk_size;
+        start = align_up(slab->chunk_pointer, alignment);
+    }
+    slab->chunk_pointer = start;
+
+    size_t available = (slab->chunk_end - slab->chunk_pointer) / size;
+    *count = cz::min(available, Slab_Allocator::batch_size);
+
+    Slab_Node* head = nullptr;
+    for (size_t i = *count; i-- > 0;) {
+        Slab_Node* node = (Slab_Node*)(slab->chunk_pointer + i * size);
+        node->next = head;
+        head = node;
+    }
+    slab->chunk_pointer += *count * size;
+    return head;
+}
+
+/// Refill an empty cache from the depot.  Returns `false` if we are out of memory.
+static bool take_batch(Slab_Allocator* slab, Slab_Thread_Cache* cache, size_t size_class) {
+    slab->mutex.lock();
+    CZ_DEFER(slab->mutex.unlock());
+
+    Slab_Node* batch = slab->batches[size_class];
+    if (batch) {
+        slab->batches[size_class] = batch->next_batch;
+
+        // Batches flushed by `flush_cache` may not be full so count them.
+        size_t count = 0;
+        for (Slab_Node* node = batch; node; node = node->next) {
+            ++count;
+        }
+
+        cache->heads[size_class] = batch;
+        cache->counts[size_class] = count;
+        return true;
+    }
+
+    size_t count;
+    batch = carve_batch(slab, size_class, &count);
+    if (!batch) {
+        return false;
+    }
+    cache->heads[size_class] = batch;
+    cache->counts[size_class] = count;
+    return true;
+}
+
+/// Return every object in the cache to the depot.
+static void flush_cache(Slab_Allocator* slab, Slab_Thread_Cache* cache) {
+    for (size_t size_class = 0; size_class < Slab_Allocator::num_size_classes; ++size_class) {
+        while (cache->counts[size_class] >= Slab_Allocator::batch_size) {
+            give_batch(slab, cache, size_class);
+        }
+
+        // Give the remainder back as a partial batch.
+        if (cache->counts[size_class] > 0) {
+            slab->mutex.lock();
+            CZ_DEFER(slab->mutex.unlock());
+            Slab_Node* first = cache->heads[size_class];
+            first->next_batch = slab->batches[size_class];
+            slab->batches[size_class] = first;
+        }
+        cache->heads[size_class] = nullptr;
+        cache->counts[size_class] = 0;
+    }
+}
+
+void Slab_Allocator::flush_thread_cache() {
+    flush_cache(this, get_cache(this));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Allocator interface
+///////////////////////////////////////////////////////////////////////////////
+
+static void* slab_alloc(Slab_Allocator* slab, size_t size_class) {
+    Slab_Thread_Cache* cache = get_cache(slab);
+    if (!cache->heads[size_class]) {
+        if (!take_batch(slab, cache, size_class)) {
+            return nullptr;
+        }
+    }
+
+    Slab_Node* node = cache->heads[size_class];
+    cache->heads[size_class] = node->next;
+    --cache->counts[size_class];
+    return node;
+}
+
+static void slab_dealloc(Slab_Allocator* slab, void* buffer, size_t size_class) {
+    Slab_Thread_Cache* cache = get_cache(slab);
+    Slab_Node* node = (Slab_Node*)buffer;
+    node->next = cache->heads[size_class];
+    cache->heads[size_class] = node;
+    ++cache->counts[size_class];
+
+    // Keep one batch around so alternating allocations and
+    // deallocations don't constantly go to the depot.
+    if (cache->counts[size_class] >= 2 * Slab_Allocator::batch_size) {
+        give_batch(slab, cache, size_class);
+    }
+}
+
+/// Small allocations are passed through to the `backer` aligned to `chunk_size`.  Objects
+/// never start at the beginning of a chunk because the chunk's header is stored there.
+static bool in_slab(void* buffer) {
+    return (uintptr_t)buffer % Slab_Allocator::chunk_size != 0;
+}
+
+static bool fits_in_slab(size_t size, size_t alignment) {
+    if (size > Slab_Allocator::max_size) {
+        return false;
+    }
+    if (alignment <= Slab_Allocator::max_alignment) {
+        return true;
+    }
+    size_t class_size = Slab_Allocator::class_size(Slab_Allocator::size_class(size));
+    return class_alignment(class_size) >= alignment;
+}
+
+static AllocInfo backer_info(size_t size, size_t alignment) {
+    if (size <= Slab_Allocator::max_size) {
+        alignment = cz::max(alignment, Slab_Allocator::chunk_size);
+    }
+    return {size, alignment};
+}
+
+void* Slab_Allocator::realloc(void* _slab, MemSlice old_mem, AllocInfo new_info) {
+    Slab_Allocator* slab = (Slab_Allocator*)_slab;
+    size_t new_size = new_info.size;
+    size_t new_alignment = new_info.alignment;
+
+    // Allocations are either in a slab or in the backer.
+    bool old_small = old_mem.buffer && old_mem.size <= max_size && in_slab(old_mem.buffer);
+    bool new_small = fits_in_slab(new_size, new_alignment);
+
+    if (!old_small && !new_small) {
+        // Both are handled entirely by the backer.
+        return slab->backer.realloc(old_mem, backer_info(new_size, new_alignment));
+    }
+
+    if (old_small && new_small) {
+        size_t old_class = size_class(old_mem.size);
+        size_t new_class = size_class(new_size);
+        if (old_class == new_class) {
+            return old_mem.buffer;
+        }
+    }
+
+    void* ptr;
+    if (new_small) {
+        ptr = slab_alloc(slab, size_class(new_size));
+    } else {
+        ptr = slab->backer.alloc(backer_info(new_size, new_alignment));
+    }
+    if (!ptr) {
+        return nullptr;
+    }
+
+    if (old_mem.buffer) {
+        memcpy(ptr, old_mem.buffer, cz::min(old_mem.size, new_size));
+        if (old_small) {
+            slab_dealloc(slab, old_mem.buffer, size_class(old_mem.size));
+        } else {
+            slab->backer.dealloc(old_mem);
+        }
+    }
+
+    return ptr;
+}
+
+void Slab_Allocator::dealloc(void* _slab, MemSlice old_mem) {
+    if (!old_mem.buffer) {
+        return;
+    }
+
+    Slab_Allocator* slab = (Slab_Allocator*)_slab;
+    if (old_mem.size <= max_size && in_slab(old_mem.buffer)) {
+        slab_dealloc(slab, old_mem.buffer, size_class(old_mem.size));
+    } else {
+        slab->backer.dealloc(old_mem);
+    }
+}
+
+}
@@ -0,0 +1 @@
+#include <cz/small_vector.hpp>
@@ -0,0 +1 @@
+#include <cz/soa_vector.hpp>
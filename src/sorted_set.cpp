@@ -0,0 +1,292 @@
+#include <cz/sorted_set.hpp>
+
+#include <string.h>
+
+#if defined(__AVX2__)
+#define CZ_SORTED_SET_AVX2 1
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CZ_SORTED_SET_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace cz {
+
+#if defined(CZ_SORTED_SET_AVX2) || defined(CZ_SORTED_SET_SSE2)
+#define CZ_SORTED_SET_SIMD 1
+
+/// The index of the lowest set bit.  `mask` must not be 0.
+static uint32_t lowest_bit(uint32_t mask) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+#ifdef CZ_SORTED_SET_AVX2
+static constexpr const size_t vector_size = 32;
+
+/// Bit `i` is set if `a[i]` is equal to any of the elements of `b`.
+static uint32_t match_mask(const uint32_t* a, const uint32_t* b) {
+    __m256i va = _mm256_loadu_si256((const __m256i*)a);
+    __m256i vb = _mm256_loadu_si256((const __m256i*)b);
+    const __m256i rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+    __m256i matches = _mm256_cmpeq_epi32(va, vb);
+    for (int i = 1; i < 8; ++i) {
+        vb = _mm256_permutevar8x32_epi32(vb, rotate);
+        matches = _mm256_or_si256(matches, _mm256_cmpeq_epi32(va, vb));
+    }
+    return _mm256_movemask_ps(_mm256_castsi256_ps(matches));
+}
+
+static uint32_t match_mask(const uint64_t* a, const uint64_t* b) {
+    __m256i va = _mm256_loadu_si256((const __m256i*)a);
+    __m256i vb = _mm256_loadu_si256((const __m256i*)b);
+    __m256i matches = _mm256_cmpeq_epi64(va, vb);
+    for (int i = 1; i < 4; ++i) {
+        vb = _mm256_permute4x64_epi64(vb, _MM_SHUFFLE(0, 3, 2, 1));
+        matches = _mm256_or_si256(matches, _mm256_cmpeq_epi64(va, vb));
+    }
+    return _mm256_movemask_pd(_mm256_castsi256_pd(matches));
+}
+#else
+static constexpr const size_t vector_size = 16;
+
+static uint32_t match_mask(const uint32_t* a, const uint32_t* b) {
+    __m128i va = _mm_loadu_si128((const __m128i*)a);
+    __m128i vb = _mm_loadu_si128((const __m128i*)b);
+    __m128i matches = _mm_cmpeq_epi32(va, vb);
+    for (int i = 1; i < 4; ++i) {
+        vb = _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1));
+        matches = _mm_or_si128(matches, _mm_cmpeq_epi32(va, vb));
+    }
+    return _mm_movemask_ps(_mm_castsi128_ps(matches));
+}
+
+/// SSE2 doesn't have `_mm_cmpeq_epi64` so compare the
+/// halves separately and then require both halves to match.
+static __m128i cmpeq_epi64(__m128i a, __m128i b) {
+    __m128i halves = _mm_cmpeq_epi32(a, b);
+    return _mm_and_si128(halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1)));
+}
+
+static uint32_t match_mask(const uint64_t* a, const uint64_t* b) {
+    __m128i va = _mm_loadu_si128((const __m128i*)a);
+    __m128i vb = _mm_loadu_si128((const __m128i*)b);
+    __m128i swapped = _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2));
+    __m128i matches = _mm_or_si128(cmpeq_epi64(va, vb), cmpeq_epi64(va, swapped));
+    return _mm_movemask_pd(_mm_castsi128_pd(matches));
+}
+#endif
+
+/// Intersect blocks of `width` elements at a time.  Stops when either side has less
+/// than a block left and returns how far it got through each side in `*i` and `*j`.
+template <class T>
+static size_t intersection_blocks(cz::Slice<T> a, cz::Slice<T> b, T* out, size_t* i, size_t* j) {
+    constexpr const size_t width = vector_size / sizeof(T);
+    size_t count = 0;
+    while (*i + width <= a.len && *j + width <= b.len) {
+        uint32_t mask = match_mask(a.elems + *i, b.elems + *j);
+        for (; mask; mask &= mask - 1) {
+            out[count++] = a[*i + lowest_bit(mask)];
+        }
+
+        // Advance whichever block ends first.  Each element is unique so the elements
+        // of the other block can't match anything from the block we advance past.
+        T a_last = a[*i + width - 1];
+        T b_last = b[*j + width - 1];
+        *i += (a_last <= b_last) * width;
+        *j += (b_last <= a_last) * width;
+    }
+    return count;
+}
+
+/// Subtract blocks of `width` elements at a time.  Stops when either side
+/// has less than a block left.  Elements of `a` are only written once every
+/// block of `b` they could match has been compared against them.
+template <class T>
+static size_t difference_blocks(cz::Slice<T> a, cz::Slice<T> b, T* out, size_t* i, size_t* j) {
+    constexpr const size_t width = vector_size / sizeof(T);
+    constexpr const uint32_t all = (1 << width) - 1;
+    size_t count = 0;
+    uint32_t matched = 0;
+    while (*i + width <= a.len && *j + width <= b.len) {
+        matched |= match_mask(a.elems + *i, b.elems + *j);
+
+        T a_last = a[*i + width - 1];
+        T b_last = b[*j + width - 1];
+        if (a_last <= b_last) {
+            uint32_t unmatched = ~matched & all;
+            if (unmatched == all) {
+                memcpy(out + count, a.elems + *i, sizeof(T) * width);
+                count += width;
+            } else {
+                for (; unmatched; unmatched &= unmatched - 1) {
+                    out[count++] = a[*i + lowest_bit(unmatched)];
+                }
+            }
+            matched = 0;
+            *i += width;
+        }
+        if (b_last <= a_last) {
+            *j += width;
+        }
+    }
+
+    // The current block of `a` has been compared against every full block of `b` that could
+    // match it.  Compare the rest against the less than `width` elements left in `b`.
+    if (*i + width <= a.len) {
+        for (size_t k = 0; k < width; ++k) {
+            if (matched & (1 << k)) {
+                continue;
+            }
+            T elem = a[*i + k];
+            bool found = false;
+            for (size_t l = *j; l < b.len; ++l) {
+                found |= (b[l] == elem);
+            }
+            if (!found) {
+                out[count++] = elem;
+            }
+        }
+        *i += width;
+    }
+
+    return count;
+}
+#endif
+
+/// Union by galloping through `large` for each element in `small`
+/// and copying the elements of `large` in between all at once.
+template <class T>
+static cz::Slice<T> gallop_union(cz::Slice<T> small, cz::Slice<T> large, T* out) {
+    auto is_less = generic_is_less_ptr<T>;
+    size_t count = 0;
+    T* large_start = large.start();
+    for (size_t i = 0; i < small.len; ++i) {
+        T* next = sorted_set_impl::gallop(large_start, large.end(), &small[i], is_less);
+        memcpy(out + count, large_start, sizeof(T) * (next - large_start));
+        count += next - large_start;
+        large_start = next;
+
+        out[count++] = small[i];
+        if (large_start < large.end() && *large_start == small[i]) {
+            ++large_start;
+        }
+    }
+
+    memcpy(out + count, large_start, sizeof(T) * (large.end() - large_start));
+    count += large.end() - large_start;
+    return {out, count};
+}
+
+template <class T>
+static cz::Slice<T> set_union_integers(cz::Slice<T> a, cz::Slice<T> b, T* out) {
+    if (a.len * sorted_set_impl::gallop_ratio < b.len) {
+        return gallop_union(a, b, out);
+    }
+    if (b.len * sorted_set_impl::gallop_ratio < a.len) {
+        return gallop_union(b, a, out);
+    }
+
+    size_t i = 0;
+    size_t j = 0;
+    size_t count = 0;
+
+    // Branchless merge.  Equal elements advance both sides.
+    while (i < a.len && j < b.len) {
+        T x = a[i];
+        T y = b[j];
+        out[count++] = x < y ? x : y;
+        i += x <= y;
+        j += y <= x;
+    }
+
+    memcpy(out + count, a.elems + i, sizeof(T) * (a.len - i));
+    count += a.len - i;
+    memcpy(out + count, b.elems + j, sizeof(T) * (b.len - j));
+    count += b.len - j;
+    return {out, count};
+}
+
+template <class T>
+static cz::Slice<T> set_intersection_integers(cz::Slice<T> a, cz::Slice<T> b, T* out) {
+    if (a.len * sorted_set_impl::gallop_ratio < b.len ||
+        b.len * sorted_set_impl::gallop_ratio < a.len) {
+        return set_intersection(a, b, out, generic_is_less_ptr<T>);
+    }
+
+    size_t i = 0;
+    size_t j = 0;
+    size_t count = 0;
+#ifdef CZ_SORTED_SET_SIMD
+    count = intersection_blocks(a, b, out, &i, &j);
+#endif
+
+    while (i < a.len && j < b.len) {
+        T x = a[i];
+        T y = b[j];
+        out[count] = x;
+        count += x == y;
+        i += x <= y;
+        j += y <= x;
+    }
+    return {out, count};
+}
+
+template <class T>
+static cz::Slice<T> set_difference_integers(cz::Slice<T> a, cz::Slice<T> b, T* out) {
+    if (a.len * sorted_set_impl::gallop_ratio < b.len) {
+        return set_difference(a, b, out, generic_is_less_ptr<T>);
+    }
+
+    size_t i = 0;
+    size_t j = 0;
+    size_t count = 0;
+#ifdef CZ_SORTED_SET_SIMD
+    count = difference_blocks(a, b, out, &i, &j);
+#endif
+
+    while (i < a.len && j < b.len) {
+        T x = a[i];
+        T y = b[j];
+        out[count] = x;
+        count += x < y;
+        i += x <= y;
+        j += y <= x;
+    }
+
+    memcpy(out + count, a.elems + i, sizeof(T) * (a.len - i));
+    count += a.len - i;
+    return {out, count};
+}
+
+cz::Slice<uint32_t> set_union(cz::Slice<uint32_t> a, cz::Slice<uint32_t> b, uint32_t* out) {
+    return set_union_integers(a, b, out);
+}
+cz::Slice<uint64_t> set_union(cz::Slice<uint64_t> a, cz::Slice<uint64_t> b, uint64_t* out) {
+    return set_union_integers(a, b, out);
+}
+
+cz::Slice<uint32_t> set_intersection(cz::Slice<uint32_t> a, cz::Slice<uint32_t> b, uint32_t* out) {
+    return set_intersection_integers(a, b, out);
+}
+cz::Slice<uint64_t> set_intersection(cz::Slice<uint64_t> a, cz::Slice<uint64_t> b, uint64_t* out) {
+    return set_intersection_integers(a, b, out);
+}
+
+cz::Slice<uint32_t> set_difference(cz::Slice<uint32_t> a, cz::Slice<uint32_t> b, uint32_t* out) {
+    return set_difference_integers(a, b, out);
+}
+cz::Slice<uint64_t> set_difference(cz::Slice<uint64_t> a, cz::Slice<uint64_t> b, uint64_t* out) {
+    return set_difference_integers(a, b, out);
+}
+
+}
@@ -2,6 +2,7 @@
 
 #ifndef _WIN32
 
+#include <sys/mman.h>
 #include <unistd.h>
 
 namespace cz {
@@ -11,6 +12,29 @@ size_t page_size() {
     return sysconf(_SC_PAGESIZE);
 }
 
+void* reserve_memory(size_t size) {
+    void* ptr = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+                     /*fd=*/-1, /*offset=*/0);
+    if (ptr == MAP_FAILED) {
+        return nullptr;
+    }
+    return ptr;
+}
+
+bool commit_memory(void* start, size_t size) {
+    return mprotect(start, size, PROT_READ | PROT_WRITE) == 0;
+}
+
+void decommit_memory(void* start, size_t size) {
+    // Drop the pages so RSS goes down and then make them inaccessible again.
+    madvise(start, size, MADV_DONTNEED);
+    mprotect(start, size, PROT_NONE);
+}
+
+void release_memory(void* start, size_t size) {
+    munmap(start, size);
+}
+
 }
 }
 
@@ -15,6 +15,22 @@ size_t page_size() {
     return info.dwAllocationGranularity;
 }
 
+void* reserve_memory(size_t size) {
+    return VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+}
+
+bool commit_memory(void* start, size_t size) {
+    return VirtualAlloc(start, size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+}
+
+void decommit_memory(void* start, size_t size) {
+    VirtualFree(start, size, MEM_DECOMMIT);
+}
+
+void release_memory(void* start, size_t size) {
+    VirtualFree(start, 0, MEM_RELEASE);
+}
+
 }
 }
 
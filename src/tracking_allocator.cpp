@@ -0,0 +1,337 @@
+#include <cz/tracking_allocator.hpp>
+
+#include <string.h>
+#include <cz/defer.hpp>
+#include <cz/format.hpp>
+#include <cz/heap.hpp>
+#include <cz/string.hpp>
+
+namespace cz {
+
+constexpr const size_t Allocation_Stats::num_buckets;
+
+size_t Allocation_Stats::bucket(size_t size) {
+    size_t bucket = 0;
+    while (((size_t)1 << bucket) < size && bucket + 1 < num_buckets) {
+        ++bucket;
+    }
+    return bucket;
+}
+
+void Tracking_Allocator::init(Allocator backer, bool track_sites) {
+    this->backer = backer;
+    this->track_sites = track_sites;
+    mutex.init();
+    memset(&_stats, 0, sizeof(_stats));
+
+    unknown_site = {};
+    unknown_site.tracker = this;
+
+    _record_keys = nullptr;
+    _record_sites = nullptr;
+    _records_cap = 0;
+    _records_count = 0;
+}
+
+void Tracking_Allocator::drop() {
+    Tracking_Site* site = unknown_site.next;
+    while (site) {
+        Tracking_Site* next = site->next;
+        cz::heap_allocator().dealloc(site);
+        site = next;
+    }
+
+    cz::heap_allocator().dealloc(_record_keys, _records_cap);
+    cz::heap_allocator().dealloc(_record_sites, _records_cap);
+
+    mutex.drop();
+}
+
+Allocator Tracking_Allocator::allocator(SourceLocation location) {
+    mutex.lock();
+    CZ_DEFER(mutex.unlock());
+
+    Tracking_Site** site = &unknown_site.next;
+    for (; *site; site = &(*site)->next) {
+        if ((*site)->location.line == location.line &&
+            strcmp((*site)->location.file, location.file) == 0) {
+            return {Tracking_Allocator::realloc, Tracking_Allocator::dealloc, *site,
+                    Tracking_Allocator::expand_in_place};
+        }
+    }
+
+    *site = cz::heap_allocator().alloc<Tracking_Site>();
+    CZ_ASSERT(*site);
+    **site = {};
+    (*site)->tracker = this;
+    (*site)->location = location;
+    return {Tracking_Allocator::realloc, Tracking_Allocator::dealloc, *site,
+            Tracking_Allocator::expand_in_place};
+}
+
+Allocation_Stats Tracking_Allocator::stats() {
+    mutex.lock();
+    CZ_DEFER(mutex.unlock());
+    return _stats;
+}
+
+void Tracking_Allocator::reset_peak() {
+    mutex.lock();
+    CZ_DEFER(mutex.unlock());
+    _stats.peak_bytes = _stats.live_bytes;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Outstanding allocation records
+///////////////////////////////////////////////////////////////////////////////
+
+static size_t record_index(void* key, size_t cap) {
+    uint64_t hash = (uint64_t)(uintptr_t)key * 0x9E3779B97F4A7C15ull;
+    return (size_t)(hash >> 32) & (cap - 1);
+}
+
+static void insert_record(Tracking_Allocator* tracker, void* key, Tracking_Site* site);
+
+static void grow_records(Tracking_Allocator* tracker) {
+    void** old_keys = tracker->_record_keys;
+    Tracking_Site** old_sites = tracker->_record_sites;
+    size_t old_cap = tracker->_records_cap;
+
+    size_t new_cap = old_cap == 0 ? 64 : old_cap * 2;
+    tracker->_record_keys = cz::heap_allocator().alloc_zeroed<void*>(new_cap);
+    tracker->_record_sites = cz::heap_allocator().alloc<Tracking_Site*>(new_cap);
+    CZ_ASSERT(tracker->_record_keys);
+    CZ_ASSERT(tracker->_record_sites);
+    tracker->_records_cap = new_cap;
+    tracker->_records_count = 0;
+
+    for (size_t i = 0; i < old_cap; ++i) {
+        if (old_keys[i]) {
+            insert_record(tracker, old_keys[i], old_sites[i]);
+        }
+    }
+
+    cz::heap_allocator().dealloc(old_keys, old_cap);
+    cz::heap_allocator().dealloc(old_sites, old_cap);
+}
+
+static void insert_record(Tracking_Allocator* tracker, void* key, Tracking_Site* site) {
+    // Keep the load factor under 1/2.
+    if (2 * (tracker->_records_count + 1) > tracker->_records_cap) {
+        grow_records(tracker);
+    }
+
+    size_t mask = tracker->_records_cap - 1;
+    size_t index = record_index(key, tracker->_records_cap);
+    while (tracker->_record_keys[index]) {
+        index = (index + 1) & mask;
+    }
+    tracker->_record_keys[index] = key;
+    tracker->_record_sites[index] = site;
+    ++tracker->_records_count;
+}
+
+/// Remove the record for `key` and return its site.
+static Tracking_Site* remove_record(Tracking_Allocator* tracker, void* key) {
+    if (tracker->_records_cap == 0) {
+        return nullptr;
+    }
+
+    size_t mask = tracker->_records_cap - 1;
+    size_t index = record_index(key, tracker->_records_cap);
+    while (tracker->_record_keys[index] != key) {
+        if (!tracker->_record_keys[index]) {
+            return nullptr;
+        }
+        index = (index + 1) & mask;
+    }
+
+    Tracking_Site* site = tracker->_record_sites[index];
+    --tracker->_records_count;
+
+    // Backward shift deletion: move later entries in the probe chain into the hole.
+    size_t hole = index;
+    for (size_t next = (hole + 1) & mask; tracker->_record_keys[next]; next = (next + 1) & mask) {
+        size_t desired = record_index(tracker->_record_keys[next], tracker->_records_cap);
+        // Move the entry if the hole lies between its desired slot and its current slot.
+        if (((next - desired) & mask) >= ((next - hole) & mask)) {
+            tracker->_record_keys[hole] = tracker->_record_keys[next];
+            tracker->_record_sites[hole] = tracker->_record_sites[next];
+            hole = next;
+        }
+    }
+    tracker->_record_keys[hole] = nullptr;
+
+    return site;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Allocator interface
+///////////////////////////////////////////////////////////////////////////////
+
+/// Record that `old_mem` was deallocated.  Returns the site that allocated
+/// it or `nullptr` if sites aren't tracked.  Must hold the lock.
+static Tracking_Site* track_dealloc(Tracking_Allocator* tracker, MemSlice old_mem) {
+    tracker->_stats.live_bytes -= old_mem.size;
+    --tracker->_stats.live_allocations;
+
+    if (!tracker->track_sites) {
+        return nullptr;
+    }
+
+    Tracking_Site* site = remove_record(tracker, old_mem.buffer);
+    if (site) {
+        site->live_bytes -= old_mem.size;
+        --site->live_allocations;
+    }
+    return site;
+}
+
+/// Undo `track_dealloc` after the backer failed to reallocate `old_mem`.  Must hold the lock.
+static void untrack_dealloc(Tracking_Allocator* tracker, Tracking_Site* site, MemSlice old_mem) {
+    tracker->_stats.live_bytes += old_mem.size;
+    ++tracker->_stats.live_allocations;
+
+    if (site) {
+        insert_record(tracker, old_mem.buffer, site);
+        site->live_bytes += old_mem.size;
+        ++site->live_allocations;
+    }
+}
+
+/// Record that `new_mem` was allocated by `site`.  Must hold the lock.
+static void track_alloc(Tracking_Allocator* tracker, Tracking_Site* site, MemSlice new_mem) {
+    Allocation_Stats* stats = &tracker->_stats;
+    stats->live_bytes += new_mem.size;
+    ++stats->live_allocations;
+    if (stats->live_bytes > stats->peak_bytes) {
+        stats->peak_bytes = stats->live_bytes;
+    }
+    ++stats->histogram[Allocation_Stats::bucket(new_mem.size)];
+
+    if (tracker->track_sites) {
+        insert_record(tracker, new_mem.buffer, site);
+        site->live_bytes += new_mem.size;
+        ++site->live_allocations;
+    }
+}
+
+void* Tracking_Allocator::realloc(void* _site, MemSlice old_mem, AllocInfo new_info) {
+    Tracking_Site* site = (Tracking_Site*)_site;
+    Tracking_Allocator* tracker = site->tracker;
+
+    // Forget `old_mem` before the backer can free it.  Otherwise another thread
+    // could be given the same address and record it before we remove our record.
+    Tracking_Site* old_site = nullptr;
+    if (old_mem.buffer) {
+        tracker->mutex.lock();
+        CZ_DEFER(tracker->mutex.unlock());
+        old_site = track_dealloc(tracker, old_mem);
+    }
+
+    void* ptr = tracker->backer.realloc(old_mem, new_info);
+
+    tracker->mutex.lock();
+    CZ_DEFER(tracker->mutex.unlock());
+
+    if (!ptr) {
+        // `old_mem` is still allocated.
+        if (old_mem.buffer) {
+            untrack_dealloc(tracker, old_site, old_mem);
+        }
+        return nullptr;
+    }
+
+    if (old_mem.buffer) {
+        ++tracker->_stats.total_reallocations;
+    } else {
+        ++tracker->_stats.total_allocations;
+    }
+    track_alloc(tracker, site, {ptr, new_info.size});
+
+    return ptr;
+}
+
+void Tracking_Allocator::dealloc(void* _site, MemSlice old_mem) {
+    if (!old_mem.buffer) {
+        return;
+    }
+
+    Tracking_Site* site = (Tracking_Site*)_site;
+    Tracking_Allocator* tracker = site->tracker;
+
+    {
+        tracker->mutex.lock();
+        CZ_DEFER(tracker->mutex.unlock());
+
+        ++tracker->_stats.total_deallocations;
+        track_dealloc(tracker, old_mem);
+    }
+
+    tracker->backer.dealloc(old_mem);
+}
+
+bool Tracking_Allocator::expand_in_place(void* _site, MemSlice old_mem, size_t new_size) {
+    Tracking_Site* site = (Tracking_Site*)_site;
+    Tracking_Allocator* tracker = site->tracker;
+
+    // Call the hook directly since `Allocator::try_expand_in_place` already
+    // filled the memory for the outer allocator in debug mode.
+    Allocator backer = tracker->backer;
+    if (!backer.expand_in_place || !backer.expand_in_place(backer.data, old_mem, new_size)) {
+        return false;
+    }
+
+    tracker->mutex.lock();
+    CZ_DEFER(tracker->mutex.unlock());
+
+    ++tracker->_stats.total_reallocations;
+    track_dealloc(tracker, old_mem);
+    track_alloc(tracker, site, {old_mem.buffer, new_size});
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Formatting
+///////////////////////////////////////////////////////////////////////////////
+
+static void append_site(Allocator allocator, String* string, Tracking_Site* site) {
+    if (site->live_allocations == 0) {
+        return;
+    }
+
+    if (site->location.file) {
+        append(allocator, string, site->location.file, ':', site->location.line);
+    } else {
+        append(allocator, string, "<unknown>");
+    }
+    append(allocator, string, ": ", site->live_bytes, " bytes in ", site->live_allocations,
+           " allocations\n");
+}
+
+void Tracking_Allocator::append_live_sites(Allocator allocator, String* string) {
+    mutex.lock();
+    CZ_DEFER(mutex.unlock());
+
+    for (Tracking_Site* site = &unknown_site; site; site = site->next) {
+        append_site(allocator, string, site);
+    }
+}
+
+void append(Allocator allocator, String* string, const Allocation_Stats& stats) {
+    append(allocator, string, "Live bytes: ", stats.live_bytes, '\n');
+    append(allocator, string, "Peak bytes: ", stats.peak_bytes, '\n');
+    append(allocator, string, "Live allocations: ", stats.live_allocations, '\n');
+    append(allocator, string, "Total allocations: ", stats.total_allocations, '\n');
+    append(allocator, string, "Total reallocations: ", stats.total_reallocations, '\n');
+    append(allocator, string, "Total deallocations: ", stats.total_deallocations, '\n');
+    append(allocator, string, "Size histogram:\n");
+    for (size_t i = 0; i < Allocation_Stats::num_buckets; ++i) {
+        if (stats.histogram[i] == 0) {
+            continue;
+        }
+        append(allocator, string, "  <= ", (size_t)1 << i, ": ", stats.histogram[i], '\n');
+    }
+}
+
+}
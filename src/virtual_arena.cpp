@@ -0,0 +1,111 @@
+#include <cz/virtual_arena.hpp>
+
+#include <cz/assert.hpp>
+#include <cz/sys.hpp>
+#include <cz/util.hpp>
+
+namespace cz {
+
+constexpr const size_t Virtual_Arena::commit_granularity;
+
+static size_t round_up(size_t value, size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+static size_t commit_step() {
+    return round_up(Virtual_Arena::commit_granularity, sys::page_size());
+}
+
+bool Virtual_Arena::init(size_t reserve_size) {
+    reserve_size = round_up(reserve_size, sys::page_size());
+    char* start = (char*)sys::reserve_memory(reserve_size);
+    if (!start) {
+        return false;
+    }
+
+    arena.init(start, 0);
+    reserved_end = start + reserve_size;
+    return true;
+}
+
+void Virtual_Arena::drop() {
+    sys::release_memory(arena.start, reserved_end - arena.start);
+}
+
+void Virtual_Arena::clear() {
+    arena.pointer = arena.start;
+    decommit_unused();
+}
+
+void Virtual_Arena::decommit_unused() {
+    size_t used = round_up(arena.pointer - arena.start, commit_step());
+    char* new_end = arena.start + used;
+    if (new_end < arena.end) {
+        sys::decommit_memory(new_end, arena.end - new_end);
+        arena.end = new_end;
+    }
+}
+
+/// Commit enough memory that `arena.end >= target`.
+static bool commit_until(Virtual_Arena* va, char* target) {
+    if (target <= va->arena.end) {
+        return false;
+    }
+
+    size_t new_committed = round_up(target - va->arena.start, commit_step());
+    char* new_end = cz::min(va->arena.start + new_committed, va->reserved_end);
+    if (!sys::commit_memory(va->arena.end, new_end - va->arena.end)) {
+        return false;
+    }
+
+    va->arena.end = new_end;
+    return true;
+}
+
+void* Virtual_Arena::realloc(void* _va, MemSlice old_mem, AllocInfo new_info) {
+    Virtual_Arena* va = (Virtual_Arena*)_va;
+
+    void* ptr = Arena::realloc(&va->arena, old_mem, new_info);
+    if (ptr) {
+        return ptr;
+    }
+
+    // Commit more memory and try again.  Allocations are placed at the end of
+    // the arena unless we're reallocating the last allocation (in place).
+    char* start = va->arena.pointer;
+    if (old_mem.buffer && old_mem.end() == va->arena.pointer) {
+        start = (char*)old_mem.buffer;
+    }
+    size_t needed =
+        cz::min(new_info.size + new_info.alignment, (size_t)(va->reserved_end - start));
+    if (!commit_until(va, start + needed)) {
+        return nullptr;
+    }
+
+    return Arena::realloc(&va->arena, old_mem, new_info);
+}
+
+bool Virtual_Arena::expand_in_place(void* _va, MemSlice old_mem, size_t new_size) {
+    Virtual_Arena* va = (Virtual_Arena*)_va;
+
+    if (Arena::expand_in_place(&va->arena, old_mem, new_size)) {
+        return true;
+    }
+
+    // Only the most recent allocation can grow.  Commit more memory and try again.
+    if (old_mem.end() != va->arena.pointer ||
+        new_size > (size_t)(va->reserved_end - (char*)old_mem.buffer)) {
+        return false;
+    }
+    if (!commit_until(va, (char*)old_mem.buffer + new_size)) {
+        return false;
+    }
+
+    return Arena::expand_in_place(&va->arena, old_mem, new_size);
+}
+
+void Virtual_Arena::dealloc(void* va, MemSlice old_mem) {
+    Arena::dealloc(&((Virtual_Arena*)va)->arena, old_mem);
+}
+
+}
@@ -126,3 +126,44 @@ TEST_CASE("Arena realloc smaller size") {
     REQUIRE(mem == arena.start);
     REQUIRE(arena.remaining() == 6);
 }
+
+TEST_CASE("Arena realloc not most recent allocation copies") {
+    char buffer[16] = {0};
+    Arena arena;
+    arena.init(buffer, 16);
+
+    char* mem = (char*)arena.allocator().alloc({4, 1});
+    memset(mem, '*', 4);
+    arena.allocator().alloc({2, 1});
+
+    char* mem2 = (char*)arena.allocator().realloc({mem, 4}, {2, 1});
+    REQUIRE(mem2 == buffer + 6);
+    REQUIRE(mem2[0] == '*');
+    REQUIRE(mem2[1] == '*');
+    REQUIRE(arena.remaining() == 8);
+}
+
+TEST_CASE("Arena expand_in_place most recent allocation") {
+    char buffer[16] = {0};
+    Arena arena;
+    arena.init(buffer, 16);
+
+    char* mem = (char*)arena.allocator().alloc({4, 1});
+    REQUIRE(arena.allocator().try_expand_in_place({mem, 4}, 12));
+    REQUIRE(arena.remaining() == 4);
+
+    REQUIRE_FALSE(arena.allocator().try_expand_in_place({mem, 12}, 17));
+    REQUIRE(arena.remaining() == 4);
+}
+
+TEST_CASE("Arena expand_in_place not most recent allocation fails") {
+    char buffer[16] = {0};
+    Arena arena;
+    arena.init(buffer, 16);
+
+    char* mem = (char*)arena.allocator().alloc({4, 1});
+    arena.allocator().alloc({2, 1});
+
+    REQUIRE_FALSE(arena.allocator().try_expand_in_place({mem, 4}, 8));
+    REQUIRE(arena.remaining() == 10);
+}
@@ -0,0 +1,141 @@
+#include <czt/test_base.hpp>
+
+#include <stdint.h>
+#include <algorithm>
+#include <cz/binary_search.hpp>
+#include <cz/defer.hpp>
+#include <cz/eytzinger_index.hpp>
+#include <cz/heap.hpp>
+#include <random>
+
+using namespace cz;
+
+static int64_t compare_uint32(const uint32_t& left, const uint32_t& right) {
+    return (int64_t)left - (int64_t)right;
+}
+
+TEST_CASE("binary_search empty") {
+    size_t index = 100;
+    CHECK_FALSE(binary_search(cz::Slice<int>{}, 3, &index));
+    CHECK(index == 0);
+    CHECK(lower_bound(cz::Slice<int>{}, 3) == 0);
+}
+
+TEST_CASE("binary_search finds the first duplicate") {
+    int data[] = {1, 3, 3, 3, 5, 7, 7};
+    size_t index;
+    REQUIRE(binary_search(cz::slice(data), 3, &index));
+    CHECK(index == 1);
+    REQUIRE(binary_search(cz::slice(data), 7, &index));
+    CHECK(index == 5);
+    CHECK_FALSE(binary_search(cz::slice(data), 0, &index));
+    CHECK(index == 0);
+    CHECK_FALSE(binary_search(cz::slice(data), 4, &index));
+    CHECK(index == 4);
+    CHECK_FALSE(binary_search(cz::slice(data), 8, &index));
+    CHECK(index == 7);
+}
+
+TEST_CASE("lower_bound matches std::lower_bound") {
+    std::mt19937 rand(1234);
+    for (size_t length = 0; length < 70; ++length) {
+        uint32_t* data = (uint32_t*)malloc(sizeof(uint32_t) * (length + 1));
+        CZ_DEFER(free(data));
+        for (size_t i = 0; i < length; ++i) {
+            data[i] = rand() % 100;
+        }
+        std::sort(data, data + length);
+
+        for (uint32_t element = 0; element <= 100; ++element) {
+            size_t expected = std::lower_bound(data, data + length, element) - data;
+            INFO("length: " << length << ", element: " << element);
+            REQUIRE(lower_bound(cz::Slice<uint32_t>{data, length}, element) == expected);
+            REQUIRE(lower_bound(cz::Slice<uint32_t>{data, length}, element, compare_uint32) ==
+                    expected);
+
+            size_t index;
+            bool found = binary_search(cz::Slice<uint32_t>{data, length}, element, &index,
+                                       compare_uint32);
+            REQUIRE(index == expected);
+            REQUIRE(found == (expected < length && data[expected] == element));
+        }
+    }
+}
+
+TEST_CASE("Eytzinger_Index matches std::lower_bound") {
+    std::mt19937 rand(1234);
+    const size_t lengths[] = {0, 1, 2, 3, 7, 8, 15, 16, 17, 100, 1000, 4095, 4096};
+    for (size_t length : lengths) {
+        uint32_t* data = (uint32_t*)malloc(sizeof(uint32_t) * (length + 1));
+        CZ_DEFER(free(data));
+        for (size_t i = 0; i < length; ++i) {
+            data[i] = rand() % (2 * length + 1);
+        }
+        std::sort(data, data + length);
+
+        Eytzinger_Index<uint32_t> index;
+        index.init(heap_allocator(), cz::Slice<uint32_t>{data, length});
+        CZ_DEFER(index.drop(heap_allocator()));
+
+        for (uint32_t element = 0; element <= 2 * length + 2; ++element) {
+            size_t expected = std::lower_bound(data, data + length, element) - data;
+            INFO("length: " << length << ", element: " << element);
+            REQUIRE(index.lower_bound(element) == expected);
+
+            size_t found_index;
+            bool found = index.find(element, &found_index);
+            REQUIRE(found_index == expected);
+            REQUIRE(found == (expected < length && data[expected] == element));
+        }
+    }
+}
+
+TEST_CASE("lower_bound_many matches std::lower_bound") {
+    std::mt19937 rand(1234);
+    const size_t lengths[] = {0, 1, 2, 17, 100, 10000};
+    const size_t query_counts[] = {0, 1, 15, 16, 17, 1000};
+    for (size_t length : lengths) {
+        uint32_t* data = (uint32_t*)malloc(sizeof(uint32_t) * (length + 1));
+        CZ_DEFER(free(data));
+        for (size_t i = 0; i < length; ++i) {
+            data[i] = rand() % (2 * length + 1);
+        }
+        std::sort(data, data + length);
+
+        for (size_t num_queries : query_counts) {
+            uint32_t* queries = (uint32_t*)malloc(sizeof(uint32_t) * (num_queries + 1));
+            CZ_DEFER(free(queries));
+            size_t* indices = (size_t*)malloc(sizeof(size_t) * (num_queries + 1));
+            CZ_DEFER(free(indices));
+            bool* found = (bool*)malloc(sizeof(bool) * (num_queries + 1));
+            CZ_DEFER(free(found));
+
+            for (int sorted = 0; sorted < 2; ++sorted) {
+                for (size_t i = 0; i < num_queries; ++i) {
+                    queries[i] = rand() % (2 * length + 3);
+                }
+                if (sorted) {
+                    std::sort(queries, queries + num_queries);
+                }
+
+                cz::Slice<uint32_t> slice = {data, length};
+                cz::Slice<uint32_t> query_slice = {queries, num_queries};
+                INFO("length: " << length << ", queries: " << num_queries
+                                << ", sorted: " << sorted);
+
+                binary_search_many(slice, query_slice, indices, found);
+                for (size_t i = 0; i < num_queries; ++i) {
+                    size_t expected = std::lower_bound(data, data + length, queries[i]) - data;
+                    REQUIRE(indices[i] == expected);
+                    REQUIRE(found[i] == (expected < length && data[expected] == queries[i]));
+                }
+
+                lower_bound_many(slice, query_slice, indices, compare_uint32);
+                for (size_t i = 0; i < num_queries; ++i) {
+                    size_t expected = std::lower_bound(data, data + length, queries[i]) - data;
+                    REQUIRE(indices[i] == expected);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,107 @@
+#include <czt/test_base.hpp>
+
+#include <cz/bucket_array.hpp>
+#include <cz/defer.hpp>
+#include <cz/heap.hpp>
+
+using namespace cz;
+
+TEST_CASE("Bucket_Array push and index across buckets") {
+    Bucket_Array<int, 4> array = {};
+    CZ_DEFER(array.drop(heap_allocator()));
+
+    for (int i = 0; i < 10; ++i) {
+        array.reserve(heap_allocator(), 1);
+        array.push(i);
+    }
+
+    REQUIRE(array.len == 10);
+    CHECK(array.capacity() == 12);
+    CHECK(array.num_buckets() == 3);
+    for (int i = 0; i < 10; ++i) {
+        CHECK(array[i] == i);
+    }
+    CHECK(array.bucket(2).len == 2);
+    CHECK(array.last() == 9);
+}
+
+TEST_CASE("Bucket_Array pointers stay valid while growing") {
+    Bucket_Array<size_t, 8> array = {};
+    CZ_DEFER(array.drop(heap_allocator()));
+
+    array.reserve(heap_allocator(), 1);
+    size_t* first = array.push(42);
+    for (size_t i = 0; i < 1000; ++i) {
+        array.reserve(heap_allocator(), 1);
+        array.push(i);
+    }
+
+    CHECK(first == &array[0]);
+    CHECK(*first == 42);
+}
+
+TEST_CASE("Bucket_Array pop, swap_remove, and trim") {
+    Bucket_Array<int, 4> array = {};
+    CZ_DEFER(array.drop(heap_allocator()));
+
+    array.reserve(heap_allocator(), 9);
+    for (int i = 0; i < 9; ++i) {
+        array.push(i);
+    }
+
+    CHECK(array.pop() == 8);
+    array.swap_remove(1);
+    CHECK(array.len == 7);
+    CHECK(array[1] == 7);
+
+    array.trim(heap_allocator());
+    CHECK(array.capacity() == 8);
+
+    int sum = 0;
+    array.for_each([&](int x) { sum += x; });
+    CHECK(sum == 0 + 7 + 2 + 3 + 4 + 5 + 6);
+}
+
+TEST_CASE("Bucket_Pool reuses removed slots") {
+    Bucket_Pool<int, 4> pool = {};
+    CZ_DEFER(pool.drop(heap_allocator()));
+
+    Bucket_Handle a = pool.insert(heap_allocator(), 1);
+    Bucket_Handle b = pool.insert(heap_allocator(), 2);
+    int* b_ptr = pool.get(b);
+    CHECK(pool.count == 2);
+
+    CHECK(pool.remove(heap_allocator(), a));
+    CHECK_FALSE(pool.remove(heap_allocator(), a));
+    CHECK(pool.get(a) == nullptr);
+    CHECK(pool.count == 1);
+
+    Bucket_Handle c = pool.insert(heap_allocator(), 3);
+    CHECK(c.index == a.index);
+    CHECK(c.generation != a.generation);
+    CHECK(pool.get(a) == nullptr);
+    CHECK(*pool.get(c) == 3);
+    CHECK(pool.get(b) == b_ptr);
+}
+
+TEST_CASE("Bucket_Pool for_each skips removed elements") {
+    Bucket_Pool<int, 4> pool = {};
+    CZ_DEFER(pool.drop(heap_allocator()));
+
+    Bucket_Handle handles[10];
+    for (int i = 0; i < 10; ++i) {
+        handles[i] = pool.insert(heap_allocator(), i);
+    }
+    for (int i = 0; i < 10; i += 2) {
+        pool.remove(heap_allocator(), handles[i]);
+    }
+
+    int sum = 0;
+    size_t visited = 0;
+    pool.for_each([&](int x) {
+        sum += x;
+        ++visited;
+    });
+    CHECK(visited == 5);
+    CHECK(sum == 1 + 3 + 5 + 7 + 9);
+}
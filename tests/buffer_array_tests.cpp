@@ -0,0 +1,75 @@
+#include <czt/test_base.hpp>
+
+#include <cz/buffer_array.hpp>
+#include <cz/defer.hpp>
+
+using namespace cz;
+
+TEST_CASE("Buffer_Array custom buffer size") {
+    Buffer_Array buffer_array;
+    buffer_array.init(0x100);
+    CZ_DEFER(buffer_array.drop());
+
+    CHECK(buffer_array.allocator().alloc({0x80, 1}));
+    CHECK(buffer_array.buffer_index == 0);
+    CHECK(buffer_array.allocator().alloc({0x80, 1}));
+    CHECK(buffer_array.buffer_index == 0);
+    CHECK(buffer_array.allocator().alloc({0x80, 1}));
+    CHECK(buffer_array.buffer_index == 1);
+    CHECK(buffer_array.buffers[1].size == 0x100);
+}
+
+TEST_CASE("Buffer_Array adaptive buffer size") {
+    Buffer_Array buffer_array;
+    buffer_array.init(0x100, 0x400);
+    CZ_DEFER(buffer_array.drop());
+
+    for (int i = 0; i < 20; ++i) {
+        CHECK(buffer_array.allocator().alloc({0x100, 1}));
+    }
+
+    CHECK(buffer_array.buffers[0].size == 0x100);
+    CHECK(buffer_array.buffers[1].size == 0x100);
+    CHECK(buffer_array.buffers[2].size == 0x200);
+    CHECK(buffer_array.buffers[3].size == 0x400);
+    CHECK(buffer_array.buffers[4].size == 0x400);
+}
+
+TEST_CASE("Buffer_Array restore reuses buffers") {
+    Buffer_Array buffer_array;
+    buffer_array.init(0x100);
+    CZ_DEFER(buffer_array.drop());
+
+    Buffer_Array::Save_Point save = buffer_array.save();
+
+    void* ptrs[10];
+    for (int i = 0; i < 10; ++i) {
+        ptrs[i] = buffer_array.allocator().alloc({0x100, 1});
+        REQUIRE(ptrs[i]);
+    }
+
+    buffer_array.restore(save);
+
+    for (int i = 0; i < 10; ++i) {
+        CHECK(buffer_array.allocator().alloc({0x100, 1}) == ptrs[i]);
+    }
+}
+
+TEST_CASE("Buffer_Array large allocation gets its own buffer") {
+    Buffer_Array buffer_array;
+    buffer_array.init(0x100);
+    CZ_DEFER(buffer_array.drop());
+
+    CHECK(buffer_array.allocator().alloc({0x10, 1}));
+    char* large = (char*)buffer_array.allocator().alloc({0x1000, 1});
+    REQUIRE(large);
+    CHECK(buffer_array.buffers[1].size == 0x1000);
+
+    // Reallocating the large allocation shrinks in place.
+    CHECK(buffer_array.allocator().realloc({large, 0x1000}, {0x800, 1}) == large);
+    CHECK(buffer_array.allocator().alloc({0x800, 1}) == large + 0x800);
+
+    buffer_array.allocator().dealloc({large + 0x800, 0x800});
+    buffer_array.allocator().dealloc({large, 0x800});
+    CHECK(buffer_array.allocator().alloc({0x10, 1}) == large);
+}
@@ -0,0 +1,116 @@
+#include <czt/test_base.hpp>
+
+#include <string.h>
+#include <cz/chained_arena.hpp>
+#include <cz/defer.hpp>
+#include <cz/vector.hpp>
+
+using namespace cz;
+
+TEST_CASE("Chained_Arena allocates new blocks when exhausted") {
+    Chained_Arena arena;
+    arena.init(heap_allocator(), 64);
+    CZ_DEFER(arena.drop());
+
+    char* ptrs[100];
+    for (size_t i = 0; i < 100; ++i) {
+        ptrs[i] = arena.allocator().alloc<char>(16);
+        REQUIRE(ptrs[i]);
+        memset(ptrs[i], (char)i, 16);
+    }
+    for (size_t i = 0; i < 100; ++i) {
+        for (size_t j = 0; j < 16; ++j) {
+            CHECK(ptrs[i][j] == (char)i);
+        }
+    }
+
+    // Blocks grow geometrically.
+    size_t blocks = 0;
+    for (Chained_Arena_Block* block = arena.first; block; block = block->next) {
+        ++blocks;
+        if (block->next) {
+            CHECK(block->next->size >= 2 * block->size);
+        }
+    }
+    CHECK(blocks < 10);
+}
+
+TEST_CASE("Chained_Arena allocation larger than a block") {
+    Chained_Arena arena;
+    arena.init(heap_allocator(), 64);
+    CZ_DEFER(arena.drop());
+
+    void* mem = arena.allocator().alloc({1000, 64});
+    REQUIRE(mem);
+    CHECK((size_t)mem % 64 == 0);
+}
+
+TEST_CASE("Chained_Arena realloc preserves contents across blocks") {
+    Chained_Arena arena;
+    arena.init(heap_allocator(), 64);
+    CZ_DEFER(arena.drop());
+
+    Vector<int> vector = {};
+    for (int i = 0; i < 1000; ++i) {
+        vector.reserve(arena.allocator(), 1);
+        vector.push(i);
+    }
+    for (int i = 0; i < 1000; ++i) {
+        CHECK(vector[i] == i);
+    }
+}
+
+TEST_CASE("Chained_Arena realloc in place") {
+    Chained_Arena arena;
+    arena.init(heap_allocator(), 256);
+    CZ_DEFER(arena.drop());
+
+    void* mem = arena.allocator().alloc({8, 1});
+    REQUIRE(mem);
+    CHECK(arena.allocator().realloc({mem, 8}, {64, 1}) == mem);
+    arena.allocator().dealloc({mem, 64});
+    CHECK(arena.allocator().alloc({8, 1}) == mem);
+}
+
+TEST_CASE("Chained_Arena save and restore reuses blocks") {
+    Chained_Arena arena;
+    arena.init(heap_allocator(), 64);
+    CZ_DEFER(arena.drop());
+
+    void* first = arena.allocator().alloc({16, 1});
+    Chained_Arena::Save_Point save = arena.save();
+    void* second = arena.allocator().alloc({16, 1});
+
+    for (int i = 0; i < 10; ++i) {
+        REQUIRE(arena.allocator().alloc({100, 1}));
+    }
+    Chained_Arena_Block* last = arena.current;
+
+    arena.restore(save);
+    CHECK(arena.allocator().alloc({16, 1}) == second);
+
+    // Reallocating the same amount reuses all the blocks.
+    for (int i = 0; i < 10; ++i) {
+        REQUIRE(arena.allocator().alloc({100, 1}));
+    }
+    CHECK(arena.current == last);
+
+    arena.clear();
+    CHECK(arena.allocator().alloc({16, 1}) == first);
+}
+
+TEST_CASE("Chained_Arena trim keeps the current block") {
+    Chained_Arena arena;
+    arena.init(heap_allocator(), 64);
+    CZ_DEFER(arena.drop());
+
+    for (int i = 0; i < 10; ++i) {
+        REQUIRE(arena.allocator().alloc({100, 1}));
+    }
+
+    arena.clear();
+    arena.trim();
+    CHECK(arena.first == arena.current);
+    CHECK(arena.first->next == nullptr);
+    CHECK(arena.allocator().alloc({16, 1}));
+}
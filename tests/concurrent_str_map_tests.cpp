@@ -0,0 +1,86 @@
+#include <czt/test_base.hpp>
+
+#include <stdio.h>
+#include <atomic>
+#include <cz/concurrent_str_map.hpp>
+#include <cz/defer.hpp>
+#include <cz/heap.hpp>
+#include <thread>
+
+using namespace cz;
+
+TEST_CASE("Concurrent_Str_Map insert and get") {
+    Concurrent_Str_Map<int> map;
+    map.init(heap_allocator(), 4);
+    CZ_DEFER(map.drop(heap_allocator()));
+
+    int value = 0;
+    CHECK_FALSE(map.get_hash("abc", &value));
+
+    map.insert_hash(heap_allocator(), "abc", 1);
+    map.insert_hash(heap_allocator(), "def", 2);
+    REQUIRE(map.get_hash("abc", &value));
+    CHECK(value == 1);
+    REQUIRE(map.get_hash("def", &value));
+    CHECK(value == 2);
+
+    // Inserting an existing key overwrites it.
+    map.insert_hash(heap_allocator(), "abc", 3);
+    REQUIRE(map.get_hash("abc", &value));
+    CHECK(value == 3);
+    CHECK_FALSE(map.get_hash("ghi", &value));
+}
+
+TEST_CASE("Concurrent_Str_Map concurrent readers and writers") {
+    const size_t num_writers = 4;
+    const size_t per_writer = 2000;
+    const size_t total = num_writers * per_writer;
+
+    static char buffer[total * 8];
+    static Str keys[total];
+    for (size_t i = 0; i < total; ++i) {
+        int len = snprintf(buffer + i * 8, 8, "%zu", i);
+        keys[i] = {buffer + i * 8, (size_t)len};
+    }
+
+    Concurrent_Str_Map<size_t> map;
+    map.init(heap_allocator(), 8);
+    CZ_DEFER(map.drop(heap_allocator()));
+
+    // Catch isn't thread safe so record failures and check them on the main thread.
+    std::atomic<bool> ok(true);
+    std::atomic<size_t> writers_done(0);
+
+    std::thread threads[num_writers * 2];
+    for (size_t t = 0; t < num_writers; ++t) {
+        threads[t] = std::thread([&, t]() {
+            for (size_t i = t; i < total; i += num_writers) {
+                map.insert_hash(heap_allocator(), keys[i], i);
+            }
+            ++writers_done;
+        });
+    }
+    for (size_t t = 0; t < num_writers; ++t) {
+        threads[num_writers + t] = std::thread([&, t]() {
+            // A key that is found must always have the right value.
+            while (writers_done.load() < num_writers) {
+                for (size_t i = t; i < total; i += 7) {
+                    size_t value;
+                    if (map.get_hash(keys[i], &value) && value != i) {
+                        ok = false;
+                    }
+                }
+            }
+        });
+    }
+    for (size_t t = 0; t < num_writers * 2; ++t) {
+        threads[t].join();
+    }
+    CHECK(ok.load());
+
+    for (size_t i = 0; i < total; ++i) {
+        size_t value;
+        REQUIRE(map.get_hash(keys[i], &value));
+        CHECK(value == i);
+    }
+}
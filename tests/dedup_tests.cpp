@@ -0,0 +1,71 @@
+#include <czt/test_base.hpp>
+
+#include <stdint.h>
+#include <algorithm>
+#include <cz/dedup.hpp>
+#include <cz/defer.hpp>
+#include <cz/heap.hpp>
+#include <random>
+
+using namespace cz;
+
+TEST_CASE("dedup removes successive duplicates") {
+    int data[] = {1, 1, 2, 3, 3, 3, 1, 4};
+    cz::Slice<int> slice = dedup(cz::slice(data));
+    REQUIRE(slice.len == 5);
+    CHECK(slice[0] == 1);
+    CHECK(slice[1] == 2);
+    CHECK(slice[2] == 3);
+    CHECK(slice[3] == 1);
+    CHECK(slice[4] == 4);
+}
+
+TEST_CASE("dedup vector") {
+    cz::Vector<int> vector = {};
+    CZ_DEFER(vector.drop(heap_allocator()));
+    vector.reserve(heap_allocator(), 4);
+    vector.push(1);
+    vector.push(1);
+    vector.push(2);
+    vector.push(2);
+    dedup(&vector);
+    REQUIRE(vector.len == 2);
+    CHECK(vector[0] == 1);
+    CHECK(vector[1] == 2);
+}
+
+template <class T>
+static void test_dedup_integers(std::mt19937_64& rand) {
+    const size_t lengths[] = {0, 1, 2, 3, 4, 5, 8, 9, 16, 17, 100, 1000};
+    const uint64_t ranges[] = {1, 2, 10, 1000, UINT64_MAX};
+    for (size_t length : lengths) {
+        for (uint64_t range : ranges) {
+            T* data = (T*)malloc(sizeof(T) * (length + 1));
+            CZ_DEFER(free(data));
+            T* expected = (T*)malloc(sizeof(T) * (length + 1));
+            CZ_DEFER(free(expected));
+
+            // Runs of random lengths so there are blocks with and without duplicates.
+            T value = 0;
+            for (size_t i = 0; i < length; ++i) {
+                if (rand() % 4 == 0) {
+                    value = (T)(rand() % range);
+                }
+                data[i] = value;
+            }
+            memcpy(expected, data, sizeof(T) * length);
+            size_t expected_len = std::unique(expected, expected + length) - expected;
+
+            cz::Slice<T> result = dedup(cz::Slice<T>{data, length});
+            INFO("length: " << length << ", range: " << range);
+            REQUIRE(result.len == expected_len);
+            CHECK(memcmp(result.elems, expected, sizeof(T) * expected_len) == 0);
+        }
+    }
+}
+
+TEST_CASE("dedup integers") {
+    std::mt19937_64 rand(1234);
+    test_dedup_integers<uint32_t>(rand);
+    test_dedup_integers<uint64_t>(rand);
+}
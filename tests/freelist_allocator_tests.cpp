@@ -1,6 +1,8 @@
 #include <czt/test_base.hpp>
 
 #include <cz/freelist_allocator.hpp>
+#include <cz/vector.hpp>
+#include <thread>
 
 TEST_CASE("freelist_heap 1") {
     cz::Freelist_Heap freelist = {};
@@ -17,3 +19,149 @@ TEST_CASE("freelist_heap 1") {
 
     CHECK(i1 == i2);
 }
+
+TEST_CASE("Freelist_Buckets reuses allocations of different sizes") {
+    cz::Freelist_Buckets freelist;
+    freelist.init();
+    CZ_DEFER(freelist.drop());
+    cz::Allocator allocator = freelist.allocator();
+
+    void* small = allocator.alloc({10, 1});
+    void* large = allocator.alloc({1000, 1});
+    REQUIRE(small);
+    REQUIRE(large);
+    allocator.dealloc({small, 10});
+    allocator.dealloc({large, 1000});
+
+    // Any size in the same class gets the same memory back.
+    CHECK(allocator.alloc({16, 1}) == small);
+    CHECK(allocator.alloc({600, 1}) == large);
+    allocator.dealloc({small, 16});
+    allocator.dealloc({large, 600});
+}
+
+TEST_CASE("Freelist_Buckets realloc moves between classes") {
+    cz::Freelist_Buckets freelist;
+    freelist.init(cz::heap_allocator(), 0x1000);
+    CZ_DEFER(freelist.drop());
+    cz::Allocator allocator = freelist.allocator();
+
+    cz::Vector<int> vector = {};
+    CZ_DEFER(vector.drop(allocator));
+    for (int i = 0; i < 10000; ++i) {
+        vector.reserve(allocator, 1);
+        vector.push(i);
+    }
+    for (int i = 0; i < 10000; ++i) {
+        CHECK(vector[i] == i);
+    }
+
+    // Realloc within a class is in place.
+    void* mem = allocator.alloc({40, 1});
+    CHECK(allocator.realloc({mem, 40}, {64, 1}) == mem);
+    allocator.dealloc({mem, 64});
+}
+
+TEST_CASE("Freelist_Buckets caps cached bytes") {
+    cz::Freelist_Buckets freelist;
+    freelist.init(cz::heap_allocator(), 0x1000, /*max_cached_bytes=*/64);
+    CZ_DEFER(freelist.drop());
+    cz::Allocator allocator = freelist.allocator();
+
+    void* ptrs[10];
+    for (size_t i = 0; i < 10; ++i) {
+        ptrs[i] = allocator.alloc({16, 1});
+    }
+    for (size_t i = 0; i < 10; ++i) {
+        allocator.dealloc({ptrs[i], 16});
+    }
+
+    size_t size_class = cz::Freelist_Buckets::size_class(16);
+    CHECK(freelist.cached_bytes[size_class] == 64);
+
+    freelist.trim();
+    CHECK(freelist.cached_bytes[size_class] == 0);
+    CHECK(freelist.heads[size_class] == nullptr);
+}
+
+TEST_CASE("Concurrent_Freelist reuses elements") {
+    cz::Concurrent_Freelist freelist;
+    freelist.init(cz::heap_allocator(), sizeof(int));
+    CZ_DEFER(freelist.drop());
+    cz::Allocator allocator = freelist.allocator();
+
+    int* i1 = allocator.alloc<int>();
+    REQUIRE(i1);
+    allocator.dealloc(i1);
+
+    int* i2 = allocator.alloc<int>();
+    REQUIRE(i2);
+    allocator.dealloc(i2);
+
+    CHECK(i1 == i2);
+}
+
+TEST_CASE("Concurrent_Freelist stress test") {
+    cz::Concurrent_Freelist freelist;
+    freelist.init(cz::heap_allocator(), sizeof(uint64_t) * 2);
+    CZ_DEFER(freelist.drop());
+
+    // Each thread allocates elements, writes its id into them, hands half of them
+    // to the next thread, and frees the elements it received from the previous thread.
+    // Catch isn't thread safe so record failures and check them on the main thread.
+    const size_t num_threads = 4;
+    const size_t count = 1000;
+    std::atomic<uint64_t*> mailboxes[num_threads][count];
+    for (size_t t = 0; t < num_threads; ++t) {
+        for (size_t i = 0; i < count; ++i) {
+            mailboxes[t][i].store(nullptr);
+        }
+    }
+
+    std::atomic<bool> ok(true);
+    std::thread threads[num_threads];
+    for (size_t t = 0; t < num_threads; ++t) {
+        threads[t] = std::thread([&, t]() {
+            cz::Allocator allocator = freelist.allocator();
+            size_t next = (t + 1) % num_threads;
+            for (size_t round = 0; round < 20; ++round) {
+                for (size_t i = 0; i < count; ++i) {
+                    uint64_t* elem = allocator.alloc<uint64_t>(2);
+                    elem[0] = t;
+                    elem[1] = i;
+
+                    if (i % 2 == 0) {
+                        // Hand off to the next thread.
+                        uint64_t* old = mailboxes[next][i].exchange(elem);
+                        if (old) {
+                            allocator.dealloc(old, 2);
+                        }
+                    } else {
+                        if (elem[0] != t || elem[1] != i) {
+                            ok = false;
+                        }
+                        allocator.dealloc(elem, 2);
+                    }
+
+                    uint64_t* received = mailboxes[t][i].exchange(nullptr);
+                    if (received) {
+                        if (received[1] != i) {
+                            ok = false;
+                        }
+                        allocator.dealloc(received, 2);
+                    }
+                }
+            }
+        });
+    }
+    for (size_t t = 0; t < num_threads; ++t) {
+        threads[t].join();
+    }
+    CHECK(ok.load());
+
+    for (size_t t = 0; t < num_threads; ++t) {
+        for (size_t i = 0; i < count; ++i) {
+            freelist.allocator().dealloc(mailboxes[t][i].load(), 2);
+        }
+    }
+}
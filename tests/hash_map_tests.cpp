@@ -0,0 +1,118 @@
+#include <czt/test_base.hpp>
+
+#include <cz/defer.hpp>
+#include <cz/hash_map.hpp>
+#include <cz/heap.hpp>
+#include <random>
+
+using namespace cz;
+
+TEST_CASE("Hash_Map insert and get") {
+    Hash_Map<uint64_t, int> map = {};
+    CZ_DEFER(map.drop(heap_allocator()));
+
+    CHECK(map.get(3) == nullptr);
+
+    for (int i = 0; i < 1000; ++i) {
+        map.reserve(heap_allocator(), 1);
+        map.insert(i * 3, i);
+    }
+    CHECK(map.count == 1000);
+
+    for (int i = 0; i < 1000; ++i) {
+        int* value = map.get(i * 3);
+        REQUIRE(value);
+        CHECK(*value == i);
+        CHECK(map.get(i * 3 + 1) == nullptr);
+    }
+}
+
+TEST_CASE("Hash_Map remove") {
+    Hash_Map<uint32_t, uint32_t> map = {};
+    CZ_DEFER(map.drop(heap_allocator()));
+
+    map.reserve(heap_allocator(), 100);
+    for (uint32_t i = 0; i < 100; ++i) {
+        map.insert(i, i + 1);
+    }
+
+    for (uint32_t i = 0; i < 100; i += 2) {
+        CHECK(map.remove(i));
+    }
+    CHECK_FALSE(map.remove(0));
+    CHECK(map.count == 50);
+
+    for (uint32_t i = 0; i < 100; ++i) {
+        uint32_t* value = map.get(i);
+        if (i % 2 == 0) {
+            CHECK(value == nullptr);
+        } else {
+            REQUIRE(value);
+            CHECK(*value == i + 1);
+        }
+    }
+}
+
+TEST_CASE("Hash_Map sparse removal doesn't leave tombstones") {
+    Hash_Map<uint64_t, int> map = {};
+    CZ_DEFER(map.drop(heap_allocator()));
+
+    map.reserve(heap_allocator(), 3);
+    map.insert(1, 1);
+    map.insert(2, 2);
+    map.insert(3, 3);
+    map.remove(2);
+    CHECK(map.tombstones == 0);
+    CHECK(map.get(1));
+    CHECK(map.get(3));
+}
+
+TEST_CASE("Hash_Map Str keys") {
+    Hash_Map<Str, int> map = {};
+    CZ_DEFER(map.drop(heap_allocator()));
+
+    map.reserve(heap_allocator(), 2);
+    map.insert("abc", 1);
+    map.insert("def", 2);
+    REQUIRE(map.get("abc"));
+    CHECK(*map.get("abc") == 1);
+    REQUIRE(map.get("def"));
+    CHECK(*map.get("def") == 2);
+    CHECK(map.get("ghi") == nullptr);
+}
+
+TEST_CASE("Hash_Map random operations match a reference") {
+    Hash_Map<uint64_t, uint64_t> map = {};
+    CZ_DEFER(map.drop(heap_allocator()));
+
+    // Small key space so there are many collisions, removals, and reinsertions.
+    const size_t key_space = 512;
+    bool present[key_space] = {};
+    uint64_t values[key_space] = {};
+
+    std::mt19937 rand(1234);
+    for (size_t iteration = 0; iteration < 20000; ++iteration) {
+        uint64_t key = rand() % key_space;
+        if (rand() % 3 == 0) {
+            CHECK(map.remove(key) == present[key]);
+            present[key] = false;
+        } else if (present[key]) {
+            uint64_t* value = map.get(key);
+            REQUIRE(value);
+            CHECK(*value == values[key]);
+        } else {
+            values[key] = rand();
+            map.reserve(heap_allocator(), 1);
+            map.insert(key, values[key]);
+            present[key] = true;
+        }
+    }
+
+    size_t count = 0;
+    for (size_t key = 0; key < key_space; ++key) {
+        count += present[key];
+        CHECK((map.get(key) != nullptr) == present[key]);
+    }
+    CHECK(map.count == count);
+    CHECK(map.count + map.tombstones <= Hash_Map<uint64_t, uint64_t>::max_load(map.cap));
+}
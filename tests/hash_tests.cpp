@@ -0,0 +1,72 @@
+#include <czt/test_base.hpp>
+
+#include <cz/defer.hpp>
+#include <cz/hash.hpp>
+#include <cz/heap.hpp>
+#include <cz/str_map.hpp>
+#include <cz/str_set.hpp>
+
+using namespace cz;
+
+TEST_CASE("hash matches XXH64") {
+    CHECK(hash("", 0) == 0xEF46DB3751D8E999ull);
+    CHECK(hash("a", 0) == 0xD24EC4F1A98C6E5Bull);
+    CHECK(hash("abc", 0) == 0x44BC2CF5AD770999ull);
+    CHECK(hash("Nobody inspects the spammish repetition", 0) == 0xFBCEA83C8A378BF1ull);
+}
+
+TEST_CASE("hash depends on the seed") {
+    CHECK(hash("abc", 0) != hash("abc", 1));
+}
+
+TEST_CASE("Hash_Stream matches hash") {
+    char buffer[200];
+    for (size_t i = 0; i < sizeof(buffer); ++i) {
+        buffer[i] = (char)(i * 7 + 3);
+    }
+
+    for (size_t len = 0; len <= sizeof(buffer); len += 13) {
+        Str str = {buffer, len};
+        for (size_t piece = 1; piece < 40; piece += 6) {
+            Hash_Stream stream;
+            stream.init(1234);
+            for (size_t start = 0; start < len; start += piece) {
+                stream.update(str.slice(start, cz::min(start + piece, len)));
+            }
+            CHECK(stream.finish() == hash(str, 1234));
+        }
+    }
+}
+
+namespace {
+/// Put every key in the same bucket to check collisions are handled.
+struct Constant_Hasher {
+    Hash operator()(Str) const { return 3; }
+};
+}
+
+TEST_CASE("Str_Map custom hasher") {
+    Str_Map<int, Constant_Hasher> map = {};
+    CZ_DEFER(map.drop(heap_allocator()));
+
+    map.reserve(heap_allocator(), 3);
+    map.insert_hash("a", 1);
+    map.insert_hash("b", 2);
+    map.insert_hash("c", 3);
+    REQUIRE(map.get_hash("b"));
+    CHECK(*map.get_hash("b") == 2);
+    CHECK(map.get_hash("d") == nullptr);
+}
+
+TEST_CASE("Basic_Str_Set custom hasher") {
+    Basic_Str_Set<Str_Hasher_Multiply_31> set = {};
+    CZ_DEFER(set.drop(heap_allocator()));
+
+    set.reserve(heap_allocator(), 2);
+    set.insert_hash("abc");
+    set.insert_hash("def");
+    CHECK(set.get_hash("abc"));
+    CHECK(set.get_hash("xyz") == nullptr);
+    CHECK(set.remove_hash("abc"));
+    CHECK(set.get_hash("abc") == nullptr);
+}
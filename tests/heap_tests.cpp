@@ -0,0 +1,61 @@
+#include <czt/test_base.hpp>
+
+#include <stdint.h>
+#include <string.h>
+#include <cz/heap.hpp>
+
+using namespace cz;
+
+static bool is_aligned(void* ptr, size_t alignment) {
+    return (uintptr_t)ptr % alignment == 0;
+}
+
+TEST_CASE("heap_allocator over-aligned allocations are aligned") {
+    size_t alignments[] = {alignof(max_align_t), 64, 0x1000, 0x200000};
+    for (size_t i = 0; i < len(alignments); ++i) {
+        size_t alignment = alignments[i];
+        INFO("alignment: " << alignment);
+
+        void* small = heap_allocator().alloc({1, alignment});
+        REQUIRE(small);
+        CHECK(is_aligned(small, alignment));
+
+        void* large = heap_allocator().alloc({3 * alignment, alignment});
+        REQUIRE(large);
+        CHECK(is_aligned(large, alignment));
+
+        heap_allocator().dealloc({small, 1});
+        heap_allocator().dealloc({large, 3 * alignment});
+    }
+}
+
+TEST_CASE("heap_allocator over-aligned realloc preserves contents") {
+    char* mem = (char*)heap_allocator().alloc({100, 64});
+    REQUIRE(mem);
+    for (size_t i = 0; i < 100; ++i) {
+        mem[i] = (char)i;
+    }
+
+    mem = (char*)heap_allocator().realloc({mem, 100}, {0x3000, 0x1000});
+    REQUIRE(mem);
+    CHECK(is_aligned(mem, 0x1000));
+    for (size_t i = 0; i < 100; ++i) {
+        CHECK(mem[i] == (char)i);
+    }
+
+    mem = (char*)heap_allocator().realloc({mem, 0x3000}, {50, 0x1000});
+    REQUIRE(mem);
+    CHECK(is_aligned(mem, 0x1000));
+    for (size_t i = 0; i < 50; ++i) {
+        CHECK(mem[i] == (char)i);
+    }
+
+    heap_allocator().dealloc({mem, 50});
+}
+
+TEST_CASE("heap_allocator zero sized over-aligned allocation") {
+    void* mem = heap_allocator().alloc({0, 64});
+    REQUIRE(mem);
+    CHECK(is_aligned(mem, 64));
+    heap_allocator().dealloc({mem, 0});
+}
@@ -0,0 +1,96 @@
+#include <czt/test_base.hpp>
+
+#include <stdio.h>
+#include <atomic>
+#include <cz/defer.hpp>
+#include <cz/intern_table.hpp>
+#include <thread>
+
+using namespace cz;
+
+TEST_CASE("Intern_Table deduplicates strings") {
+    Intern_Table table;
+    table.init();
+    CZ_DEFER(table.drop());
+
+    char buffer[] = "hello";
+    uint32_t a = table.intern("hello");
+    uint32_t b = table.intern("world");
+    uint32_t c = table.intern(buffer);
+    CHECK(a == 0);
+    CHECK(b == 1);
+    CHECK(c == a);
+    CHECK(table.count() == 2);
+
+    // The table owns a copy of the string.
+    buffer[0] = 'j';
+    CHECK(table.get(a) == "hello");
+    CHECK(table.get(b) == "world");
+
+    uint32_t id;
+    CHECK(table.find("world", &id));
+    CHECK(id == b);
+    CHECK_FALSE(table.find("jello", &id));
+}
+
+TEST_CASE("Concurrent_Intern_Table::chunk_of") {
+    size_t offset;
+    CHECK(Concurrent_Intern_Table::chunk_of(0, &offset) == 0);
+    CHECK(offset == 0);
+    CHECK(Concurrent_Intern_Table::chunk_of(1023, &offset) == 0);
+    CHECK(offset == 1023);
+    CHECK(Concurrent_Intern_Table::chunk_of(1024, &offset) == 1);
+    CHECK(offset == 0);
+    CHECK(Concurrent_Intern_Table::chunk_of(3071, &offset) == 1);
+    CHECK(offset == 2047);
+    CHECK(Concurrent_Intern_Table::chunk_of(3072, &offset) == 2);
+    CHECK(offset == 0);
+    CHECK(Concurrent_Intern_Table::chunk_of(UINT32_MAX - 1, &offset) <
+          Concurrent_Intern_Table::max_chunks);
+}
+
+TEST_CASE("Concurrent_Intern_Table threads agree on ids") {
+    const size_t num_threads = 4;
+    const size_t num_strings = 5000;
+
+    static char buffer[num_strings * 8];
+    static Str strs[num_strings];
+    for (size_t i = 0; i < num_strings; ++i) {
+        int len = snprintf(buffer + i * 8, 8, "%zu", i);
+        strs[i] = {buffer + i * 8, (size_t)len};
+    }
+
+    Concurrent_Intern_Table table;
+    table.init();
+    CZ_DEFER(table.drop());
+
+    // Every thread interns every string in a different order.
+    // The strides are coprime with `num_strings` so every string is visited.
+    static const size_t strides[num_threads] = {1, 3, 7, 9};
+    static uint32_t ids[num_threads][num_strings];
+    std::atomic<bool> ok(true);
+    std::thread threads[num_threads];
+    for (size_t t = 0; t < num_threads; ++t) {
+        threads[t] = std::thread([&, t]() {
+            for (size_t j = 0; j < num_strings; ++j) {
+                size_t i = (j * strides[t]) % num_strings;
+                ids[t][i] = table.intern(strs[i]);
+                if (table.get(ids[t][i]) != strs[i]) {
+                    ok = false;
+                }
+            }
+        });
+    }
+    for (size_t t = 0; t < num_threads; ++t) {
+        threads[t].join();
+    }
+    CHECK(ok.load());
+
+    CHECK(table.count() == num_strings);
+    for (size_t i = 0; i < num_strings; ++i) {
+        for (size_t t = 1; t < num_threads; ++t) {
+            CHECK(ids[t][i] == ids[0][i]);
+        }
+        CHECK(table.get(ids[0][i]) == strs[i]);
+    }
+}
@@ -0,0 +1,189 @@
+#include <czt/test_base.hpp>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <algorithm>
+#include <cmath>
+#include <cz/heap.hpp>
+#include <cz/radix_sort.hpp>
+#include <cz/vector.hpp>
+#include <limits>
+#include <random>
+
+using namespace cz;
+
+template <class T, class Make>
+static void check_matches_std_sort(size_t length, Make&& make) {
+    Vector<T> data = {};
+    CZ_DEFER(data.drop(heap_allocator()));
+    data.reserve_exact(heap_allocator(), length);
+    for (size_t i = 0; i < length; ++i) {
+        data.push(make(i));
+    }
+
+    Vector<T> expected = data.clone(heap_allocator());
+    CZ_DEFER(expected.drop(heap_allocator()));
+    std::sort(expected.elems, expected.elems + expected.len);
+
+    radix_sort(heap_allocator(), data.as_slice());
+    INFO("length: " << length);
+    // Compare bits so NaNs and negative zeros are checked too.  Both
+    // are null when empty which can't be passed to `memcmp`.
+    if (length > 0) {
+        CHECK(memcmp(data.elems, expected.elems, sizeof(T) * length) == 0);
+    }
+}
+
+TEST_CASE("radix_sort unsigned integers") {
+    std::mt19937_64 rand(1234);
+    const size_t lengths[] = {0, 1, 2, 63, 64, 65, 1000, 100000};
+    for (size_t length : lengths) {
+        check_matches_std_sort<uint64_t>(length, [&](size_t) { return rand(); });
+        check_matches_std_sort<uint32_t>(length, [&](size_t) { return (uint32_t)rand(); });
+        check_matches_std_sort<uint16_t>(length, [&](size_t) { return (uint16_t)rand(); });
+        check_matches_std_sort<uint8_t>(length, [&](size_t) { return (uint8_t)rand(); });
+        // Only the bottom byte varies so the other passes are skipped.
+        check_matches_std_sort<uint64_t>(length, [&](size_t) {
+            return 0x1234000000000000 | (rand() & 0xFF);
+        });
+    }
+}
+
+TEST_CASE("radix_sort signed integers") {
+    std::mt19937_64 rand(1234);
+    const size_t lengths[] = {0, 1, 63, 64, 1000, 100000};
+    for (size_t length : lengths) {
+        check_matches_std_sort<int64_t>(length, [&](size_t) { return (int64_t)rand(); });
+        check_matches_std_sort<int32_t>(length, [&](size_t) { return (int32_t)rand(); });
+        check_matches_std_sort<int32_t>(length, [&](size_t) {
+            return (int32_t)(rand() % 21) - 10;
+        });
+    }
+
+    int32_t data[] = {5, INT32_MIN, -1, 0, INT32_MAX, -5, 1};
+    radix_sort(heap_allocator(), cz::Slice<int32_t>{data, 7});
+    int32_t expected[] = {INT32_MIN, -5, -1, 0, 1, 5, INT32_MAX};
+    CHECK(memcmp(data, expected, sizeof(data)) == 0);
+}
+
+TEST_CASE("radix_sort floating point") {
+    std::mt19937 rand(1234);
+    std::uniform_real_distribution<double> distribution(-1e6, 1e6);
+    const size_t lengths[] = {0, 1, 63, 64, 1000, 100000};
+    for (size_t length : lengths) {
+        check_matches_std_sort<double>(length, [&](size_t) { return distribution(rand); });
+        check_matches_std_sort<float>(length, [&](size_t) { return (float)distribution(rand); });
+    }
+
+    const float inf = std::numeric_limits<float>::infinity();
+    Vector<float> data = {};
+    CZ_DEFER(data.drop(heap_allocator()));
+    data.reserve_exact(heap_allocator(), 1000);
+    for (size_t i = 0; i < 1000; ++i) {
+        const float values[] = {inf, -inf, 0.0f, -0.0f, 1.5f, -1.5f, 1e-40f, -1e-40f};
+        data.push(values[i % 8]);
+    }
+    radix_sort(heap_allocator(), data.as_slice());
+    CHECK(data[0] == -inf);
+    CHECK(data.last() == inf);
+    for (size_t i = 1; i < data.len; ++i) {
+        CHECK(data[i - 1] <= data[i]);
+    }
+    // Negative zero comes before zero.
+    for (size_t i = 1; i < data.len; ++i) {
+        if (data[i - 1] == 0 && data[i] == 0) {
+            CHECK(!(std::signbit(data[i - 1]) < std::signbit(data[i])));
+        }
+    }
+}
+
+TEST_CASE("radix_sort with a key is stable") {
+    struct Elem {
+        int32_t key;
+        uint32_t index;
+    };
+
+    std::mt19937 rand(1234);
+    const size_t lengths[] = {10, 63, 64, 10000};
+    for (size_t length : lengths) {
+        Vector<Elem> data = {};
+        CZ_DEFER(data.drop(heap_allocator()));
+        data.reserve_exact(heap_allocator(), length);
+        for (size_t i = 0; i < length; ++i) {
+            data.push({(int32_t)(rand() % 100) - 50, (uint32_t)i});
+        }
+
+        radix_sort(heap_allocator(), data.as_slice(), [](const Elem& elem) { return elem.key; });
+
+        INFO("length: " << length);
+        for (size_t i = 1; i < data.len; ++i) {
+            REQUIRE(data[i - 1].key <= data[i].key);
+            if (data[i - 1].key == data[i].key) {
+                REQUIRE(data[i - 1].index < data[i].index);
+            }
+        }
+    }
+}
+
+TEST_CASE("radix_sort strings") {
+    std::mt19937 rand(1234);
+
+    // Strings with lots of shared prefixes, empty strings, and high bytes.
+    const size_t max_len = 40;
+    const size_t count = 20000;
+    Vector<char> buffer = {};
+    CZ_DEFER(buffer.drop(heap_allocator()));
+    buffer.reserve_exact(heap_allocator(), count * max_len);
+    Vector<Str> strings = {};
+    CZ_DEFER(strings.drop(heap_allocator()));
+    strings.reserve_exact(heap_allocator(), count);
+    for (size_t i = 0; i < count; ++i) {
+        char* start = buffer.elems + buffer.len;
+        size_t len = rand() % max_len;
+        for (size_t j = 0; j < len; ++j) {
+            const char alphabet[] = {'a', 'b', 'c', (char)0xE9, 0};
+            start[j] = j < len / 2 ? 'x' : alphabet[rand() % 5];
+        }
+        buffer.len += len;
+        strings.push({start, len});
+    }
+
+    const size_t lengths[] = {0, 1, 2, 63, 64, 65, 1000, count};
+    for (size_t length : lengths) {
+        Vector<Str> data = strings.slice_end(length).clone(heap_allocator());
+        CZ_DEFER(data.drop(heap_allocator()));
+        Vector<Str> expected = data.clone(heap_allocator());
+        CZ_DEFER(expected.drop(heap_allocator()));
+        std::stable_sort(expected.elems, expected.elems + expected.len);
+
+        radix_sort(heap_allocator(), data.as_slice());
+
+        INFO("length: " << length);
+        for (size_t i = 0; i < length; ++i) {
+            REQUIRE(data[i] == expected[i]);
+        }
+    }
+}
+
+TEST_CASE("radix_sort strings with a long common prefix") {
+    const size_t count = 1000;
+    const size_t prefix = 5000;
+    Vector<char> buffer = {};
+    CZ_DEFER(buffer.drop(heap_allocator()));
+    buffer.reserve_exact(heap_allocator(), count * (prefix + 8));
+    Vector<Str> strings = {};
+    CZ_DEFER(strings.drop(heap_allocator()));
+    strings.reserve_exact(heap_allocator(), count);
+    for (size_t i = 0; i < count; ++i) {
+        char* start = buffer.elems + buffer.len;
+        memset(start, 'p', prefix);
+        int len = snprintf(start + prefix, 8, "%04zu", (i * 7) % count);
+        buffer.len += prefix + len;
+        strings.push({start, prefix + len});
+    }
+
+    radix_sort(heap_allocator(), strings.as_slice());
+    for (size_t i = 1; i < count; ++i) {
+        REQUIRE(strings[i - 1] < strings[i]);
+    }
+}
@@ -0,0 +1,214 @@
+#include <czt/test_base.hpp>
+
+#include <string.h>
+#include <cz/defer.hpp>
+#include <cz/slab_allocator.hpp>
+#include <cz/str.hpp>
+#include <cz/tracking_allocator.hpp>
+#include <cz/vector.hpp>
+#include <thread>
+
+using namespace cz;
+
+TEST_CASE("Slab_Allocator size classes") {
+    CHECK(Slab_Allocator::size_class(0) == 0);
+    CHECK(Slab_Allocator::size_class(1) == 0);
+    CHECK(Slab_Allocator::size_class(16) == 0);
+    CHECK(Slab_Allocator::size_class(17) == 1);
+    CHECK(Slab_Allocator::size_class(128) == 7);
+    CHECK(Slab_Allocator::size_class(129) == 8);
+    CHECK(Slab_Allocator::size_class(1024) == Slab_Allocator::num_size_classes - 1);
+
+    for (size_t size = 1; size <= Slab_Allocator::max_size; ++size) {
+        size_t size_class = Slab_Allocator::size_class(size);
+        CHECK(Slab_Allocator::class_size(size_class) >= size);
+        if (size_class > 0) {
+            CHECK(Slab_Allocator::class_size(size_class - 1) < size);
+        }
+    }
+}
+
+TEST_CASE("Slab_Allocator reuses freed objects") {
+    Slab_Allocator slab;
+    slab.init();
+    CZ_DEFER(slab.drop());
+    Allocator allocator = slab.allocator();
+
+    int* i1 = allocator.alloc<int>();
+    REQUIRE(i1);
+    allocator.dealloc(i1);
+
+    int* i2 = allocator.alloc<int>();
+    REQUIRE(i2);
+    allocator.dealloc(i2);
+
+    CHECK(i1 == i2);
+}
+
+TEST_CASE("Slab_Allocator realloc preserves contents") {
+    Slab_Allocator slab;
+    slab.init();
+    CZ_DEFER(slab.drop());
+
+    Vector<int> vector = {};
+    CZ_DEFER(vector.drop(slab.allocator()));
+
+    // Grow through every size class and then past `max_size` into the backer.
+    for (int i = 0; i < 1000; ++i) {
+        vector.reserve(slab.allocator(), 1);
+        vector.push(i);
+    }
+
+    for (int i = 0; i < 1000; ++i) {
+        CHECK(vector[i] == i);
+    }
+}
+
+TEST_CASE("Slab_Allocator realloc within a size class stays in place") {
+    Slab_Allocator slab;
+    slab.init();
+    CZ_DEFER(slab.drop());
+    Allocator allocator = slab.allocator();
+
+    void* mem = allocator.alloc({20, 1});
+    REQUIRE(mem);
+    CHECK(allocator.realloc({mem, 20}, {30, 1}) == mem);
+    allocator.dealloc({mem, 30});
+}
+
+TEST_CASE("Slab_Allocator passes over aligned allocations to the backer") {
+    Tracking_Allocator tracker;
+    tracker.init(heap_allocator());
+    CZ_DEFER(tracker.drop());
+
+    Slab_Allocator slab;
+    slab.init(tracker.allocator());
+    CZ_DEFER(slab.drop());
+    Allocator allocator = slab.allocator();
+
+    char* mem = (char*)allocator.alloc({32, 64});
+    REQUIRE(mem);
+    CHECK((uintptr_t)mem % 64 == 0);
+    CHECK(tracker.stats().live_bytes == 32);
+    memcpy(mem, "abcd", 4);
+
+    // Move it into a slab and back out again.
+    mem = (char*)allocator.realloc({mem, 32}, {40, 8});
+    REQUIRE(mem);
+    CHECK(tracker.stats().live_bytes == Slab_Allocator::chunk_size);
+    mem = (char*)allocator.realloc({mem, 40}, {48, 128});
+    REQUIRE(mem);
+    CHECK((uintptr_t)mem % 128 == 0);
+    CHECK(Str{mem, 4} == "abcd");
+    CHECK(tracker.stats().live_bytes == Slab_Allocator::chunk_size + 48);
+
+    allocator.dealloc({mem, 48});
+    CHECK(tracker.stats().live_bytes == Slab_Allocator::chunk_size);
+}
+
+TEST_CASE("Slab_Allocator serves over aligned arrays from slabs") {
+    Tracking_Allocator tracker;
+    tracker.init(heap_allocator());
+    CZ_DEFER(tracker.drop());
+
+    Slab_Allocator slab;
+    slab.init(tracker.allocator());
+    CZ_DEFER(slab.drop());
+    Allocator allocator = slab.allocator();
+
+    AllocInfo infos[] = {{16, 1}, {64, 64}, {16, 1}, {192, 64}, {384, 128}, {1024, 1024}};
+    void* ptrs[sizeof(infos) / sizeof(*infos)];
+    for (size_t i = 0; i < sizeof(infos) / sizeof(*infos); ++i) {
+        ptrs[i] = allocator.alloc(infos[i]);
+        REQUIRE(ptrs[i]);
+        CHECK((uintptr_t)ptrs[i] % infos[i].alignment == 0);
+    }
+    CHECK(tracker.stats().live_bytes == Slab_Allocator::chunk_size);
+
+    for (size_t i = 0; i < sizeof(infos) / sizeof(*infos); ++i) {
+        allocator.dealloc({ptrs[i], infos[i].size});
+    }
+}
+
+TEST_CASE("Slab_Allocator multiple threads with an over aligned allocation live") {
+    Tracking_Allocator tracker;
+    tracker.init(heap_allocator());
+    CZ_DEFER(tracker.drop());
+
+    Slab_Allocator slab;
+    slab.init(tracker.allocator());
+    CZ_DEFER(slab.drop());
+
+    void* over_aligned = slab.allocator().alloc({32, 64});
+    REQUIRE(over_aligned);
+
+    // Catch isn't thread safe so record failures and check them on the main thread.
+    bool ok[4] = {true, true, true, true};
+    std::thread threads[4];
+    for (size_t t = 0; t < 4; ++t) {
+        threads[t] = std::thread([&slab, &ok, t]() {
+            Allocator allocator = slab.allocator();
+            char* ptrs[100];
+            for (int round = 0; round < 10; ++round) {
+                for (size_t i = 0; i < 100; ++i) {
+                    ptrs[i] = allocator.alloc<char>(i + 1);
+                    CZ_ASSERT(ptrs[i]);
+                    memset(ptrs[i], (char)t, i + 1);
+                }
+                for (size_t i = 0; i < 100; ++i) {
+                    for (size_t j = 0; j < i + 1; ++j) {
+                        if (ptrs[i][j] != (char)t) {
+                            ok[t] = false;
+                        }
+                    }
+                    allocator.dealloc(ptrs[i], i + 1);
+                }
+            }
+            slab.flush_thread_cache();
+        });
+    }
+    for (size_t t = 0; t < 4; ++t) {
+        threads[t].join();
+        CHECK(ok[t]);
+    }
+
+    // Only chunks and the over aligned allocation are in the backer.
+    CHECK(tracker.stats().live_bytes % Slab_Allocator::chunk_size == 32);
+    slab.allocator().dealloc({over_aligned, 32});
+    CHECK(tracker.stats().live_bytes % Slab_Allocator::chunk_size == 0);
+}
+
+TEST_CASE("Slab_Allocator multiple threads") {
+    Slab_Allocator slab;
+    slab.init();
+    CZ_DEFER(slab.drop());
+
+    // Catch isn't thread safe so record failures and check them on the main thread.
+    bool ok[4] = {true, true, true, true};
+    std::thread threads[4];
+    for (size_t t = 0; t < 4; ++t) {
+        threads[t] = std::thread([&slab, &ok, t]() {
+            Allocator allocator = slab.allocator();
+            char* ptrs[200];
+            for (int round = 0; round < 10; ++round) {
+                for (size_t i = 0; i < 200; ++i) {
+                    ptrs[i] = allocator.alloc<char>(i + 1);
+                    CZ_ASSERT(ptrs[i]);
+                    memset(ptrs[i], (char)t, i + 1);
+                }
+                for (size_t i = 0; i < 200; ++i) {
+                    for (size_t j = 0; j < i + 1; ++j) {
+                        if (ptrs[i][j] != (char)t) {
+                            ok[t] = false;
+                        }
+                    }
+                    allocator.dealloc(ptrs[i], i + 1);
+                }
+            }
+        });
+    }
+    for (size_t t = 0; t < 4; ++t) {
+        threads[t].join();
+        CHECK(ok[t]);
+    }
+}
@@ -0,0 +1,91 @@
+#include <czt/test_base.hpp>
+
+#include <string.h>
+#include <cz/defer.hpp>
+#include <cz/heap.hpp>
+#include <cz/small_string.hpp>
+#include <cz/tracking_allocator.hpp>
+
+using namespace cz;
+
+TEST_CASE("Small_String constructor makes empty inline string") {
+    Small_String<16> string = {};
+    CHECK(string == "");
+    CHECK(string.is_inline());
+    CHECK(string.capacity() == 16);
+}
+
+TEST_CASE("Small_String doesn't allocate while it fits inline") {
+    Tracking_Allocator tracker;
+    tracker.init(heap_allocator());
+    CZ_DEFER(tracker.drop());
+    Allocator allocator = tracker.allocator();
+
+    Small_String<16> string = {};
+    CZ_DEFER(string.drop(allocator));
+    string.reserve(allocator, 12);
+    string.append("hello");
+    string.push(' ');
+    string.append("world");
+    string.null_terminate();
+
+    CHECK(string.is_inline());
+    CHECK(tracker.stats().total_allocations == 0);
+    CHECK(string == "hello world");
+    CHECK(strcmp(string.buffer(), "hello world") == 0);
+}
+
+TEST_CASE("Small_String spills to the heap once full") {
+    Tracking_Allocator tracker;
+    tracker.init(heap_allocator());
+    CZ_DEFER(tracker.drop());
+    Allocator allocator = tracker.allocator();
+
+    Small_String<8> string = {};
+    string.reserve(allocator, 5);
+    string.append("abcde");
+    CHECK(string.is_inline());
+
+    string.reserve(allocator, 6);
+    string.append("fghijk");
+    CHECK_FALSE(string.is_inline());
+    CHECK(string == "abcdefghijk");
+    CHECK(string.starts_with("abc"));
+    CHECK(string.ends_with("ijk"));
+    CHECK(tracker.stats().total_allocations == 1);
+
+    string.drop(allocator);
+    CHECK(tracker.stats().live_allocations == 0);
+}
+
+TEST_CASE("Small_String realloc moves back inline") {
+    Small_String<8> string = {};
+    CZ_DEFER(string.drop(heap_allocator()));
+    string.reserve(heap_allocator(), 20);
+    string.push_many('x', 20);
+    REQUIRE_FALSE(string.is_inline());
+
+    string.remove_range(2, 18);
+    string.realloc(heap_allocator());
+    CHECK(string.is_inline());
+    CHECK(string == "xxxx");
+}
+
+TEST_CASE("Small_String insert and remove") {
+    Small_String<16> string = {};
+    CZ_DEFER(string.drop(heap_allocator()));
+    string.reserve(heap_allocator(), 10);
+    string.append("acf");
+    string.insert(1, 'b');
+    string.insert(3, "de");
+    CHECK(string == "abcdef");
+
+    string.remove(0);
+    CHECK(string.pop() == 'f');
+    CHECK(string == "bcde");
+    CHECK(string.find_index('d') == 2);
+
+    String clone = string.clone(heap_allocator());
+    CZ_DEFER(clone.drop(heap_allocator()));
+    CHECK(clone == "bcde");
+}
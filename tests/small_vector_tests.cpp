@@ -0,0 +1,99 @@
+#include <czt/test_base.hpp>
+
+#include <cz/defer.hpp>
+#include <cz/heap.hpp>
+#include <cz/small_vector.hpp>
+#include <cz/tracking_allocator.hpp>
+
+using namespace cz;
+
+TEST_CASE("Small_Vector constructor makes empty inline vector") {
+    Small_Vector<int, 4> vector = {};
+    CHECK(vector.len == 0);
+    CHECK(vector.is_inline());
+    CHECK(vector.capacity() == 4);
+}
+
+TEST_CASE("Small_Vector doesn't allocate while it fits inline") {
+    Tracking_Allocator tracker;
+    tracker.init(heap_allocator());
+    CZ_DEFER(tracker.drop());
+    Allocator allocator = tracker.allocator();
+
+    Small_Vector<int, 4> vector = {};
+    CZ_DEFER(vector.drop(allocator));
+    for (int i = 0; i < 4; ++i) {
+        vector.reserve(allocator, 1);
+        vector.push(i);
+    }
+
+    CHECK(vector.is_inline());
+    CHECK(tracker.stats().total_allocations == 0);
+    int expected[] = {0, 1, 2, 3};
+    CHECK(vector == slice(expected));
+}
+
+TEST_CASE("Small_Vector spills to the heap once full") {
+    Tracking_Allocator tracker;
+    tracker.init(heap_allocator());
+    CZ_DEFER(tracker.drop());
+    Allocator allocator = tracker.allocator();
+
+    Small_Vector<int, 4> vector = {};
+    for (int i = 0; i < 10; ++i) {
+        vector.reserve(allocator, 1);
+        vector.push(i);
+    }
+
+    CHECK_FALSE(vector.is_inline());
+    CHECK(vector.capacity() >= 10);
+    CHECK(tracker.stats().total_allocations == 1);
+    for (int i = 0; i < 10; ++i) {
+        CHECK(vector[i] == i);
+    }
+
+    vector.drop(allocator);
+    CHECK(tracker.stats().live_allocations == 0);
+}
+
+TEST_CASE("Small_Vector realloc moves back inline") {
+    Tracking_Allocator tracker;
+    tracker.init(heap_allocator());
+    CZ_DEFER(tracker.drop());
+    Allocator allocator = tracker.allocator();
+
+    Small_Vector<int, 4> vector = {};
+    CZ_DEFER(vector.drop(allocator));
+    vector.reserve(allocator, 8);
+    vector.push_many(7, 8);
+    REQUIRE_FALSE(vector.is_inline());
+
+    vector.remove_range(1, 6);
+    vector.realloc(allocator);
+    CHECK(vector.is_inline());
+    CHECK(vector.len == 3);
+    CHECK(vector.first() == 7);
+    CHECK(vector.last() == 7);
+    CHECK(tracker.stats().live_allocations == 0);
+}
+
+TEST_CASE("Small_Vector insert and remove") {
+    Small_Vector<int, 8> vector = {};
+    CZ_DEFER(vector.drop(heap_allocator()));
+
+    int start[] = {1, 2, 5};
+    vector.reserve(heap_allocator(), 6);
+    vector.append(slice(start));
+    vector.insert(2, 4);
+    int three[] = {3};
+    vector.insert_slice(2, slice(three));
+    int inserted[] = {1, 2, 3, 4, 5};
+    CHECK(vector == slice(inserted));
+
+    vector.remove(0);
+    CHECK(vector.pop() == 5);
+    int removed[] = {2, 3, 4};
+    CHECK(vector == slice(removed));
+    CHECK(vector.contains(3));
+    CHECK(vector.find_index(4) == 2);
+}
@@ -0,0 +1,124 @@
+#include <czt/test_base.hpp>
+
+#include <stdint.h>
+#include <cz/defer.hpp>
+#include <cz/heap.hpp>
+#include <cz/soa_vector.hpp>
+#include <cz/tracking_allocator.hpp>
+
+using namespace cz;
+
+TEST_CASE("Soa_Vector push, get, and column") {
+    Soa_Vector<int, char, double> vector = {};
+    CZ_DEFER(vector.drop(heap_allocator()));
+
+    for (int i = 0; i < 10; ++i) {
+        vector.reserve(heap_allocator(), 1);
+        vector.push(i, (char)('a' + i), i * 0.5);
+    }
+
+    REQUIRE(vector.len == 10);
+    CHECK(vector.get<0>(3) == 3);
+    CHECK(vector.get<1>(3) == 'd');
+    CHECK(vector.get<2>(3) == 1.5);
+
+    Slice<double> halves = vector.column<2>();
+    REQUIRE(halves.len == 10);
+    CHECK((uintptr_t)halves.elems % alignof(double) == 0);
+    for (size_t i = 0; i < halves.len; ++i) {
+        CHECK(halves[i] == i * 0.5);
+    }
+
+    vector.get<1>(0) = 'z';
+    vector.set(1, 100, 'y', 2.0);
+    CHECK(vector.column<1>()[0] == 'z');
+    CHECK(vector.get<0>(1) == 100);
+    CHECK(vector.get<1>(1) == 'y');
+    CHECK(vector.get<2>(1) == 2.0);
+}
+
+TEST_CASE("Soa_Vector grows all columns with one allocation") {
+    Tracking_Allocator tracker;
+    tracker.init(heap_allocator());
+    CZ_DEFER(tracker.drop());
+    Allocator allocator = tracker.allocator();
+
+    Soa_Vector<uint8_t, uint64_t> vector = {};
+    vector.reserve_exact(allocator, 3);
+    CHECK(tracker.stats().total_allocations == 1);
+    for (uint8_t i = 0; i < 3; ++i) {
+        vector.push(i, i * 1000);
+    }
+
+    vector.reserve(allocator, 100);
+    CHECK(tracker.stats().total_allocations == 1);
+    CHECK(tracker.stats().total_reallocations == 1);
+    CHECK(tracker.stats().live_allocations == 1);
+    CHECK(vector.cap >= 103);
+    for (uint8_t i = 3; i < 103; ++i) {
+        vector.push(i, i * 1000);
+    }
+
+    for (uint8_t i = 0; i < 103; ++i) {
+        CHECK(vector.get<0>(i) == i);
+        CHECK(vector.get<1>(i) == i * 1000);
+    }
+
+    vector.drop(allocator);
+    CHECK(tracker.stats().live_allocations == 0);
+}
+
+TEST_CASE("Soa_Vector remove and swap_remove") {
+    Soa_Vector<int, short> vector = {};
+    CZ_DEFER(vector.drop(heap_allocator()));
+
+    vector.reserve(heap_allocator(), 5);
+    for (int i = 0; i < 5; ++i) {
+        vector.push(i, (short)(-i));
+    }
+
+    vector.remove(1);
+    REQUIRE(vector.len == 4);
+    int expected_ints[] = {0, 2, 3, 4};
+    short expected_shorts[] = {0, -2, -3, -4};
+    CHECK(vector.column<0>() == slice(expected_ints));
+    CHECK(vector.column<1>() == slice(expected_shorts));
+
+    vector.swap_remove(0);
+    REQUIRE(vector.len == 3);
+    CHECK(vector.get<0>(0) == 4);
+    CHECK(vector.get<1>(0) == -4);
+    CHECK(vector.get<0>(2) == 3);
+    CHECK(vector.get<1>(2) == -3);
+
+    vector.pop();
+    CHECK(vector.len == 2);
+}
+
+TEST_CASE("Soa_Vector sort_by permutes the other columns") {
+    Soa_Vector<uint32_t, float, char> vector = {};
+    CZ_DEFER(vector.drop(heap_allocator()));
+
+    uint32_t keys[] = {5, 3, 9, 1, 7, 0, 8, 2, 6, 4};
+    vector.reserve(heap_allocator(), 10);
+    for (size_t i = 0; i < 10; ++i) {
+        vector.push(keys[i], keys[i] * 0.25f, (char)('a' + keys[i]));
+    }
+
+    vector.sort_by<0>(heap_allocator());
+    REQUIRE(vector.len == 10);
+    for (uint32_t i = 0; i < 10; ++i) {
+        CHECK(vector.get<0>(i) == i);
+        CHECK(vector.get<1>(i) == i * 0.25f);
+        CHECK(vector.get<2>(i) == (char)('a' + i));
+    }
+
+    // Sort by a different column in descending order.
+    vector.sort_by<2>(heap_allocator(), [](const char* left, const char* right) {
+        return *left > *right;
+    });
+    for (uint32_t i = 0; i < 10; ++i) {
+        CHECK(vector.get<0>(i) == 9 - i);
+        CHECK(vector.get<1>(i) == (9 - i) * 0.25f);
+    }
+}
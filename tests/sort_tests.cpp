@@ -3,11 +3,14 @@
 #include <stdio.h>
 #include <string.h>
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cz/defer.hpp>
 #include <cz/heap.hpp>
+#include <cz/parallel_sort.hpp>
 #include <cz/sort.hpp>
 #include <random>
+#include <thread>
 
 using namespace cz;
 
@@ -73,3 +76,263 @@ TEST_CASE("Sort benchmark") {
         }
     }
 }
+
+/// Fill `data` with `length` elements in the given pattern.
+static void fill_pattern(uint64_t* data, size_t length, int pattern, std::mt19937& rand) {
+    for (size_t i = 0; i < length; ++i) {
+        switch (pattern) {
+            case 0:  // Random.
+                data[i] = rand();
+                break;
+            case 1:  // Sorted.
+                data[i] = i;
+                break;
+            case 2:  // Reverse sorted.
+                data[i] = length - i;
+                break;
+            case 3:  // Organ pipe.
+                data[i] = i < length / 2 ? i : length - i;
+                break;
+            case 4:  // Few unique.
+                data[i] = rand() % 4;
+                break;
+            case 5:  // All equal.
+                data[i] = 7;
+                break;
+            case 6:  // Sorted with a few random swaps.
+                data[i] = i;
+                if (i > 0 && rand() % 64 == 0) {
+                    std::swap(data[i], data[rand() % i]);
+                }
+                break;
+        }
+    }
+}
+
+TEST_CASE("sort handles patterns") {
+    std::mt19937 rand(1234);
+    const size_t lengths[] = {0, 1, 2, 3, 10, 23, 24, 25, 100, 129, 1000, 10000};
+    for (size_t length : lengths) {
+        for (int pattern = 0; pattern < 7; ++pattern) {
+            uint64_t* data = (uint64_t*)malloc(sizeof(uint64_t) * (length + 1));
+            CZ_DEFER(free(data));
+            uint64_t* expected = (uint64_t*)malloc(sizeof(uint64_t) * (length + 1));
+            CZ_DEFER(free(expected));
+
+            fill_pattern(data, length, pattern, rand);
+            memcpy(expected, data, sizeof(uint64_t) * length);
+            std::sort(expected, expected + length);
+
+            cz::sort(cz::Slice<uint64_t>{data, length});
+            INFO("length: " << length << ", pattern: " << pattern);
+            CHECK(memcmp(data, expected, sizeof(uint64_t) * length) == 0);
+        }
+    }
+}
+
+TEST_CASE("generic_parallel_sort handles patterns") {
+    std::mt19937 rand(1234);
+    const size_t lengths[] = {0, 1, 100, sort_impl::parallel_sort_threshold + 1, 200000};
+    const size_t thread_counts[] = {0, 1, 2, 3, 8};
+    for (size_t length : lengths) {
+        for (size_t num_threads : thread_counts) {
+            for (int pattern = 0; pattern < 7; ++pattern) {
+                uint64_t* data = (uint64_t*)malloc(sizeof(uint64_t) * (length + 1));
+                CZ_DEFER(free(data));
+                uint64_t* expected = (uint64_t*)malloc(sizeof(uint64_t) * (length + 1));
+                CZ_DEFER(free(expected));
+
+                fill_pattern(data, length, pattern, rand);
+                memcpy(expected, data, sizeof(uint64_t) * length);
+                std::sort(expected, expected + length);
+
+                generic_parallel_sort(data, data + length, generic_is_less_ptr<uint64_t>,
+                                      generic_swap_ptr<uint64_t>, num_threads);
+                INFO("length: " << length << ", threads: " << num_threads
+                                << ", pattern: " << pattern);
+                CHECK(memcmp(data, expected, sizeof(uint64_t) * length) == 0);
+            }
+        }
+    }
+}
+
+TEST_CASE("generic_parallel_sort doesn't start threads for small sides") {
+    std::mt19937 rand(1234);
+    // Every partition has a side smaller than the threshold.
+    size_t length = 2 * sort_impl::parallel_sort_threshold - 1;
+    uint64_t* data = (uint64_t*)malloc(sizeof(uint64_t) * length);
+    CZ_DEFER(free(data));
+    fill_pattern(data, length, 0, rand);
+
+    std::thread::id main_thread = std::this_thread::get_id();
+    std::atomic<bool> other_thread(false);
+    generic_parallel_sort(
+        data, data + length,
+        [&](uint64_t* left, uint64_t* right) {
+            if (std::this_thread::get_id() != main_thread) {
+                other_thread.store(true, std::memory_order_relaxed);
+            }
+            return *left < *right;
+        },
+        generic_swap_ptr<uint64_t>, 8);
+    CHECK(is_sorted(cz::Slice<uint64_t>{data, length}));
+    CHECK_FALSE(other_thread.load());
+}
+
+TEST_CASE("generic_heap_sort") {
+    std::mt19937 rand(1234);
+    uint64_t data[500];
+    for (size_t i = 0; i < 500; ++i) {
+        data[i] = rand() % 100;
+    }
+    generic_heap_sort(data, data + 500, generic_is_less_ptr<uint64_t>,
+                      generic_swap_ptr<uint64_t>);
+    CHECK(is_sorted(cz::Slice<uint64_t>{data, 500}));
+}
+
+TEST_CASE("sort makes O(n log n) comparisons on few unique values") {
+    const size_t length = 100000;
+    uint64_t* data = (uint64_t*)malloc(sizeof(uint64_t) * length);
+    CZ_DEFER(free(data));
+    for (size_t i = 0; i < length; ++i) {
+        data[i] = i % 2;
+    }
+
+    // Lomuto partitioning would take about n^2 / 4 comparisons here.
+    size_t comparisons = 0;
+    generic_sort(data, data + length,
+                 [&](uint64_t* left, uint64_t* right) {
+                     ++comparisons;
+                     return *left < *right;
+                 },
+                 generic_swap_ptr<uint64_t>);
+    CHECK(is_sorted(cz::Slice<uint64_t>{data, length}));
+    CHECK(comparisons < 20 * length);
+}
+
+/// An element with a key that has many duplicates and its original index.
+struct Stable_Elem {
+    uint32_t key;
+    uint32_t index;
+};
+
+static bool stable_elem_is_less(Stable_Elem* left, Stable_Elem* right) {
+    return left->key < right->key;
+}
+
+static void fill_stable_pattern(Stable_Elem* data,
+                                size_t length,
+                                int pattern,
+                                std::mt19937& rand) {
+    uint64_t* keys = (uint64_t*)malloc(sizeof(uint64_t) * (length + 1));
+    CZ_DEFER(free(keys));
+    fill_pattern(keys, length, pattern, rand);
+    for (size_t i = 0; i < length; ++i) {
+        // Use few distinct keys so stability is tested.
+        data[i] = {(uint32_t)(keys[i] % 1000), (uint32_t)i};
+    }
+}
+
+static void check_stable(Stable_Elem* data, size_t length) {
+    for (size_t i = 1; i < length; ++i) {
+        REQUIRE(data[i - 1].key <= data[i].key);
+        if (data[i - 1].key == data[i].key) {
+            REQUIRE(data[i - 1].index < data[i].index);
+        }
+    }
+}
+
+TEST_CASE("stable_sort handles patterns") {
+    std::mt19937 rand(1234);
+    const size_t lengths[] = {0, 1, 2, 3, 10, 31, 32, 33, 64, 65, 100, 1000, 10000, 100000};
+    for (size_t length : lengths) {
+        for (int pattern = 0; pattern < 7; ++pattern) {
+            Stable_Elem* data = (Stable_Elem*)malloc(sizeof(Stable_Elem) * (length + 1));
+            CZ_DEFER(free(data));
+
+            INFO("length: " << length << ", pattern: " << pattern);
+
+            fill_stable_pattern(data, length, pattern, rand);
+            stable_sort(cz::Slice<Stable_Elem>{data, length}, stable_elem_is_less);
+            check_stable(data, length);
+
+            fill_stable_pattern(data, length, pattern, rand);
+            stable_sort(heap_allocator(), cz::Slice<Stable_Elem>{data, length},
+                        stable_elem_is_less);
+            check_stable(data, length);
+        }
+    }
+}
+
+TEST_CASE("stable_sort descending runs") {
+    // Strictly descending runs are reversed but runs with duplicates must not be.
+    Stable_Elem data[200];
+    for (size_t i = 0; i < 200; ++i) {
+        data[i] = {(uint32_t)(200 - i) / 2, (uint32_t)i};
+    }
+    stable_sort(cz::Slice<Stable_Elem>{data, 200}, stable_elem_is_less);
+    check_stable(data, 200);
+
+    for (size_t i = 0; i < 200; ++i) {
+        data[i] = {(uint32_t)(200 - i) / 2, (uint32_t)i};
+    }
+    stable_sort(heap_allocator(), cz::Slice<Stable_Elem>{data, 200}, stable_elem_is_less);
+    check_stable(data, 200);
+}
+
+TEST_CASE("partial_sort") {
+    std::mt19937 rand(1234);
+    const size_t length = 10000;
+    uint64_t* data = (uint64_t*)malloc(sizeof(uint64_t) * (length + 1));
+    CZ_DEFER(free(data));
+    uint64_t* expected = (uint64_t*)malloc(sizeof(uint64_t) * (length + 1));
+    CZ_DEFER(free(expected));
+
+    const size_t counts[] = {0, 1, 2, 100, length - 1, length};
+    for (size_t count : counts) {
+        for (int pattern = 0; pattern < 7; ++pattern) {
+            fill_pattern(data, length, pattern, rand);
+            memcpy(expected, data, sizeof(uint64_t) * length);
+            std::sort(expected, expected + length);
+
+            partial_sort(cz::Slice<uint64_t>{data, length}, count);
+
+            INFO("count: " << count << ", pattern: " << pattern);
+            CHECK(memcmp(data, expected, sizeof(uint64_t) * count) == 0);
+            // The rest are the other elements.
+            std::sort(data + count, data + length);
+            CHECK(memcmp(data, expected, sizeof(uint64_t) * length) == 0);
+        }
+    }
+}
+
+TEST_CASE("nth_element") {
+    std::mt19937 rand(1234);
+    const size_t lengths[] = {1, 2, 10, 100, 1000, 100000};
+    for (size_t length : lengths) {
+        uint64_t* data = (uint64_t*)malloc(sizeof(uint64_t) * (length + 1));
+        CZ_DEFER(free(data));
+        uint64_t* expected = (uint64_t*)malloc(sizeof(uint64_t) * (length + 1));
+        CZ_DEFER(free(expected));
+
+        const size_t nths[] = {0, length / 3, length / 2, length - 1};
+        for (size_t nth : nths) {
+            for (int pattern = 0; pattern < 7; ++pattern) {
+                fill_pattern(data, length, pattern, rand);
+                memcpy(expected, data, sizeof(uint64_t) * length);
+                std::sort(expected, expected + length);
+
+                nth_element(cz::Slice<uint64_t>{data, length}, nth);
+
+                INFO("length: " << length << ", nth: " << nth << ", pattern: " << pattern);
+                REQUIRE(data[nth] == expected[nth]);
+                for (size_t i = 0; i < nth; ++i) {
+                    REQUIRE(data[i] <= data[nth]);
+                }
+                for (size_t i = nth + 1; i < length; ++i) {
+                    REQUIRE(data[i] >= data[nth]);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,94 @@
+#include <czt/test_base.hpp>
+
+#include <stdint.h>
+#include <algorithm>
+#include <cz/defer.hpp>
+#include <cz/sorted_set.hpp>
+#include <random>
+
+using namespace cz;
+
+/// Make a random set of `length` elements out of `[0, range)`.
+template <class T>
+static size_t make_set(T* data, size_t length, uint64_t range, std::mt19937_64& rand) {
+    for (size_t i = 0; i < length; ++i) {
+        data[i] = (T)(rand() % range);
+    }
+    std::sort(data, data + length);
+    return std::unique(data, data + length) - data;
+}
+
+/// Forces the generic versions to be used for integers.
+template <class T>
+static bool is_less_generic(T* left, T* right) {
+    return *left < *right;
+}
+
+template <class T>
+static void test_sorted_set(std::mt19937_64& rand) {
+    const size_t lengths[] = {0, 1, 3, 4, 5, 8, 9, 33, 100, 1000, 5000};
+    const uint64_t ranges[] = {10, 100, 10000, UINT64_MAX};
+    for (size_t a_length : lengths) {
+        for (size_t b_length : lengths) {
+            for (uint64_t range : ranges) {
+                T* a = (T*)malloc(sizeof(T) * (a_length + 1));
+                CZ_DEFER(free(a));
+                T* b = (T*)malloc(sizeof(T) * (b_length + 1));
+                CZ_DEFER(free(b));
+                T* out = (T*)malloc(sizeof(T) * (a_length + b_length + 1));
+                CZ_DEFER(free(out));
+                T* expected = (T*)malloc(sizeof(T) * (a_length + b_length + 1));
+                CZ_DEFER(free(expected));
+
+                size_t a_len = make_set(a, a_length, range, rand);
+                size_t b_len = make_set(b, b_length, range, rand);
+                cz::Slice<T> a_slice = {a, a_len};
+                cz::Slice<T> b_slice = {b, b_len};
+
+                INFO("a: " << a_len << ", b: " << b_len << ", range: " << range);
+
+                size_t expected_len =
+                    std::set_union(a, a + a_len, b, b + b_len, expected) - expected;
+                cz::Slice<T> result = set_union(a_slice, b_slice, out);
+                REQUIRE(result.len == expected_len);
+                REQUIRE(memcmp(out, expected, sizeof(T) * expected_len) == 0);
+                result = set_union(a_slice, b_slice, out, is_less_generic<T>);
+                REQUIRE(result.len == expected_len);
+                REQUIRE(memcmp(out, expected, sizeof(T) * expected_len) == 0);
+
+                expected_len =
+                    std::set_intersection(a, a + a_len, b, b + b_len, expected) - expected;
+                result = set_intersection(a_slice, b_slice, out);
+                REQUIRE(result.len == expected_len);
+                REQUIRE(memcmp(out, expected, sizeof(T) * expected_len) == 0);
+                result = set_intersection(a_slice, b_slice, out, is_less_generic<T>);
+                REQUIRE(result.len == expected_len);
+                REQUIRE(memcmp(out, expected, sizeof(T) * expected_len) == 0);
+
+                expected_len =
+                    std::set_difference(a, a + a_len, b, b + b_len, expected) - expected;
+                result = set_difference(a_slice, b_slice, out);
+                REQUIRE(result.len == expected_len);
+                REQUIRE(memcmp(out, expected, sizeof(T) * expected_len) == 0);
+                result = set_difference(a_slice, b_slice, out, is_less_generic<T>);
+                REQUIRE(result.len == expected_len);
+                REQUIRE(memcmp(out, expected, sizeof(T) * expected_len) == 0);
+            }
+        }
+    }
+}
+
+TEST_CASE("sorted set operations uint32_t") {
+    std::mt19937_64 rand(1234);
+    test_sorted_set<uint32_t>(rand);
+}
+
+TEST_CASE("sorted set operations uint64_t") {
+    std::mt19937_64 rand(1234);
+    test_sorted_set<uint64_t>(rand);
+}
+
+TEST_CASE("sorted set operations int") {
+    std::mt19937_64 rand(1234);
+    test_sorted_set<int>(rand);
+}
@@ -0,0 +1,96 @@
+#include <czt/test_base.hpp>
+
+#include <stdio.h>
+#include <cz/defer.hpp>
+#include <cz/heap.hpp>
+#include <cz/str_map_removable.hpp>
+#include <random>
+
+using namespace cz;
+
+TEST_CASE("Str_Map_Removable remove") {
+    Str_Map_Removable<int> map = {};
+    CZ_DEFER(map.drop(heap_allocator()));
+
+    map.reserve(heap_allocator(), 3);
+    map.insert_hash("a", 1);
+    map.insert_hash("b", 2);
+    map.insert_hash("c", 3);
+
+    CHECK(map.remove_hash("b"));
+    CHECK_FALSE(map.remove_hash("b"));
+    CHECK(map.count == 2);
+    CHECK(map.get_hash("b") == nullptr);
+    REQUIRE(map.get_hash("a"));
+    CHECK(*map.get_hash("a") == 1);
+    REQUIRE(map.get_hash("c"));
+    CHECK(*map.get_hash("c") == 3);
+}
+
+namespace {
+/// Forces long chains that wrap around the end of the table.
+struct Mod_Hasher {
+    Hash operator()(Str str) const { return 6 + (str[0] - 'a') % 3; }
+};
+}
+
+TEST_CASE("Str_Map_Removable remove shifts back wrapped chains") {
+    Str_Map_Removable<int, Mod_Hasher> map = {};
+    CZ_DEFER(map.drop(heap_allocator()));
+
+    map.reserve(heap_allocator(), 5);
+    REQUIRE(map.cap == 8);
+    const char* keys[] = {"a", "b", "c", "d", "e"};
+    for (int i = 0; i < 5; ++i) {
+        map.insert_hash(keys[i], i);
+    }
+
+    CHECK(map.remove_hash("a"));
+    for (int i = 1; i < 5; ++i) {
+        REQUIRE(map.get_hash(keys[i]));
+        CHECK(*map.get_hash(keys[i]) == i);
+    }
+
+    CHECK(map.remove_hash("c"));
+    CHECK(map.remove_hash("d"));
+    REQUIRE(map.get_hash("b"));
+    REQUIRE(map.get_hash("e"));
+    CHECK(map.count == 2);
+}
+
+TEST_CASE("Str_Map_Removable churn matches a reference") {
+    const size_t key_space = 300;
+    char buffer[key_space * 8];
+    Str keys[key_space];
+    for (size_t i = 0; i < key_space; ++i) {
+        int len = snprintf(buffer + i * 8, 8, "%zu", i);
+        keys[i] = {buffer + i * 8, (size_t)len};
+    }
+
+    Str_Map_Removable<size_t> map = {};
+    CZ_DEFER(map.drop(heap_allocator()));
+    bool present[key_space] = {};
+
+    std::mt19937 rand(42);
+    for (size_t iteration = 0; iteration < 20000; ++iteration) {
+        size_t key = rand() % key_space;
+        if (present[key]) {
+            REQUIRE(map.get_hash(keys[key]));
+            CHECK(*map.get_hash(keys[key]) == key);
+            CHECK(map.remove_hash(keys[key]));
+            present[key] = false;
+        } else {
+            CHECK(map.get_hash(keys[key]) == nullptr);
+            map.reserve(heap_allocator(), 1);
+            map.insert_hash(keys[key], key);
+            present[key] = true;
+        }
+    }
+
+    size_t count = 0;
+    for (size_t key = 0; key < key_space; ++key) {
+        count += present[key];
+        CHECK((map.get_hash(keys[key]) != nullptr) == present[key]);
+    }
+    CHECK(map.count == count);
+}
@@ -0,0 +1,82 @@
+#include <czt/test_base.hpp>
+
+#include <stdio.h>
+#include <cz/defer.hpp>
+#include <cz/heap.hpp>
+#include <cz/str_map.hpp>
+#include <cz/vector.hpp>
+
+using namespace cz;
+
+TEST_CASE("Str_Map growth keeps all entries") {
+    char buffer[1000 * 8];
+    Vector<Str> keys = {};
+    CZ_DEFER(keys.drop(heap_allocator()));
+    keys.reserve_exact(heap_allocator(), 1000);
+    for (size_t i = 0; i < 1000; ++i) {
+        int len = snprintf(buffer + i * 8, 8, "%zu", i);
+        keys.push({buffer + i * 8, (size_t)len});
+    }
+
+    Str_Map<size_t> map = {};
+    CZ_DEFER(map.drop(heap_allocator()));
+    for (size_t i = 0; i < keys.len; ++i) {
+        map.reserve(heap_allocator(), 1);
+        map.insert_hash(keys[i], i);
+    }
+
+    CHECK(map.count == 1000);
+    for (size_t i = 0; i < keys.len; ++i) {
+        size_t* value = map.get_hash(keys[i]);
+        REQUIRE(value);
+        CHECK(*value == i);
+    }
+    CHECK(map.get_hash("1000") == nullptr);
+    CHECK(map.get_hash("") == nullptr);
+}
+
+namespace {
+struct Counting_Hasher {
+    static size_t calls;
+    Hash operator()(Str str) const {
+        ++calls;
+        return Str_Hasher()(str);
+    }
+};
+size_t Counting_Hasher::calls;
+}
+
+TEST_CASE("Str_Map growth doesn't rehash keys") {
+    Str_Map<int, Counting_Hasher> map = {};
+    CZ_DEFER(map.drop(heap_allocator()));
+
+    Counting_Hasher::calls = 0;
+    map.reserve(heap_allocator(), 2);
+    map.insert_hash("a", 1);
+    map.insert_hash("b", 2);
+    CHECK(Counting_Hasher::calls == 2);
+
+    map.reserve(heap_allocator(), 100);
+    CHECK(Counting_Hasher::calls == 2);
+    REQUIRE(map.get_hash("a"));
+    CHECK(*map.get_hash("a") == 1);
+}
+
+TEST_CASE("Str_Map keys with equal metadata tags") {
+    // Only the full hash is different so the metadata tags match.
+    struct Low_Bits_Hasher {
+        Hash operator()(Str str) const { return str.len; }
+    };
+    Str_Map<int, Low_Bits_Hasher> map = {};
+    CZ_DEFER(map.drop(heap_allocator()));
+
+    map.reserve(heap_allocator(), 4);
+    map.insert_hash("a", 1);
+    map.insert_hash("bb", 2);
+    map.insert_hash("c", 3);
+    REQUIRE(map.get_hash("c"));
+    CHECK(*map.get_hash("c") == 3);
+    REQUIRE(map.get_hash("bb"));
+    CHECK(*map.get_hash("bb") == 2);
+    CHECK(map.get_hash("d") == nullptr);
+}
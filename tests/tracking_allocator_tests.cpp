@@ -0,0 +1,175 @@
+#include <czt/test_base.hpp>
+
+#include <string.h>
+#include <cz/defer.hpp>
+#include <cz/format.hpp>
+#include <cz/heap_string.hpp>
+#include <cz/slab_allocator.hpp>
+#include <cz/tracking_allocator.hpp>
+#include <cz/vector.hpp>
+#include <thread>
+
+using namespace cz;
+
+TEST_CASE("Tracking_Allocator counts live and peak bytes") {
+    Tracking_Allocator tracker;
+    tracker.init(heap_allocator());
+    CZ_DEFER(tracker.drop());
+    Allocator allocator = tracker.allocator();
+
+    void* a = allocator.alloc({100, 1});
+    void* b = allocator.alloc({50, 1});
+    allocator.dealloc({a, 100});
+    b = allocator.realloc({b, 50}, {70, 1});
+
+    Allocation_Stats stats = tracker.stats();
+    CHECK(stats.live_bytes == 70);
+    CHECK(stats.peak_bytes == 150);
+    CHECK(stats.live_allocations == 1);
+    CHECK(stats.total_allocations == 2);
+    CHECK(stats.total_reallocations == 1);
+    CHECK(stats.total_deallocations == 1);
+    // 70 and 100 are both in the (64, 128] bucket.
+    CHECK(stats.histogram[Allocation_Stats::bucket(100)] == 2);
+    CHECK(stats.histogram[Allocation_Stats::bucket(50)] == 1);
+
+    allocator.dealloc({b, 70});
+    CHECK(tracker.stats().live_bytes == 0);
+
+    tracker.reset_peak();
+    CHECK(tracker.stats().peak_bytes == 0);
+}
+
+TEST_CASE("Allocation_Stats::bucket") {
+    CHECK(Allocation_Stats::bucket(0) == 0);
+    CHECK(Allocation_Stats::bucket(1) == 0);
+    CHECK(Allocation_Stats::bucket(2) == 1);
+    CHECK(Allocation_Stats::bucket(3) == 2);
+    CHECK(Allocation_Stats::bucket(4) == 2);
+    CHECK(Allocation_Stats::bucket(5) == 3);
+    CHECK(Allocation_Stats::bucket((size_t)1 << 40) == Allocation_Stats::num_buckets - 1);
+}
+
+TEST_CASE("Tracking_Allocator tracks call sites") {
+    Tracking_Allocator tracker;
+    tracker.init(heap_allocator(), /*track_sites=*/true);
+    CZ_DEFER(tracker.drop());
+
+    SourceLocation location1 = {"file1.cpp", 10};
+    SourceLocation location2 = {"file2.cpp", 20};
+
+    Vector<int> vector = {};
+    for (int i = 0; i < 1000; ++i) {
+        vector.reserve(tracker.allocator(location1), 1);
+        vector.push(i);
+    }
+
+    void* ptrs[100];
+    for (int i = 0; i < 100; ++i) {
+        ptrs[i] = tracker.allocator(location2).alloc({8, 1});
+    }
+    for (int i = 0; i < 100; i += 2) {
+        tracker.allocator().dealloc({ptrs[i], 8});
+    }
+
+    Heap_String report = {};
+    CZ_DEFER(report.drop());
+    tracker.append_live_sites(heap_allocator(), &report);
+    CHECK(report ==
+          "file1.cpp:10: 4096 bytes in 1 allocations\n"
+          "file2.cpp:20: 400 bytes in 50 allocations\n");
+
+    vector.drop(tracker.allocator());
+    for (int i = 1; i < 100; i += 2) {
+        tracker.allocator().dealloc({ptrs[i], 8});
+    }
+
+    report.len = 0;
+    tracker.append_live_sites(heap_allocator(), &report);
+    CHECK(report == "");
+}
+
+TEST_CASE("Tracking_Allocator realloc is thread safe if the backer is") {
+    Slab_Allocator slab;
+    slab.init();
+    CZ_DEFER(slab.drop());
+
+    Tracking_Allocator tracker;
+    tracker.init(slab.allocator(), /*track_sites=*/true);
+    CZ_DEFER(tracker.drop());
+
+    // Each thread repeatedly reallocates its buffers between size classes and flushes its
+    // cache so freed addresses are quickly handed out to the other threads.
+    const size_t num_threads = 4;
+    const size_t count = 64;
+    std::thread threads[num_threads];
+    for (size_t t = 0; t < num_threads; ++t) {
+        threads[t] = std::thread([&]() {
+            Allocator allocator = tracker.allocator({"thread.cpp", 1});
+            void* buffers[count] = {};
+            size_t sizes[count] = {};
+            for (size_t round = 0; round < 200; ++round) {
+                for (size_t i = 0; i < count; ++i) {
+                    size_t new_size = 16 << ((round + i) % 4);
+                    buffers[i] = allocator.realloc({buffers[i], sizes[i]}, {new_size, 8});
+                    sizes[i] = new_size;
+                }
+                slab.flush_thread_cache();
+            }
+            for (size_t i = 0; i < count; ++i) {
+                allocator.dealloc({buffers[i], sizes[i]});
+            }
+            slab.flush_thread_cache();
+        });
+    }
+    for (size_t t = 0; t < num_threads; ++t) {
+        threads[t].join();
+    }
+
+    Allocation_Stats stats = tracker.stats();
+    CHECK(stats.live_bytes == 0);
+    CHECK(stats.live_allocations == 0);
+    CHECK(stats.total_allocations == num_threads * count);
+    CHECK(tracker._records_count == 0);
+
+    Heap_String report = {};
+    CZ_DEFER(report.drop());
+    tracker.append_live_sites(heap_allocator(), &report);
+    CHECK(report == "");
+}
+
+TEST_CASE("Tracking_Allocator failing to shrink in place keeps the contents") {
+    Tracking_Allocator tracker;
+    tracker.init(heap_allocator());
+    CZ_DEFER(tracker.drop());
+    Allocator allocator = tracker.allocator();
+
+    // The heap can't resize in place so this always fails.
+    char* buffer = allocator.alloc<char>(8);
+    CZ_DEFER(allocator.dealloc(buffer, 8));
+    memcpy(buffer, "abcdefgh", 8);
+    CHECK_FALSE(allocator.try_expand_in_place(buffer, 8, 4));
+    CHECK(Str{buffer, 8} == "abcdefgh");
+    CHECK(tracker.stats().total_reallocations == 0);
+}
+
+TEST_CASE("Tracking_Allocator stats report") {
+    Tracking_Allocator tracker;
+    tracker.init(heap_allocator());
+    CZ_DEFER(tracker.drop());
+
+    void* mem = tracker.allocator().alloc({3, 1});
+    CZ_DEFER(tracker.allocator().dealloc({mem, 3}));
+
+    Heap_String report = format(tracker.stats());
+    CZ_DEFER(report.drop());
+    CHECK(report ==
+          "Live bytes: 3\n"
+          "Peak bytes: 3\n"
+          "Live allocations: 1\n"
+          "Total allocations: 1\n"
+          "Total reallocations: 0\n"
+          "Total deallocations: 0\n"
+          "Size histogram:\n"
+          "  <= 4: 1\n");
+}
@@ -1,5 +1,6 @@
 #include <czt/test_base.hpp>
 
+#include <cz/arena.hpp>
 #include <cz/defer.hpp>
 #include <cz/heap.hpp>
 #include <cz/vector.hpp>
@@ -110,3 +111,49 @@ TEST_CASE("Vector append") {
     CHECK(vector[1] == 2);
     CHECK(vector[2] == 3);
 }
+
+TEST_CASE("Vector reserve with growth policies") {
+    CHECK(grow_power_of_two(0, 1, 4) == 8);
+    CHECK(grow_power_of_two(8, 9, 4) == 16);
+    CHECK(grow_one_and_a_half(0, 1, 4) == 8);
+    CHECK(grow_one_and_a_half(16, 17, 4) == 24);
+    CHECK(grow_one_and_a_half(16, 100, 4) == 100);
+
+    // Small buffers grow by powers of two.
+    CHECK(grow_page_granular(8, 9, 4) == 16);
+    // Huge buffers grow by 1.5x rounded up to a page.
+    size_t cap = growth_page_threshold;
+    size_t new_cap = grow_page_granular(cap, cap + 1, 4);
+    CHECK(new_cap >= cap + cap / 2);
+    CHECK(new_cap * 4 % growth_page_size == 0);
+    CHECK(new_cap < cap * 2);
+
+    Vector<int> vector = {};
+    CZ_DEFER(vector.drop(heap_allocator()));
+    vector.reserve(heap_allocator(), 16, grow_one_and_a_half);
+    CHECK(vector.cap == 16);
+    vector.len = 16;
+    vector.reserve(heap_allocator(), 1, grow_one_and_a_half);
+    CHECK(vector.cap == 24);
+}
+
+static void* no_realloc(void*, MemSlice, AllocInfo) {
+    CZ_PANIC("Vector should have expanded in place");
+}
+
+TEST_CASE("Vector reserve expands in place when the allocator supports it") {
+    alignas(int) char buffer[256];
+    Arena arena;
+    arena.init(buffer, sizeof(buffer));
+
+    Vector<int> vector = {};
+    vector.reserve_exact(arena.allocator(), 2);
+    int* elems = vector.elems;
+
+    Allocator allocator = arena.allocator();
+    allocator.reallocate = no_realloc;
+    vector.reserve_total(allocator, 10);
+    CHECK(vector.elems == elems);
+    CHECK(vector.cap == 16);
+    CHECK(arena.remaining() == sizeof(buffer) - 16 * sizeof(int));
+}
@@ -0,0 +1,106 @@
+#include <czt/test_base.hpp>
+
+#include <string.h>
+#include <cz/defer.hpp>
+#include <cz/sys.hpp>
+#include <cz/vector.hpp>
+#include <cz/virtual_arena.hpp>
+
+using namespace cz;
+
+TEST_CASE("Virtual_Arena commits memory lazily") {
+    Virtual_Arena arena;
+    REQUIRE(arena.init((size_t)1 << 30));
+    CZ_DEFER(arena.drop());
+
+    CHECK(arena.committed() == 0);
+
+    char* mem = arena.allocator().alloc<char>(100);
+    REQUIRE(mem);
+    memset(mem, 'a', 100);
+    CHECK(arena.committed() > 0);
+    CHECK(arena.committed() < ((size_t)1 << 30));
+}
+
+TEST_CASE("Virtual_Arena last allocation grows in place") {
+    Virtual_Arena arena;
+    REQUIRE(arena.init((size_t)1 << 30));
+    CZ_DEFER(arena.drop());
+
+    Vector<size_t> vector = {};
+    vector.reserve(arena.allocator(), 1);
+    size_t* elems = vector.elems;
+
+    for (size_t i = 0; i < 1000000; ++i) {
+        vector.reserve(arena.allocator(), 1);
+        vector.push(i);
+    }
+
+    CHECK(vector.elems == elems);
+    for (size_t i = 0; i < vector.len; ++i) {
+        if (vector[i] != i) {
+            FAIL(i);
+        }
+    }
+}
+
+TEST_CASE("Virtual_Arena multiple allocations") {
+    Virtual_Arena arena;
+    REQUIRE(arena.init((size_t)1 << 30));
+    CZ_DEFER(arena.drop());
+
+    Vector<int> v1 = {};
+    Vector<int> v2 = {};
+    for (int i = 0; i < 10000; ++i) {
+        v1.reserve(arena.allocator(), 1);
+        v1.push(i);
+        v2.reserve(arena.allocator(), 1);
+        v2.push(-i);
+    }
+    for (int i = 0; i < 10000; ++i) {
+        CHECK(v1[i] == i);
+        CHECK(v2[i] == -i);
+    }
+}
+
+TEST_CASE("Virtual_Arena clear decommits") {
+    Virtual_Arena arena;
+    REQUIRE(arena.init((size_t)1 << 30));
+    CZ_DEFER(arena.drop());
+
+    char* mem = arena.allocator().alloc<char>(1 << 20);
+    REQUIRE(mem);
+    memset(mem, 'a', 1 << 20);
+    CHECK(arena.committed() >= (1 << 20));
+
+    arena.clear();
+    CHECK(arena.committed() == 0);
+
+    // Memory is recommitted (and zeroed) on the next allocation.
+    char* mem2 = arena.allocator().alloc<char>(1 << 20);
+    CHECK(mem2 == mem);
+}
+
+TEST_CASE("Virtual_Arena returns nullptr when reservation is exhausted") {
+    Virtual_Arena arena;
+    REQUIRE(arena.init(sys::page_size()));
+    CZ_DEFER(arena.drop());
+
+    CHECK(arena.allocator().alloc({sys::page_size() + 1, 1}) == nullptr);
+    CHECK(arena.allocator().alloc({sys::page_size(), 1}) != nullptr);
+}
+
+TEST_CASE("Virtual_Arena expand_in_place commits more memory") {
+    Virtual_Arena arena;
+    REQUIRE(arena.init((size_t)1 << 30));
+    CZ_DEFER(arena.drop());
+
+    char* mem = arena.allocator().alloc<char>(100);
+    REQUIRE(mem);
+    size_t big = Virtual_Arena::commit_granularity * 4;
+    REQUIRE(arena.allocator().try_expand_in_place({mem, 100}, big));
+    CHECK(arena.committed() >= big);
+    memset(mem, 'a', big);
+
+    REQUIRE_FALSE(arena.allocator().try_expand_in_place({mem, big}, (size_t)2 << 30));
+}